@@ -0,0 +1,2577 @@
+// headless CPU benchmarks for the world pipeline (no window, no GPU)
+#include "constants.h"
+
+#include "chunk_codec.h"
+#include "chunk_cull.h"
+#include "chunk_data.h"
+#include "chunk_draw_list.h"
+#include "chunk_draw_sort.h"
+#include "chunk_grid.h"
+#include "chunk_lod.h"
+#include "chunk_manager.h"
+#include "chunk_mesh.h"
+#include "chunk_mesh_gpu_null.h"
+#include "chunk_occlusion.h"
+#include "region_file.h"
+#include "save.h"
+#include "terrain_generator.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace World;
+
+//--- HELPER ---//
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+} // end of ElapsedMs()
+
+// heap allocations made by the current thread while counting is on
+static thread_local bool g_countAllocations = false;
+static thread_local uint64_t g_allocations = 0;
+
+// every new and delete stays out of line, once gcc inlines malloc() or
+// free() into a new/delete expression it flags the pair as mismatched
+// (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+// the full replaceable set, every form ends in the same malloc/free pair
+BENCH_NOINLINE void* operator new(size_t size)
+{
+	if (g_countAllocations)
+	{
+		++g_allocations;
+	}
+	if (void* p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+} // end of operator new()
+
+BENCH_NOINLINE void* operator new[](size_t size)
+{
+	return ::operator new(size);
+} // end of operator new[]()
+
+BENCH_NOINLINE void operator delete(void* p) noexcept
+{
+	std::free(p);
+} // end of operator delete()
+
+BENCH_NOINLINE void operator delete[](void* p) noexcept
+{
+	std::free(p);
+} // end of operator delete[]()
+
+BENCH_NOINLINE void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+} // end of operator delete()
+
+BENCH_NOINLINE void operator delete[](void* p, size_t) noexcept
+{
+	std::free(p);
+} // end of operator delete[]()
+
+struct BenchMetric
+{
+	std::string name;
+	double value;
+	std::string unit;
+};
+
+struct BenchOptions
+{
+	// chunks per side of the square region measured
+	int side = 8;
+	// view radii for the ChunkManager (world) benchmarks
+	std::vector<int> radii{ 6, 12 };
+	std::string worldName = "bench_world";
+	// run a single benchmark by name (empty = all)
+	std::string only;
+	// write every metric to this file as JSON (empty = console only)
+	std::string jsonPath;
+	// set when a correctness check inside a benchmark fails
+	bool failed = false;
+
+	std::vector<BenchMetric> metrics;
+};
+
+static void Record(BenchOptions& opt, const std::string& name, double value, const char* unit)
+{
+	opt.metrics.push_back({ name, value, unit });
+} // end of Record()
+
+static void ReportPerChunk(BenchOptions& opt, const std::string& name, double totalMs, int chunkCount)
+{
+	std::printf("%-32s %10.3f ms/chunk  (%d chunks, %.1f ms total)\n",
+		name.c_str(), totalMs / chunkCount, chunkCount, totalMs);
+	Record(opt, name, totalMs / chunkCount, "ms/chunk");
+} // end of ReportPerChunk()
+
+static void Fail(BenchOptions& opt, const char* what)
+{
+	std::printf("%s\n", what);
+	opt.failed = true;
+} // end of Fail()
+
+static std::vector<int> ParseIntList(const char* text)
+{
+	std::vector<int> values;
+	std::stringstream ss(text);
+	std::string item;
+	while (std::getline(ss, item, ','))
+	{
+		if (!item.empty())
+		{
+			values.push_back(std::atoi(item.c_str()));
+		}
+	} // end while
+	return values;
+} // end of ParseIntList()
+
+static bool WriteJson(const BenchOptions& opt)
+{
+	FILE* f = std::fopen(opt.jsonPath.c_str(), "w");
+	if (!f)
+	{
+		std::printf("failed to open %s\n", opt.jsonPath.c_str());
+		return false;
+	}
+
+	std::fprintf(f, "{\n  \"side\": %d,\n  \"radii\": [", opt.side);
+	for (size_t i = 0; i < opt.radii.size(); ++i)
+	{
+		std::fprintf(f, "%s%d", i ? ", " : "", opt.radii[i]);
+	} // end for
+	std::fprintf(f, "],\n  \"failed\": %s,\n  \"metrics\": [\n", opt.failed ? "true" : "false");
+
+	for (size_t i = 0; i < opt.metrics.size(); ++i)
+	{
+		const BenchMetric& m = opt.metrics[i];
+		std::fprintf(f, "    { \"name\": \"%s\", \"value\": %.6g, \"unit\": \"%s\" }%s\n",
+			m.name.c_str(), m.value, m.unit.c_str(), i + 1 < opt.metrics.size() ? "," : "");
+	} // end for
+
+	std::fprintf(f, "  ]\n}\n");
+	std::fclose(f);
+	return true;
+} // end of WriteJson()
+
+static std::vector<BlockID> DenseBlocks(const ChunkData& chunk)
+{
+	std::vector<BlockID> blocks(CHUNK_VOLUME);
+	chunk.copyBlocks(blocks.data());
+	return blocks;
+} // end of DenseBlocks()
+
+// same access pattern as ChunkMesh::computeRenderedBlockCount()
+template <typename GetBlock>
+static uint32_t CountVisibleBlocks(GetBlock getBlock)
+{
+	auto transparent = [&](int x, int y, int z)
+		{
+			if (x < 0 || x >= CHUNK_SIZE ||
+				y < 0 || y >= CHUNK_SIZE_Y ||
+				z < 0 || z >= CHUNK_SIZE)
+			{
+				return true;
+			}
+			BlockID id = getBlock(x, y, z);
+			return id == BlockID::Air || id == BlockID::Water || id == BlockID::Tree_Leaf;
+		};
+
+	uint32_t count = 0;
+	for (int x = 0; x < CHUNK_SIZE; ++x)
+		for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+			for (int z = 0; z < CHUNK_SIZE; ++z)
+			{
+				BlockID id = getBlock(x, y, z);
+				if (id == BlockID::Air || id == BlockID::Water) continue;
+
+				if (transparent(x + 1, y, z) || transparent(x - 1, y, z) ||
+					transparent(x, y + 1, z) || transparent(x, y - 1, z) ||
+					transparent(x, y, z + 1) || transparent(x, y, z - 1))
+				{
+					++count;
+				}
+			} // end for
+
+	return count;
+} // end of CountVisibleBlocks()
+
+// load time per chunk: fresh world (generate) vs. saved world (load only)
+static void BenchChunkLoad(BenchOptions& opt)
+{
+	Save save;
+	const int count = opt.side * opt.side;
+
+	std::filesystem::remove_all(std::filesystem::path(SAVE_PATH) / opt.worldName);
+
+	// fresh world, every chunk misses the save and generates
+	{
+		auto start = Clock::now();
+		for (int cz = 0; cz < opt.side; ++cz)
+		{
+			for (int cx = 0; cx < opt.side; ++cx)
+			{
+				ChunkData chunk(cx, cz, false);
+				if (!save.loadChunkFromFile(chunk, cx, cz, opt.worldName))
+				{
+					chunk.generate();
+				}
+				save.saveChunkToFile(chunk, opt.worldName);
+			} // end for
+		} // end for
+		ReportPerChunk(opt, "chunk_load.fresh (gen + save)", ElapsedMs(start), count);
+	}
+
+	// saved world, old path (always generate, then overwrite from save)
+	{
+		auto start = Clock::now();
+		for (int cz = 0; cz < opt.side; ++cz)
+		{
+			for (int cx = 0; cx < opt.side; ++cx)
+			{
+				ChunkData chunk(cx, cz);
+				save.loadChunkFromFile(chunk, cx, cz, opt.worldName);
+			} // end for
+		} // end for
+		ReportPerChunk(opt, "chunk_load.saved_eager_gen", ElapsedMs(start), count);
+	}
+
+	// saved world, deferred generation
+	{
+		auto start = Clock::now();
+		for (int cz = 0; cz < opt.side; ++cz)
+		{
+			for (int cx = 0; cx < opt.side; ++cx)
+			{
+				ChunkData chunk(cx, cz, false);
+				if (!save.loadChunkFromFile(chunk, cx, cz, opt.worldName))
+				{
+					chunk.generate();
+				}
+			} // end for
+		} // end for
+		ReportPerChunk(opt, "chunk_load.saved_deferred", ElapsedMs(start), count);
+	}
+
+	std::filesystem::remove_all(std::filesystem::path(SAVE_PATH) / opt.worldName);
+} // end of BenchChunkLoad()
+
+// region save/load throughput and compression ratio
+static void BenchSaveLoad(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+	const std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / opt.worldName;
+
+	std::filesystem::remove_all(worldDir);
+
+	std::vector<std::unique_ptr<ChunkData>> chunks;
+	std::vector<const ChunkData*> chunkPtrs;
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			chunks.push_back(std::make_unique<ChunkData>(cx, cz));
+			chunkPtrs.push_back(chunks.back().get());
+		} // end for
+	} // end for
+
+	// codec alone
+	{
+		size_t rawBytes = 0;
+		size_t packedBytes = 0;
+		std::vector<uint8_t> packed;
+		std::vector<BlockID> decoded(CHUNK_VOLUME);
+
+		auto start = Clock::now();
+		for (const ChunkData* chunk : chunkPtrs)
+		{
+			ChunkCodec::encode(DenseBlocks(*chunk).data(), CHUNK_VOLUME, packed);
+			rawBytes += CHUNK_VOLUME * sizeof(BlockID);
+			packedBytes += packed.size();
+		} // end for
+		ReportPerChunk(opt, "codec.encode", ElapsedMs(start), count);
+
+		const std::vector<BlockID> first = DenseBlocks(*chunkPtrs[0]);
+		ChunkCodec::encode(first.data(), CHUNK_VOLUME, packed);
+		start = Clock::now();
+		for (int i = 0; i < count; ++i)
+		{
+			ChunkCodec::decode(packed.data(), packed.size(), decoded.data(), decoded.size());
+		} // end for
+		ReportPerChunk(opt, "codec.decode", ElapsedMs(start), count);
+
+		if (decoded != first)
+		{
+			Fail(opt, "codec round trip MISMATCH");
+		}
+
+		std::printf("%-32s %10.1f x  (%zu -> %zu bytes)\n",
+			"codec.ratio", static_cast<double>(rawBytes) / packedBytes, rawBytes, packedBytes);
+		Record(opt, "codec.ratio", static_cast<double>(rawBytes) / packedBytes, "x");
+	}
+
+	// batched save
+	{
+		Save save;
+		auto start = Clock::now();
+		save.saveChunksToFile(chunkPtrs, opt.worldName);
+		ReportPerChunk(opt, "save.batched", ElapsedMs(start), count);
+	}
+
+	// single chunk saves, one region rewrite each
+	{
+		Save save;
+		auto start = Clock::now();
+		for (const ChunkData* chunk : chunkPtrs)
+		{
+			save.saveChunkToFile(*chunk, opt.worldName);
+		} // end for
+		ReportPerChunk(opt, "save.per_chunk", ElapsedMs(start), count);
+	}
+
+	// background save, caller only pays for the snapshot copy
+	{
+		Save save;
+		auto start = Clock::now();
+		for (const ChunkData* chunk : chunkPtrs)
+		{
+			save.queueChunkSave(*chunk, opt.worldName);
+		} // end for
+		ReportPerChunk(opt, "save.queued (caller)", ElapsedMs(start), count);
+
+		start = Clock::now();
+		save.flush();
+		ReportPerChunk(opt, "save.queued_flush", ElapsedMs(start), count);
+	}
+
+	size_t diskBytes = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(worldDir))
+	{
+		diskBytes += static_cast<size_t>(entry.file_size());
+	} // end for
+	std::printf("%-32s %10.1f KB   (%.2f KB/chunk)\n",
+		"save.disk_size", diskBytes / 1024.0, diskBytes / 1024.0 / count);
+	Record(opt, "save.disk_size", diskBytes / 1024.0 / count, "KB/chunk");
+
+	std::vector<std::unique_ptr<ChunkData>> loaded;
+	std::vector<ChunkData*> loadedPtrs;
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			loaded.push_back(std::make_unique<ChunkData>(cx, cz, false));
+			loadedPtrs.push_back(loaded.back().get());
+		} // end for
+	} // end for
+
+	// cold cache, regions read from disk
+	{
+		Save save;
+		auto start = Clock::now();
+		for (ChunkData* chunk : loadedPtrs)
+		{
+			save.loadChunkFromFile(*chunk, chunk->m_chunkX, chunk->m_chunkZ, opt.worldName);
+		} // end for
+		ReportPerChunk(opt, "load.cold", ElapsedMs(start), count);
+
+		// warm cache, regions already in memory
+		start = Clock::now();
+		for (ChunkData* chunk : loadedPtrs)
+		{
+			save.loadChunkFromFile(*chunk, chunk->m_chunkX, chunk->m_chunkZ, opt.worldName);
+		} // end for
+		ReportPerChunk(opt, "load.warm", ElapsedMs(start), count);
+	}
+
+	{
+		Save save;
+		auto start = Clock::now();
+		std::vector<bool> ok = save.loadChunksFromFile(loadedPtrs, opt.worldName);
+		ReportPerChunk(opt, "load.batched_cold", ElapsedMs(start), count);
+
+		if (std::count(ok.begin(), ok.end(), true) != count)
+		{
+			Fail(opt, "batched load missed chunks");
+		}
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (DenseBlocks(*loaded[i]) != DenseBlocks(*chunks[i]))
+		{
+			Fail(opt, "save/load round trip MISMATCH");
+			break;
+		}
+	} // end for
+
+	// warm loads of the odd chunks while the save thread rewrites the
+	// regions holding the even ones, the worst load is the stall
+	{
+		Save save;
+		save.loadChunksFromFile(loadedPtrs, opt.worldName);
+
+		double worstMs = 0.0;
+		double totalMs = 0.0;
+		int loads = 0;
+		for (int round = 0; round < 20; ++round)
+		{
+			for (int i = 0; i < count; i += 2)
+			{
+				save.queueChunkSave(*chunks[i], opt.worldName);
+			} // end for
+			while (save.queuedChunkCount() > 0)
+			{
+				for (int i = 1; i < count; i += 2)
+				{
+					const auto start = Clock::now();
+					save.loadChunkFromFile(*loaded[i], loaded[i]->m_chunkX, loaded[i]->m_chunkZ, opt.worldName);
+					const double ms = ElapsedMs(start);
+					worstMs = std::max(worstMs, ms);
+					totalMs += ms;
+					++loads;
+				} // end for
+			} // end while
+			save.flush();
+		} // end for
+
+		std::printf("%-32s %10.3f ms  (worst of %d loads, mean %.3f ms)\n", "load.during_save",
+			worstMs, loads, totalMs / std::max(1, loads));
+		Record(opt, "load.during_save_worst", worstMs, "ms");
+	}
+
+	// a truncated region must survive the next save of one of its chunks
+	{
+		const std::filesystem::path regionPath = RegionFile::pathFor(worldDir, RegionFile::regionOf(0, 0));
+		std::filesystem::path corruptPath = regionPath;
+		corruptPath += ".corrupt";
+		const uintmax_t truncated = std::filesystem::file_size(regionPath) / 2;
+		std::filesystem::resize_file(regionPath, truncated);
+
+		Save save;
+		save.saveChunkToFile(*chunks[0], opt.worldName);
+		const bool kept = std::filesystem::exists(corruptPath) && std::filesystem::file_size(corruptPath) == truncated;
+		std::printf("%-32s %10s  (moved aside before the rewrite)\n", "save.corrupt_region_kept", kept ? "yes" : "NO");
+		if (!kept)
+		{
+			Fail(opt, "unreadable region overwritten");
+		}
+	}
+
+	// a failed region write keeps the chunks in memory and retries them
+	{
+		const std::filesystem::path regionPath = RegionFile::pathFor(worldDir,
+			RegionFile::regionOf(chunks[0]->m_chunkX, chunks[0]->m_chunkZ));
+		std::filesystem::path tmpPath = regionPath;
+		tmpPath += ".tmp";
+		std::filesystem::remove(regionPath);
+		std::filesystem::create_directory(tmpPath); // blocks the write
+
+		Save save;
+		const bool failed = !save.saveChunkToFile(*chunks[0], opt.worldName);
+		const bool inMemory = save.loadChunkFromFile(*loaded[0], chunks[0]->m_chunkX, chunks[0]->m_chunkZ, opt.worldName);
+		std::filesystem::remove(tmpPath);
+		const bool retried = save.flush() && std::filesystem::exists(regionPath);
+
+		const bool kept = failed && inMemory && retried;
+		std::printf("%-32s %10s  (reported, kept, written by flush)\n", "save.failed_write_kept", kept ? "yes" : "NO");
+		if (!kept)
+		{
+			Fail(opt, "failed region write lost chunks");
+		}
+	}
+
+	std::filesystem::remove_all(worldDir);
+} // end of BenchSaveLoad()
+
+// resident chunk memory and getBlockID cost of the sectioned palette storage
+static void BenchBlockStorage(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+
+	std::vector<std::unique_ptr<ChunkData>> chunks;
+	std::vector<std::vector<BlockID>> dense;
+	size_t paletteBytes = 0;
+
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			chunks.push_back(std::make_unique<ChunkData>(cx, cz));
+			dense.push_back(DenseBlocks(*chunks.back()));
+			paletteBytes += chunks.back()->memoryUsageBytes();
+		} // end for
+	} // end for
+
+	const double denseBytes = static_cast<double>(CHUNK_VOLUME * sizeof(BlockID));
+	const double avgBytes = static_cast<double>(paletteBytes) / count;
+	const double radiusChunks = (2.0 * MAX_RADIUS + 1) * (2.0 * MAX_RADIUS + 1);
+
+	std::printf("%-32s %10.1f KB/chunk (dense %.1f KB, %.1fx smaller)\n",
+		"storage.resident", avgBytes / 1024.0, denseBytes / 1024.0, denseBytes / avgBytes);
+	std::printf("%-32s %10.1f MB  (dense %.1f MB, radius %d)\n",
+		"storage.at_max_radius", avgBytes * radiusChunks / (1024.0 * 1024.0),
+		denseBytes * radiusChunks / (1024.0 * 1024.0), MAX_RADIUS);
+	Record(opt, "storage.resident", avgBytes / 1024.0, "KB/chunk");
+
+	// mesher style neighbour lookups, dense array baseline vs getBlockID
+	uint32_t denseVisible = 0;
+	auto start = Clock::now();
+	for (const std::vector<BlockID>& blocks : dense)
+	{
+		denseVisible += CountVisibleBlocks([&](int x, int y, int z)
+			{
+				return blocks[x + CHUNK_SIZE * (z + CHUNK_SIZE * y)];
+			});
+	} // end for
+	ReportPerChunk(opt, "get_block.dense_array", ElapsedMs(start), count);
+
+	uint32_t paletteVisible = 0;
+	start = Clock::now();
+	for (const auto& chunk : chunks)
+	{
+		paletteVisible += CountVisibleBlocks([&](int x, int y, int z)
+			{
+				return chunk->getBlockID(x, y, z);
+			});
+	} // end for
+	ReportPerChunk(opt, "get_block.palette", ElapsedMs(start), count);
+
+	// what the mesher pays up front: one dense copy, then plain array reads
+	std::vector<BlockID> scratch(CHUNK_VOLUME);
+	start = Clock::now();
+	for (const auto& chunk : chunks)
+	{
+		chunk->copyBlocks(scratch.data());
+	} // end for
+	ReportPerChunk(opt, "get_block.unpack_to_dense", ElapsedMs(start), count);
+
+	if (denseVisible != paletteVisible)
+	{
+		Fail(opt, "get_block MISMATCH");
+	}
+
+	// edits that widen palettes
+	start = Clock::now();
+	for (auto& chunk : chunks)
+	{
+		for (int i = 0; i < 256; ++i)
+		{
+			chunk->setBlockID(i % CHUNK_SIZE, (i * 7) % CHUNK_SIZE_Y, (i / CHUNK_SIZE) % CHUNK_SIZE, static_cast<BlockID>(i % 8));
+		} // end for
+	} // end for
+	ReportPerChunk(opt, "set_block.256_edits", ElapsedMs(start), count);
+} // end of BenchBlockStorage()
+
+
+// triangles emitted with and without neighbour border culling
+static void BenchBorderCulling(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+
+	std::vector<std::unique_ptr<ChunkData>> chunks;
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			chunks.push_back(std::make_unique<ChunkData>(cx, cz));
+		} // end for
+	} // end for
+
+	auto chunkAt = [&](int cx, int cz) -> const ChunkData*
+		{
+			if (cx < 0 || cz < 0 || cx >= opt.side || cz >= opt.side)
+			{
+				return nullptr;
+			}
+			return chunks[cx + cz * opt.side].get();
+		};
+
+	uint64_t trisIsolated = 0;
+	uint64_t trisBorders = 0;
+	uint64_t blocksIsolated = 0;
+	uint64_t blocksBorders = 0;
+	double msIsolated = 0.0;
+	double msBorders = 0.0;
+
+	for (const auto& chunk : chunks)
+	{
+		ChunkMesh mesh(*chunk);
+
+		auto start = Clock::now();
+		mesh.rebuild();
+		msIsolated += ElapsedMs(start);
+		trisIsolated += mesh.opaqueIndexCount() / 3;
+		blocksIsolated += mesh.getRenderedBlockCount();
+
+		ChunkBorders borders;
+		for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+		{
+			auto s = static_cast<ChunkBorders::Side>(side);
+			ChunkCoord n = ChunkBorders::neighborOf({ chunk->m_chunkX, chunk->m_chunkZ }, s);
+			if (const ChunkData* neighbor = chunkAt(n.x, n.z))
+			{
+				borders.capture(s, *neighbor);
+			}
+		} // end for
+
+		start = Clock::now();
+		mesh.rebuild(&borders);
+		msBorders += ElapsedMs(start);
+		trisBorders += mesh.opaqueIndexCount() / 3;
+		blocksBorders += mesh.getRenderedBlockCount();
+	} // end for
+
+	ReportPerChunk(opt, "mesh.isolated", msIsolated, count);
+	ReportPerChunk(opt, "mesh.with_borders", msBorders, count);
+
+	std::printf("%-32s %10llu -> %llu  (%.1f%% fewer)\n", "mesh.triangles",
+		static_cast<unsigned long long>(trisIsolated),
+		static_cast<unsigned long long>(trisBorders),
+		100.0 * (1.0 - static_cast<double>(trisBorders) / trisIsolated));
+	std::printf("%-32s %10llu -> %llu  (%.1f%% fewer)\n", "mesh.rendered_blocks",
+		static_cast<unsigned long long>(blocksIsolated),
+		static_cast<unsigned long long>(blocksBorders),
+		100.0 * (1.0 - static_cast<double>(blocksBorders) / blocksIsolated));
+
+	Record(opt, "mesh.triangles_isolated", static_cast<double>(trisIsolated), "tris");
+	Record(opt, "mesh.triangles_with_borders", static_cast<double>(trisBorders), "tris");
+	Record(opt, "mesh.rendered_blocks_with_borders", static_cast<double>(blocksBorders), "blocks");
+} // end of BenchBorderCulling()
+
+
+// chunks/sec of the bitmask opaque mesher against the reference mesher,
+// and a byte compare of their output
+static void BenchMesher(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+	const int passes = 3;
+
+	std::vector<std::unique_ptr<ChunkData>> chunks;
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			chunks.push_back(std::make_unique<ChunkData>(cx, cz));
+		} // end for
+	} // end for
+
+	auto bordersFor = [&](const ChunkData& chunk)
+		{
+			ChunkBorders borders;
+			for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+			{
+				auto s = static_cast<ChunkBorders::Side>(side);
+				ChunkCoord n = ChunkBorders::neighborOf({ chunk.m_chunkX, chunk.m_chunkZ }, s);
+				if (n.x >= 0 && n.z >= 0 && n.x < opt.side && n.z < opt.side)
+				{
+					borders.capture(s, *chunks[n.x + n.z * opt.side]);
+				}
+			} // end for
+			return borders;
+		};
+
+	auto sameBytes = [](const auto& a, const auto& b)
+		{
+			return a.size() == b.size() &&
+				(a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+		};
+
+	double msReference = 0.0;
+	double msBitmask = 0.0;
+	int mismatches = 0;
+
+	for (const auto& chunk : chunks)
+	{
+		ChunkMesh reference(*chunk);
+		ChunkMesh bitmask(*chunk);
+		ChunkBorders borders = bordersFor(*chunk);
+
+		auto start = Clock::now();
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			reference.rebuild(&borders, MeshPath::Reference);
+		} // end for
+		msReference += ElapsedMs(start);
+
+		start = Clock::now();
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			bitmask.rebuild(&borders, MeshPath::Bitmask);
+		} // end for
+		msBitmask += ElapsedMs(start);
+
+		const ChunkMeshData& a = reference.data();
+		const ChunkMeshData& b = bitmask.data();
+		if (!sameBytes(a.opaqueVertices, b.opaqueVertices) ||
+			!sameBytes(a.opaqueRTVertices, b.opaqueRTVertices) ||
+			!sameBytes(a.opaqueIndices, b.opaqueIndices) ||
+			a.renderedBlockCount != b.renderedBlockCount)
+		{
+			++mismatches;
+		}
+	} // end for
+
+	const int meshed = count * passes;
+	ReportPerChunk(opt, "mesher.reference", msReference, meshed);
+	ReportPerChunk(opt, "mesher.bitmask", msBitmask, meshed);
+
+	std::printf("%-32s %10.0f -> %.0f chunks/sec  (%.2fx)\n", "mesher.throughput",
+		1000.0 * meshed / msReference,
+		1000.0 * meshed / msBitmask,
+		msReference / msBitmask);
+	std::printf("%-32s %10s  (%d/%d chunks match)\n", "mesher.identical",
+		mismatches == 0 ? "yes" : "NO", count - mismatches, count);
+	Record(opt, "mesher.reference_throughput", 1000.0 * meshed / msReference, "chunks/s");
+	Record(opt, "mesher.bitmask_throughput", 1000.0 * meshed / msBitmask, "chunks/s");
+
+	if (mismatches != 0)
+	{
+		opt.failed = true;
+	}
+} // end of BenchMesher()
+
+
+// world block lookups through the old hash map + float floor path and the
+// toroidal chunk grid + integer floor path, random and coherent access
+static void BenchLookup(BenchOptions& opt)
+{
+	const int radius = std::clamp(opt.radii.empty() ? 12 : opt.radii.back(), MIN_RADIUS, MAX_RADIUS);
+	const int lookups = 4000000;
+
+	// synthetic blocks, only the lookup path is measured
+	struct LookupChunk
+	{
+		std::vector<BlockID> blocks = std::vector<BlockID>(CHUNK_VOLUME);
+	};
+
+	std::unordered_map<ChunkCoord, std::unique_ptr<LookupChunk>, ChunkCoordHash> map;
+	ChunkGrid<LookupChunk> grid(radius);
+
+	for (int cz = -radius; cz <= radius; ++cz)
+	{
+		for (int cx = -radius; cx <= radius; ++cx)
+		{
+			auto a = std::make_unique<LookupChunk>();
+			auto b = std::make_unique<LookupChunk>();
+			for (int i = 0; i < CHUNK_VOLUME; ++i)
+			{
+				a->blocks[i] = b->blocks[i] = static_cast<BlockID>((i + cx * 7 + cz * 13) & 7);
+			} // end for
+			map.emplace(ChunkCoord{ cx, cz }, std::move(a));
+			grid.insert({ cx, cz }, std::move(b));
+		} // end for
+	} // end for
+
+	auto mapGet = [&](int wx, int wy, int wz)
+		{
+			int chunkX = static_cast<int>(std::floor(wx / static_cast<float>(CHUNK_SIZE)));
+			int chunkZ = static_cast<int>(std::floor(wz / static_cast<float>(CHUNK_SIZE)));
+
+			auto it = map.find({ chunkX, chunkZ });
+			if (it == map.end())
+			{
+				return BlockID::Air;
+			}
+
+			int localX = wx - chunkX * CHUNK_SIZE;
+			int localZ = wz - chunkZ * CHUNK_SIZE;
+			if (localX < 0 || localX >= CHUNK_SIZE ||
+				wy < 0 || wy >= CHUNK_SIZE_Y ||
+				localZ < 0 || localZ >= CHUNK_SIZE)
+			{
+				return BlockID::Air;
+			}
+			return it->second->blocks[localX + CHUNK_SIZE * (localZ + CHUNK_SIZE * wy)];
+		};
+
+	auto gridGet = [&](int wx, int wy, int wz)
+		{
+			if (wy < 0 || wy >= CHUNK_SIZE_Y)
+			{
+				return BlockID::Air;
+			}
+
+			int chunkX = FloorDiv(wx, CHUNK_SIZE);
+			int chunkZ = FloorDiv(wz, CHUNK_SIZE);
+
+			const LookupChunk* chunk = grid.find({ chunkX, chunkZ });
+			if (!chunk)
+			{
+				return BlockID::Air;
+			}
+
+			int localX = wx - chunkX * CHUNK_SIZE;
+			int localZ = wz - chunkZ * CHUNK_SIZE;
+			return chunk->blocks[localX + CHUNK_SIZE * (localZ + CHUNK_SIZE * wy)];
+		};
+
+	// random: anywhere in (and a little past) the loaded square.
+	// coherent: short x runs like raycasts and neighbour checks
+	const int extent = (radius + 1) * CHUNK_SIZE;
+	std::vector<glm::ivec3> randomPos(lookups);
+	std::vector<glm::ivec3> coherentPos(lookups);
+
+	std::mt19937 rng(99);
+	std::uniform_int_distribution<int> horizontal(-extent, extent);
+	std::uniform_int_distribution<int> vertical(0, CHUNK_SIZE_Y - 1);
+
+	for (int i = 0; i < lookups; ++i)
+	{
+		randomPos[i] = { horizontal(rng), vertical(rng), horizontal(rng) };
+	} // end for
+
+	for (int i = 0; i < lookups; i += 32)
+	{
+		glm::ivec3 start{ horizontal(rng), vertical(rng), horizontal(rng) };
+		for (int k = 0; k < 32 && i + k < lookups; ++k)
+		{
+			coherentPos[i + k] = start + glm::ivec3(k, 0, 0);
+		} // end for
+	} // end for
+
+	struct Pattern
+	{
+		const char* name;
+		const std::vector<glm::ivec3>* positions;
+	};
+	const Pattern patterns[] = { { "random", &randomPos }, { "coherent", &coherentPos } };
+
+	for (const Pattern& pattern : patterns)
+	{
+		uint64_t mapSum = 0;
+		uint64_t gridSum = 0;
+
+		auto start = Clock::now();
+		for (const glm::ivec3& p : *pattern.positions)
+		{
+			mapSum += static_cast<uint64_t>(mapGet(p.x, p.y, p.z));
+		} // end for
+		double mapMs = ElapsedMs(start);
+
+		start = Clock::now();
+		for (const glm::ivec3& p : *pattern.positions)
+		{
+			gridSum += static_cast<uint64_t>(gridGet(p.x, p.y, p.z));
+		} // end for
+		double gridMs = ElapsedMs(start);
+
+		const std::string name = std::string("lookup.") + pattern.name;
+		std::printf("%-32s %10.2f -> %.2f ns/lookup  (%.2fx, r%d)\n", name.c_str(),
+			1e6 * mapMs / lookups, 1e6 * gridMs / lookups, mapMs / gridMs, radius);
+		Record(opt, name + ".hash_map", 1e6 * mapMs / lookups, "ns/lookup");
+		Record(opt, name + ".grid", 1e6 * gridMs / lookups, "ns/lookup");
+
+		if (mapSum != gridSum)
+		{
+			Fail(opt, "grid lookup MISMATCH against hash map");
+		}
+	} // end for
+} // end of BenchLookup()
+
+
+// batched frustum culling against the per-box scalar test on synthetic
+// chunk grids, random camera views plus an ortho view whose planes land
+// exactly on chunk edges. masks must match bit for bit
+static void BenchCulling(BenchOptions& opt)
+{
+	const int radii[] = { 15, 50, 100 };
+	const int viewCount = 64;
+
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+	std::uniform_real_distribution<float> pitch(-1.2f, 1.2f);
+	std::uniform_real_distribution<float> offset(-40.0f, 40.0f);
+
+	for (int radius : radii)
+	{
+		ChunkCullBounds bounds;
+		for (int cz = -radius; cz <= radius; ++cz)
+		{
+			for (int cx = -radius; cx <= radius; ++cx)
+			{
+				glm::vec3 base(cx * CHUNK_SIZE, 0.0f, cz * CHUNK_SIZE);
+				bounds.push(cx, cz, { base, base + glm::vec3(CHUNK_SIZE, CHUNK_SIZE_Y, CHUNK_SIZE) });
+			} // end for
+		} // end for
+
+		const float farPlane = 1.5f * radius * CHUNK_SIZE;
+		const glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, farPlane);
+
+		std::vector<Frustum> frusta;
+		for (int v = 0; v < viewCount - 1; ++v)
+		{
+			glm::vec3 eye(offset(rng), 120.0f + offset(rng), offset(rng));
+			float yaw = angle(rng);
+			float tilt = pitch(rng);
+			glm::vec3 dir(std::cos(yaw) * std::cos(tilt), std::sin(tilt), std::sin(yaw) * std::cos(tilt));
+			frusta.push_back(ExtractFrustumPlanes(proj * glm::lookAt(eye, eye + dir, glm::vec3(0.0f, 1.0f, 0.0f))));
+		} // end for
+
+		const float half = static_cast<float>(radius / 2 * CHUNK_SIZE);
+		frusta.push_back(ExtractFrustumPlanes(
+			glm::ortho(-half, half, -half, half, 0.0f, 400.0f) *
+			glm::lookAt(glm::vec3(0.0f, 300.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f))));
+
+		std::vector<uint64_t> scalar;
+		std::vector<uint64_t> batched;
+		double scalarMs = 0.0;
+		double batchedMs = 0.0;
+		int mismatches = 0;
+		size_t visible = 0;
+
+		for (const Frustum& f : frusta)
+		{
+			auto start = Clock::now();
+			CullFrustumScalar(bounds, f, scalar);
+			scalarMs += ElapsedMs(start);
+
+			start = Clock::now();
+			CullFrustum(bounds, f, batched);
+			batchedMs += ElapsedMs(start);
+
+			if (scalar != batched)
+			{
+				++mismatches;
+			}
+			for (uint64_t word : batched)
+			{
+				visible += static_cast<size_t>(std::bitset<64>(word).count());
+			} // end for
+		} // end for
+
+		const double tests = static_cast<double>(bounds.size()) * frusta.size();
+		const std::string name = "cull.r" + std::to_string(radius);
+		std::printf("%-32s %10.2f -> %.2f ns/chunk  (%.2fx %s, %zu chunks, %.0f%% visible)\n", name.c_str(),
+			1e6 * scalarMs / tests, 1e6 * batchedMs / tests, scalarMs / batchedMs, CullFrustumPath(),
+			bounds.size(), 100.0 * visible / tests);
+		Record(opt, name + ".scalar", 1e6 * scalarMs / tests, "ns/chunk");
+		Record(opt, name + ".batched", 1e6 * batchedMs / tests, "ns/chunk");
+
+		if (mismatches != 0)
+		{
+			std::printf("%-32s %10s  (%d/%d views differ)\n", (name + ".identical").c_str(), "NO", mismatches, viewCount);
+			opt.failed = true;
+		}
+	} // end for
+} // end of BenchCulling()
+
+
+// true when the segment eye -> target enters box before reaching target
+static bool SegmentHitsBox(const glm::vec3& eye, const glm::vec3& target, const AABB& box)
+{
+	const glm::vec3 d = target - eye;
+	float tMin = 0.0f;
+	float tMax = 1.0f - 1e-4f;
+	for (int a = 0; a < 3; ++a)
+	{
+		if (std::fabs(d[a]) < 1e-8f)
+		{
+			if (eye[a] < box.min[a] || eye[a] > box.max[a])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float t0 = (box.min[a] - eye[a]) / d[a];
+		float t1 = (box.max[a] - eye[a]) / d[a];
+		if (t0 > t1)
+		{
+			std::swap(t0, t1);
+		}
+		tMin = std::max(tMin, t0);
+		tMax = std::min(tMax, t1);
+		if (tMin > tMax)
+		{
+			return false;
+		}
+	} // end for
+	return true;
+} // end of SegmentHitsBox()
+
+// occlusion buffer on synthetic scenes: fixed wall cases, then random
+// boxes where every box reported occluded is checked with rays from the eye
+// to points on its surface (each must be blocked by an occluder)
+static void BenchOcclusion(BenchOptions& opt)
+{
+	const glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	OcclusionBuffer buffer;
+
+	// 10x10 wall 10 units in front of the camera, looking down -z
+	{
+		buffer.begin(proj * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+		buffer.addOccluder({ { -5.0f, -5.0f, -12.0f }, { 5.0f, 5.0f, -10.0f } });
+		buffer.finish();
+
+		struct Case
+		{
+			const char* name;
+			AABB box;
+			bool occluded;
+		};
+		const Case cases[] = {
+			{ "behind", { { -5.0f, -5.0f, -40.0f }, { 5.0f, 5.0f, -30.0f } }, true },
+			{ "in front", { { -5.0f, -5.0f, -8.0f }, { 5.0f, 5.0f, -6.0f } }, false },
+			{ "touching", { { -5.0f, -5.0f, -12.0f }, { 5.0f, 5.0f, -11.0f } }, false },
+			{ "past edge", { { 30.0f, -5.0f, -40.0f }, { 40.0f, 5.0f, -30.0f } }, false },
+			{ "straddling edge", { { 10.0f, -5.0f, -40.0f }, { 30.0f, 5.0f, -30.0f } }, false },
+			{ "behind camera", { { -5.0f, -5.0f, 10.0f }, { 5.0f, 5.0f, 20.0f } }, false },
+		};
+		for (const Case& c : cases)
+		{
+			if (buffer.isOccluded(c.box) != c.occluded)
+			{
+				std::printf("%-32s %10s  (%s)\n", "occlusion.wall", "WRONG", c.name);
+				opt.failed = true;
+			}
+		} // end for
+	}
+
+	// random scenes
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+	const int scenes = 32;
+	const int occluderCount = 400;
+	const int queryCount = 2000;
+	double rasterMs = 0.0;
+	double queryMs = 0.0;
+	int occludedTotal = 0;
+	int wrong = 0;
+
+	std::vector<AABB> occluders;
+	std::vector<AABB> queries;
+	std::vector<uint8_t> hidden;
+	for (int scene = 0; scene < scenes; ++scene)
+	{
+		auto randomBox = [&](float spread, float minSize, float maxSize)
+			{
+				glm::vec3 size(minSize + (maxSize - minSize) * unit(rng), minSize + (maxSize - minSize) * unit(rng), minSize + (maxSize - minSize) * unit(rng));
+				glm::vec3 base((unit(rng) * 2.0f - 1.0f) * spread, unit(rng) * 60.0f, (unit(rng) * 2.0f - 1.0f) * spread);
+				return AABB{ base, base + size };
+			};
+
+		occluders.clear();
+		for (int i = 0; i < occluderCount; ++i)
+		{
+			occluders.push_back(randomBox(200.0f, 4.0f, 40.0f));
+		} // end for
+		queries.clear();
+		for (int i = 0; i < queryCount; ++i)
+		{
+			queries.push_back(randomBox(300.0f, 1.0f, 16.0f));
+		} // end for
+
+		const glm::vec3 eye(0.0f, 20.0f + 20.0f * unit(rng), 0.0f);
+		const float yaw = angle(rng);
+		const glm::vec3 dir(std::cos(yaw), -0.2f + 0.4f * unit(rng), std::sin(yaw));
+
+		auto start = Clock::now();
+		buffer.begin(proj * glm::lookAt(eye, eye + dir, glm::vec3(0.0f, 1.0f, 0.0f)));
+		for (const AABB& box : occluders)
+		{
+			buffer.addOccluder(box);
+		} // end for
+		buffer.finish();
+		rasterMs += ElapsedMs(start);
+
+		hidden.assign(queries.size(), 0);
+		start = Clock::now();
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			hidden[i] = buffer.isOccluded(queries[i]) ? 1 : 0;
+		} // end for
+		queryMs += ElapsedMs(start);
+
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			if (!hidden[i])
+			{
+				continue;
+			}
+			++occludedTotal;
+
+			// corners and random surface points must all be blocked
+			const AABB& q = queries[i];
+			for (int k = 0; k < 32; ++k)
+			{
+				glm::vec3 p(
+					(k < 8) ? ((k & 1) ? q.max.x : q.min.x) : q.min.x + (q.max.x - q.min.x) * unit(rng),
+					(k < 8) ? ((k & 2) ? q.max.y : q.min.y) : q.min.y + (q.max.y - q.min.y) * unit(rng),
+					(k < 8) ? ((k & 4) ? q.max.z : q.min.z) : q.min.z + (q.max.z - q.min.z) * unit(rng)
+				);
+				bool blocked = false;
+				for (const AABB& box : occluders)
+				{
+					if (SegmentHitsBox(eye, p, box))
+					{
+						blocked = true;
+						break;
+					}
+				} // end for
+
+				if (!blocked)
+				{
+					++wrong;
+					break;
+				}
+			} // end for
+		} // end for
+	} // end for
+
+	std::printf("%-32s %10.3f ms  (%d boxes, %dx%d)\n", "occlusion.raster", rasterMs / scenes,
+		occluderCount, OcclusionBuffer::DEFAULT_WIDTH, OcclusionBuffer::DEFAULT_HEIGHT);
+	std::printf("%-32s %10.1f ns/box  (%.1f%% occluded)\n", "occlusion.query", 1e6 * queryMs / (scenes * queryCount),
+		100.0 * occludedTotal / (scenes * queryCount));
+	Record(opt, "occlusion.raster", rasterMs / scenes, "ms");
+	Record(opt, "occlusion.query", 1e6 * queryMs / (scenes * queryCount), "ns/box");
+
+	if (wrong != 0)
+	{
+		std::printf("%-32s %10s  (%d boxes visible through occluders)\n", "occlusion.conservative", "NO", wrong);
+		opt.failed = true;
+	}
+} // end of BenchOcclusion()
+
+
+// stream every chunk around the camera and wait for it, returns ms spent
+static double StreamWorld(ChunkManager& world, const glm::vec3& cameraPos, int radius)
+{
+	const size_t target = static_cast<size_t>((2 * radius + 1) * (2 * radius + 1));
+
+	auto start = Clock::now();
+	for (int frame = 0; frame < 100000; ++frame)
+	{
+		world.updateDynamic(cameraPos);
+		if (world.getLoadedChunkCount() >= target && world.isStreamingIdle())
+		{
+			break;
+		}
+		world.waitForStreamingJobs();
+	} // end for
+	return ElapsedMs(start);
+} // end of StreamWorld()
+
+// middle value, reorders v
+static double Median(std::vector<double>& v)
+{
+	std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+	return v[v.size() / 2];
+} // end of Median()
+
+// light ortho around the in range chunks, fitted like the shadow map passes
+static void FitLightView(ChunkManager& world, glm::mat4& lightView, glm::mat4& lightProj)
+{
+	glm::vec3 minWS(0.0f);
+	glm::vec3 maxWS(0.0f);
+	world.buildVisibleChunkBounds(minWS, maxWS);
+
+	const glm::vec3 centerWS = 0.5f * (minWS + maxWS);
+	const glm::vec3 lightDir = glm::normalize(glm::vec3(0.4f, -1.0f, 0.3f));
+	lightView = glm::lookAt(centerWS - lightDir * 200.0f, centerWS, glm::vec3(0.0f, 1.0f, 0.0f));
+
+	glm::vec3 minLS(FLT_MAX);
+	glm::vec3 maxLS(-FLT_MAX);
+	for (int c = 0; c < 8; ++c)
+	{
+		const glm::vec3 corner{ (c & 1) ? maxWS.x : minWS.x, (c & 2) ? maxWS.y : minWS.y, (c & 4) ? maxWS.z : minWS.z };
+		const glm::vec3 ls = glm::vec3(lightView * glm::vec4(corner, 1.0f));
+		minLS = glm::min(minLS, ls);
+		maxLS = glm::max(maxLS, ls);
+	} // end for
+
+	const float nearPlane = std::max(0.1f, -maxLS.z - 16.0f);
+	lightProj = glm::ortho(minLS.x - 8.0f, maxLS.x + 8.0f, minLS.y - 8.0f, maxLS.y + 8.0f,
+		nearPlane, std::max(nearPlane + 1.0f, -minLS.z + 16.0f));
+} // end of FitLightView()
+
+// ChunkManager at each radius: generation + meshing (streaming), draw-list
+// building, raycasts and save/load of the resident world
+static void BenchWorld(BenchOptions& opt)
+{
+	// chunk manager saves under SAVE_PATH/HelloWorld
+	const std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / "HelloWorld";
+
+	const glm::vec3 cameraPos{ CHUNK_SIZE * 0.5f, 200.0f, CHUNK_SIZE * 0.5f };
+	const glm::mat4 view = glm::lookAt(cameraPos, cameraPos + glm::vec3(1.0f, -0.3f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+
+	for (int radius : opt.radii)
+	{
+		radius = std::clamp(radius, MIN_RADIUS, MAX_RADIUS);
+		const std::string prefix = "world.r" + std::to_string(radius) + ".";
+		const int count = (2 * radius + 1) * (2 * radius + 1);
+
+		std::filesystem::remove_all(worldDir);
+
+		{
+			// null GPU backend, kept around to total what would be uploaded
+			std::vector<std::shared_ptr<ChunkMeshGPUNull>> gpuMeshes;
+
+			ChunkManager world(radius);
+			world.init({ [&]()
+				{
+					gpuMeshes.push_back(std::make_shared<ChunkMeshGPUNull>());
+					return gpuMeshes.back();
+				} });
+
+			double ms = StreamWorld(world, cameraPos, radius);
+			int loaded = static_cast<int>(world.getLoadedChunkCount());
+			ReportPerChunk(opt, prefix + "stream_generate", ms, std::max(1, loaded));
+			if (loaded != count)
+			{
+				Fail(opt, "world did not finish streaming");
+			}
+
+			size_t uploadedBytes = 0;
+			for (const auto& gpu : gpuMeshes)
+			{
+				uploadedBytes += gpu->getUploadedBytes();
+			} // end for
+			std::printf("%-32s %10.1f MB  (%.1f KB/chunk)\n", (prefix + "uploaded").c_str(),
+				uploadedBytes / (1024.0 * 1024.0), uploadedBytes / 1024.0 / std::max(1, loaded));
+			Record(opt, prefix + "uploaded", uploadedBytes / 1024.0 / std::max(1, loaded), "KB/chunk");
+
+			// draw lists, averaged over repeated builds. one sweep per list
+			// first, then every view of a frame in a single sweep
+			const int builds = 50;
+			const glm::vec3 mirroredPos{ cameraPos.x, 2.0f * SEA_LEVEL - cameraPos.y, cameraPos.z };
+			const glm::mat4 reflView = glm::lookAt(mirroredPos, mirroredPos + glm::vec3(1.0f, 0.3f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::mat4 lightView;
+			glm::mat4 lightProj;
+			FitLightView(world, lightView, lightProj);
+			ChunkDrawList list;
+
+			auto start = Clock::now();
+			for (int i = 0; i < builds; ++i)
+			{
+				world.buildOpaqueDrawList(view, proj, list);
+			} // end for
+			double opaqueMs = ElapsedMs(start) / builds;
+			size_t opaqueItems = list.items.size();
+
+			start = Clock::now();
+			for (int i = 0; i < builds; ++i)
+			{
+				world.buildWaterDrawList(view, proj, list);
+			} // end for
+			double waterMs = ElapsedMs(start) / builds;
+
+			start = Clock::now();
+			for (int i = 0; i < builds; ++i)
+			{
+				world.buildRTDrawList(view, proj);
+			} // end for
+			double rtMs = ElapsedMs(start) / builds;
+
+			// what a frame used to cost: camera opaque + water, reflection, shadow, RT
+			std::vector<std::vector<glm::vec3>> separate;
+			auto origins = [](const ChunkDrawList& l)
+				{
+					std::vector<glm::vec3> o;
+					for (const ChunkDrawItem& item : l.items)
+					{
+						o.push_back(item.chunkOrigin);
+					} // end for
+					return o;
+				};
+
+			const std::vector<ChunkCullView> frameViews = {
+				{ view, proj, ChunkCullView::Opaque | ChunkCullView::Water | ChunkCullView::Combined },
+				{ reflView, proj, ChunkCullView::Opaque },
+				{ lightView, lightProj, ChunkCullView::Opaque }
+			};
+
+			// both ways per build, alternating which goes first, medians
+			std::vector<std::vector<glm::vec3>> single;
+			std::vector<double> separateTimes;
+			std::vector<double> singleTimes;
+			for (int i = 0; i < builds; ++i)
+			{
+				for (int pass = 0; pass < 2; ++pass)
+				{
+					const bool singlePass = (pass == 1) == (i % 2 == 0);
+					std::vector<std::vector<glm::vec3>>& lists = singlePass ? single : separate;
+
+					// drops the views the last frame registered
+					world.updateDynamic(cameraPos);
+					start = Clock::now();
+					if (singlePass)
+					{
+						world.cullFrameViews(frameViews);
+					}
+					lists.clear();
+					lists.push_back(origins(world.opaqueDrawListFor(view, proj)));
+					lists.push_back(origins(world.waterDrawListFor(view, proj)));
+					lists.push_back(origins(world.opaqueDrawListFor(reflView, proj)));
+					lists.push_back(origins(world.shadowDrawListFor(lightView, lightProj)));
+					world.buildRTDrawList(view, proj);
+					lists.push_back(origins(world.getRTDrawList()));
+					(singlePass ? singleTimes : separateTimes).push_back(ElapsedMs(start));
+				} // end for
+			} // end for
+			const double separateMs = Median(separateTimes);
+			const double singleMs = Median(singleTimes);
+
+			std::printf("%-32s %10.3f ms  (%zu of %d chunks)\n", (prefix + "draw_list.opaque").c_str(), opaqueMs, opaqueItems, loaded);
+			std::printf("%-32s %10.3f ms\n", (prefix + "draw_list.water").c_str(), waterMs);
+			std::printf("%-32s %10.3f ms\n", (prefix + "draw_list.rt").c_str(), rtMs);
+			std::printf("%-32s %10.3f -> %.3f ms  (5 lists, %.2fx)\n", (prefix + "draw_list.frame").c_str(),
+				separateMs, singleMs, separateMs / singleMs);
+			Record(opt, prefix + "draw_list.opaque", opaqueMs, "ms");
+			Record(opt, prefix + "draw_list.water", waterMs, "ms");
+			Record(opt, prefix + "draw_list.rt", rtMs, "ms");
+			Record(opt, prefix + "draw_list.frame_separate", separateMs, "ms");
+			Record(opt, prefix + "draw_list.frame_single_pass", singleMs, "ms");
+
+			if (separate != single)
+			{
+				Fail(opt, "single pass draw lists MISMATCH");
+			}
+
+			// a warm frame builds every list into kept buffers
+			{
+				const int frames = 20;
+				g_allocations = 0;
+				g_countAllocations = true;
+				start = Clock::now();
+				for (int i = 0; i < frames; ++i)
+				{
+					world.cullFrameViews(frameViews);
+					world.opaqueDrawListFor(view, proj);
+					world.waterDrawListFor(view, proj);
+					world.opaqueDrawListFor(reflView, proj);
+					world.shadowDrawListFor(lightView, lightProj);
+					world.buildRTDrawList(view, proj);
+				} // end for
+				const double frameMs = ElapsedMs(start) / frames;
+				g_countAllocations = false;
+
+				const double perFrame = static_cast<double>(g_allocations) / frames;
+				std::printf("%-32s %10.1f allocs/frame  (%.3f ms/frame, %zu B/item)\n", (prefix + "draw_list.allocations").c_str(),
+					perFrame, frameMs, sizeof(ChunkDrawItem));
+				Record(opt, prefix + "draw_list.allocations", perFrame, "allocs/frame");
+				Record(opt, prefix + "draw_list.warm_frame", frameMs, "ms");
+			}
+
+			// opaque lists come out front to back and water back to front,
+			// the radix sort matches a stable sort of a shuffled list
+			{
+				world.cullFrameViews(frameViews);
+				const ChunkDrawList& opaque = world.opaqueDrawListFor(view, proj);
+				const ChunkDrawList& water = world.waterDrawListFor(view, proj);
+				const float listMs = world.getFrameDrawListMs();
+
+				bool ordered = true;
+				for (size_t i = 1; i < opaque.items.size(); ++i)
+				{
+					ordered &= ChunkDrawSorter::distanceKey(opaque.items[i - 1], cameraPos) <= ChunkDrawSorter::distanceKey(opaque.items[i], cameraPos);
+				} // end for
+				for (size_t i = 1; i < water.items.size(); ++i)
+				{
+					ordered &= ChunkDrawSorter::distanceKey(water.items[i - 1], cameraPos) >= ChunkDrawSorter::distanceKey(water.items[i], cameraPos);
+				} // end for
+
+				std::vector<ChunkDrawItem> shuffled = world.shadowDrawListFor(lightView, lightProj).items;
+				std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(99));
+				std::vector<ChunkDrawItem> expected = shuffled;
+				std::stable_sort(expected.begin(), expected.end(), [&](const ChunkDrawItem& a, const ChunkDrawItem& b)
+					{
+						return ChunkDrawSorter::distanceKey(a, cameraPos) < ChunkDrawSorter::distanceKey(b, cameraPos);
+					});
+
+				ChunkDrawSorter sorter;
+				std::vector<ChunkDrawItem> items;
+				double sortMs = 0.0;
+				for (int i = 0; i < builds; ++i)
+				{
+					items = shuffled;
+					start = Clock::now();
+					sorter.sort(items, cameraPos, ChunkDrawSorter::Order::FrontToBack);
+					sortMs += ElapsedMs(start);
+				} // end for
+				sortMs /= builds;
+
+				std::printf("%-32s %10.3f ms  (%zu items, frame lists %.3f ms)\n", (prefix + "draw_list.sort").c_str(),
+					sortMs, items.size(), listMs);
+				Record(opt, prefix + "draw_list.sort", sortMs, "ms");
+				Record(opt, prefix + "draw_list.build", listMs, "ms");
+
+				if (!ordered || origins({ items }) != origins({ expected }))
+				{
+					Fail(opt, "draw list distance order WRONG");
+				}
+			}
+
+			// opaque triangles submitted as whole chunks vs. frustum
+			// tested sections, from the terrain band looking down/ahead/up
+			const glm::vec3 groundPos{ cameraPos.x, 80.0f, cameraPos.z };
+			const std::pair<const char*, glm::vec3> looks[] = {
+				{ "down", glm::vec3(1.0f, -2.0f, 0.2f) },
+				{ "ahead", glm::vec3(1.0f, -0.1f, 0.2f) },
+				{ "up", glm::vec3(1.0f, 2.0f, 0.2f) }
+			};
+			for (const auto& [lookName, lookDir] : looks)
+			{
+				const ChunkDrawList& drawn = world.opaqueDrawListFor(
+					glm::lookAt(groundPos, groundPos + lookDir, glm::vec3(0.0f, 1.0f, 0.0f)), proj);
+
+				uint64_t chunkTriangles = 0;
+				for (const ChunkDrawItem& item : drawn.items)
+				{
+					chunkTriangles += item.opaqueIndexCount / 3;
+				} // end for
+
+				const std::string name = prefix + "triangles." + lookName;
+				std::printf("%-32s %10llu -> %u  (%.1f%% with sections)\n", name.c_str(),
+					static_cast<unsigned long long>(chunkTriangles), drawn.frameTrianglesRendered,
+					100.0 * drawn.frameTrianglesRendered / std::max<uint64_t>(1, chunkTriangles));
+				Record(opt, name + ".chunks", static_cast<double>(chunkTriangles), "triangles");
+				Record(opt, name + ".sections", drawn.frameTrianglesRendered, "triangles");
+			} // end for
+
+			// occlusion culling of the camera view, just above the ground and
+			// from inside the terrain
+			int surfaceY = CHUNK_SIZE_Y - 1;
+			while (surfaceY > 0 && world.getBlock(static_cast<int>(cameraPos.x), surfaceY, static_cast<int>(cameraPos.z)) == BlockID::Air)
+			{
+				--surfaceY;
+			} // end while
+			const std::pair<const char*, float> eyes[] = { { "surface", surfaceY + 3.0f }, { "underground", 40.0f } };
+			for (const auto& [eyeName, eyeY] : eyes)
+			{
+				const glm::vec3 eye{ cameraPos.x, eyeY, cameraPos.z };
+				const glm::mat4 eyeView = glm::lookAt(eye, eye + glm::vec3(1.0f, -0.1f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+				const std::vector<ChunkCullView> eyeViews = {
+					{ eyeView, proj, ChunkCullView::Opaque | ChunkCullView::Water, true, true }
+				};
+
+				size_t drawn[2] = {};
+				uint32_t triangles[2] = {};
+				uint32_t occluded = 0;
+				double cullMs[2] = {};
+				world.enableCaveCulling(false);
+				for (int pass = 0; pass < 2; ++pass)
+				{
+					world.enableOcclusionCulling(pass == 1);
+					start = Clock::now();
+					for (int i = 0; i < builds; ++i)
+					{
+						world.cullFrameViews(eyeViews);
+					} // end for
+					cullMs[pass] = ElapsedMs(start) / builds;
+
+					const ChunkDrawList& eyeList = world.opaqueDrawListFor(eyeView, proj);
+					drawn[pass] = eyeList.items.size();
+					triangles[pass] = eyeList.frameTrianglesRendered;
+					occluded = eyeList.frameChunksOccluded;
+				} // end for
+
+				const std::string name = prefix + "occlusion." + eyeName;
+				std::printf("%-32s %10zu -> %zu chunks  (%u occluded, %u -> %u triangles, %.3f -> %.3f ms)\n", name.c_str(),
+					drawn[0], drawn[1], occluded, triangles[0], triangles[1], cullMs[0], cullMs[1]);
+				Record(opt, name + ".chunks_drawn", static_cast<double>(drawn[1]), "chunks");
+				Record(opt, name + ".chunks_occluded", occluded, "chunks");
+				Record(opt, name + ".triangles", triangles[1], "triangles");
+				Record(opt, name + ".cull", cullMs[1], "ms");
+			} // end for
+			world.enableCaveCulling(true);
+
+			// cave culling, from a cave air block below the surface near
+			// the camera column, occlusion alone vs. occlusion + caves
+			glm::vec3 cave{ 0.0f };
+			bool caveFound = false;
+			for (int r = 0; r < 3 * CHUNK_SIZE && !caveFound; ++r)
+			{
+				for (int y = 20; y < 60 && !caveFound; ++y)
+				{
+					const int x = static_cast<int>(cameraPos.x) + r;
+					const int z = static_cast<int>(cameraPos.z);
+					if (world.getBlock(x, y, z) == BlockID::Air && world.getBlock(x, y - 1, z) != BlockID::Air &&
+						world.getBlock(x, y + 8, z) != BlockID::Air)
+					{
+						cave = glm::vec3(x + 0.5f, y + 0.6f, z + 0.5f);
+						caveFound = true;
+					}
+				} // end for
+			} // end for
+
+			if (caveFound)
+			{
+				const glm::mat4 caveView = glm::lookAt(cave, cave + glm::vec3(1.0f, -0.1f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+				const std::vector<ChunkCullView> caveViews = {
+					{ caveView, proj, ChunkCullView::Opaque | ChunkCullView::Water, true, true }
+				};
+
+				size_t drawn[2] = {};
+				uint32_t triangles[2] = {};
+				double cullMs[2] = {};
+				for (int pass = 0; pass < 2; ++pass)
+				{
+					world.enableCaveCulling(pass == 1);
+					start = Clock::now();
+					for (int i = 0; i < builds; ++i)
+					{
+						world.cullFrameViews(caveViews);
+					} // end for
+					cullMs[pass] = ElapsedMs(start) / builds;
+
+					const ChunkDrawList& caveList = world.opaqueDrawListFor(caveView, proj);
+					drawn[pass] = caveList.items.size();
+					triangles[pass] = caveList.frameTrianglesRendered;
+				} // end for
+
+				const std::string name = prefix + "caves";
+				std::printf("%-32s %10zu -> %zu chunks  (%u -> %u triangles, %.3f -> %.3f ms)\n", name.c_str(),
+					drawn[0], drawn[1], triangles[0], triangles[1], cullMs[0], cullMs[1]);
+				Record(opt, name + ".chunks_drawn", static_cast<double>(drawn[1]), "chunks");
+				Record(opt, name + ".triangles", triangles[1], "triangles");
+				Record(opt, name + ".cull", cullMs[1], "ms");
+			}
+			else
+			{
+				std::printf("%-32s %10s  (no cave near the camera)\n", (prefix + "caves").c_str(), "-");
+			}
+			world.enableOcclusionCulling(false);
+
+			// raycasts from inside the terrain band in random directions
+			const int rays = 20000;
+			std::mt19937 rng(1234);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> spread(-radius * CHUNK_SIZE * 0.5f, radius * CHUNK_SIZE * 0.5f);
+
+			int hits = 0;
+			start = Clock::now();
+			for (int i = 0; i < rays; ++i)
+			{
+				glm::vec3 origin{ spread(rng), 60.0f + 40.0f * unit(rng), spread(rng) };
+				glm::vec3 dir{ unit(rng), unit(rng), unit(rng) };
+				if (glm::dot(dir, dir) < 1e-4f)
+				{
+					dir = glm::vec3(0.0f, -1.0f, 0.0f);
+				}
+				hits += world.raycastBlocks(origin, dir).hit ? 1 : 0;
+			} // end for
+			double rayMs = ElapsedMs(start);
+
+			std::printf("%-32s %10.3f us/ray  (%d rays, %d hits)\n", (prefix + "raycast").c_str(), 1000.0 * rayMs / rays, rays, hits);
+			Record(opt, prefix + "raycast", 1000.0 * rayMs / rays, "us/ray");
+
+			// getBlock through the manager, random blocks vs. x runs
+			const int lookups = 1000000;
+			const int extent = radius * CHUNK_SIZE;
+			std::uniform_int_distribution<int> horizontal(-extent, extent);
+			std::uniform_int_distribution<int> vertical(0, CHUNK_SIZE_Y - 1);
+
+			uint32_t solid = 0;
+			start = Clock::now();
+			for (int i = 0; i < lookups; ++i)
+			{
+				solid += world.getBlock(horizontal(rng), vertical(rng), horizontal(rng)) != BlockID::Air ? 1 : 0;
+			} // end for
+			double randomMs = ElapsedMs(start);
+
+			start = Clock::now();
+			for (int i = 0; i < lookups; i += 32)
+			{
+				int wx = horizontal(rng);
+				int wy = vertical(rng);
+				int wz = horizontal(rng);
+				for (int k = 0; k < 32; ++k)
+				{
+					solid += world.getBlock(wx + k, wy, wz) != BlockID::Air ? 1 : 0;
+				} // end for
+			} // end for
+			double coherentMs = ElapsedMs(start);
+
+			std::printf("%-32s %10.2f ns  (%u solid)\n", (prefix + "get_block.random").c_str(), 1e6 * randomMs / lookups, solid);
+			std::printf("%-32s %10.2f ns\n", (prefix + "get_block.coherent").c_str(), 1e6 * coherentMs / lookups);
+			Record(opt, prefix + "get_block.random", 1e6 * randomMs / lookups, "ns");
+			Record(opt, prefix + "get_block.coherent", 1e6 * coherentMs / lookups, "ns");
+
+			// touch every chunk so saveWorld() has the whole world to write
+			for (int cz = -radius; cz <= radius; ++cz)
+			{
+				for (int cx = -radius; cx <= radius; ++cx)
+				{
+					world.setBlock(cx * CHUNK_SIZE, CHUNK_SIZE_Y - 1, cz * CHUNK_SIZE, BlockID::Glow_Block);
+				} // end for
+			} // end for
+
+			start = Clock::now();
+			world.flushWorld();
+			ReportPerChunk(opt, prefix + "save_flush", ElapsedMs(start), count);
+		}
+
+		// same area again, every chunk comes from the save
+		{
+			ChunkManager world(radius);
+			world.init();
+
+			double ms = StreamWorld(world, cameraPos, radius);
+			ReportPerChunk(opt, prefix + "stream_load", ms, std::max<int>(1, static_cast<int>(world.getLoadedChunkCount())));
+
+			if (world.getBlock(0, CHUNK_SIZE_Y - 1, 0) != BlockID::Glow_Block)
+			{
+				Fail(opt, "world save/load round trip MISMATCH");
+			}
+		}
+
+		// walk the camera 3 chunks along x in two identical inline worlds,
+		// one culling incrementally and one re-testing every chunk each
+		// frame. both pay the same bounds rebuild after their uploads, and
+		// the lists must match
+		{
+			ChunkManager incrementalWorld(radius, 0);
+			ChunkManager fullWorld(radius, 0);
+			incrementalWorld.init();
+			fullWorld.init();
+			incrementalWorld.enableIncrementalCulling(true);
+			fullWorld.enableIncrementalCulling(false);
+			StreamWorld(incrementalWorld, cameraPos, radius);
+			StreamWorld(fullWorld, cameraPos, radius);
+
+			// one light for the walk, fitting it per frame would refresh the
+			// cull range outside the timed calls
+			glm::mat4 lightView;
+			glm::mat4 lightProj;
+			FitLightView(fullWorld, lightView, lightProj);
+
+			// per frame times, the median keeps scheduler hiccups out
+			const int frames = 90;
+			uint64_t reevaluated = 0;
+			std::vector<double> incrementalMs;
+			std::vector<double> fullMs;
+			bool same = true;
+			auto origins = [](const ChunkDrawList& l, std::vector<glm::vec3>& o)
+				{
+					o.clear();
+					for (const ChunkDrawItem& item : l.items)
+					{
+						o.push_back(item.chunkOrigin);
+					} // end for
+				};
+			std::vector<glm::vec3> incremental[3];
+			std::vector<glm::vec3> full[3];
+			for (int f = 0; f < frames; ++f)
+			{
+				const glm::vec3 eye = cameraPos + glm::vec3(0.5f * f, 0.0f, 0.0f);
+				const glm::mat4 eyeView = glm::lookAt(eye, eye + glm::vec3(1.0f, -0.3f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+				const std::vector<ChunkCullView> eyeViews = {
+					{ eyeView, proj, ChunkCullView::Opaque | ChunkCullView::Water },
+					{ lightView, lightProj, ChunkCullView::Opaque }
+				};
+
+				incrementalWorld.updateDynamic(eye);
+				Clock::time_point start = Clock::now();
+				incrementalWorld.cullFrameViews(eyeViews);
+				incrementalMs.push_back(ElapsedMs(start));
+				reevaluated += incrementalWorld.getFrameChunksReevaluated();
+				origins(incrementalWorld.opaqueDrawListFor(eyeView, proj), incremental[0]);
+				origins(incrementalWorld.waterDrawListFor(eyeView, proj), incremental[1]);
+				origins(incrementalWorld.shadowDrawListFor(lightView, lightProj), incremental[2]);
+
+				fullWorld.updateDynamic(eye);
+				start = Clock::now();
+				fullWorld.cullFrameViews(eyeViews);
+				fullMs.push_back(ElapsedMs(start));
+				origins(fullWorld.opaqueDrawListFor(eyeView, proj), full[0]);
+				origins(fullWorld.waterDrawListFor(eyeView, proj), full[1]);
+				origins(fullWorld.shadowDrawListFor(lightView, lightProj), full[2]);
+
+				for (int l = 0; l < 3; ++l)
+				{
+					same &= incremental[l] == full[l];
+				} // end for
+			} // end for
+
+			const double incrementalMedian = Median(incrementalMs);
+			const double fullMedian = Median(fullMs);
+
+			std::printf("%-32s %10.1f chunks/frame  (of %zu, median %.4f -> %.4f ms/frame)\n", (prefix + "cull.reevaluated").c_str(),
+				static_cast<double>(reevaluated) / frames, incrementalWorld.getLoadedChunkCount(), fullMedian, incrementalMedian);
+			Record(opt, prefix + "cull.reevaluated", static_cast<double>(reevaluated) / frames, "chunks/frame");
+			Record(opt, prefix + "cull.incremental", incrementalMedian, "ms");
+			Record(opt, prefix + "cull.full", fullMedian, "ms");
+
+			if (!same)
+			{
+				Fail(opt, "incremental draw lists MISMATCH");
+			}
+		}
+
+		std::filesystem::remove_all(worldDir);
+	} // end for
+} // end of BenchWorld()
+
+// fly-through paths at sprint speed with one chunk uploaded per frame.
+// a visible chunk is one in the view radius and the camera frustum, the
+// time each one is missing is summed along the path (chunk seconds),
+// nearest first vs. the predicted path first
+static void BenchStream(BenchOptions& opt)
+{
+	const std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / "HelloWorld";
+	const int radius = opt.radii.empty() ? 6 : opt.radii.front();
+	const float speed = 112.5f;
+	const float dt = 1.0f / 60.0f;
+	const float eyeY = 150.0f;
+	const glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+
+	struct FlyPath
+	{
+		const char* name;
+		std::vector<glm::vec2> points;
+	};
+	const FlyPath paths[] = {
+		{ "straight", { { 0.0f, 0.0f }, { 1800.0f, 0.0f } } },
+		{ "turns", { { 0.0f, 0.0f }, { 600.0f, 0.0f }, { 600.0f, 600.0f }, { 0.0f, 600.0f } } },
+		{ "zigzag", { { 0.0f, 0.0f }, { 400.0f, 250.0f }, { 800.0f, -250.0f }, { 1200.0f, 250.0f }, { 1600.0f, -250.0f } } }
+	};
+
+	for (const FlyPath& path : paths)
+	{
+		double missing[2] = {};
+		uint32_t worst[2] = {};
+		uint32_t prefetched = 0;
+		for (int mode = 0; mode < 2; ++mode)
+		{
+			std::filesystem::remove_all(worldDir);
+			ChunkManager world(radius, 0);
+			world.init();
+			world.setStreamLookahead(mode == 0 ? 0.0f : 2.0f);
+
+			const glm::vec3 start{ path.points[0].x, eyeY, path.points[0].y };
+			StreamWorld(world, start, radius);
+			world.setUploadBudgetBytes(1);
+
+			for (size_t leg = 1; leg < path.points.size(); ++leg)
+			{
+				const glm::vec2 from = path.points[leg - 1];
+				const glm::vec2 to = path.points[leg];
+				const glm::vec2 dir = glm::normalize(to - from);
+				const int frames = static_cast<int>(glm::length(to - from) / (speed * dt));
+
+				for (int f = 1; f <= frames; ++f)
+				{
+					const glm::vec2 xz = from + dir * (speed * dt * f);
+					const glm::vec3 eye{ xz.x, eyeY, xz.y };
+					const glm::vec3 forward{ dir.x, -0.3f, dir.y };
+
+					world.setCameraMotion(glm::vec3(dir.x, 0.0f, dir.y) * speed, forward);
+					world.updateDynamic(eye);
+
+					const Frustum frustum = ExtractFrustumPlanes(proj * glm::lookAt(eye, eye + forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+					const int cx = static_cast<int>(std::floor(eye.x / CHUNK_SIZE));
+					const int cz = static_cast<int>(std::floor(eye.z / CHUNK_SIZE));
+					uint32_t absent = 0;
+					for (int z = cz - radius; z <= cz + radius; ++z)
+					{
+						for (int x = cx - radius; x <= cx + radius; ++x)
+						{
+							const AABB column{
+								glm::vec3(x * CHUNK_SIZE, 0.0f, z * CHUNK_SIZE),
+								glm::vec3((x + 1) * CHUNK_SIZE, CHUNK_SIZE_Y, (z + 1) * CHUNK_SIZE)
+							};
+							if ((x - cx) * (x - cx) + (z - cz) * (z - cz) <= radius * radius &&
+								IntersectsFrustum(column, frustum) && !world.isChunkLoaded(x, z))
+							{
+								++absent;
+							}
+						} // end for
+					} // end for
+
+					missing[mode] += absent * dt;
+					worst[mode] = std::max(worst[mode], absent);
+				} // end for
+			} // end for
+
+			prefetched = world.getRegionsPrefetched();
+		} // end for
+
+		const std::string name = std::string("stream.") + path.name;
+		std::printf("%-32s %10.2f -> %.2f chunk s  (worst %u -> %u missing, %u regions prefetched)\n", name.c_str(),
+			missing[0], missing[1], worst[0], worst[1], prefetched);
+		Record(opt, name + ".nearest", missing[0], "chunk s");
+		Record(opt, name + ".predicted", missing[1], "chunk s");
+	} // end for
+
+	// scripted walk with the inline job system: at each waypoint, once
+	// streaming goes idle, every chunk within the radius must be resident
+	int waypoints = 0;
+	int incomplete = 0;
+	for (const FlyPath& path : paths)
+	{
+		std::filesystem::remove_all(worldDir);
+		ChunkManager world(radius, 0);
+		world.init();
+
+		for (size_t leg = 0; leg < path.points.size(); ++leg)
+		{
+			const glm::vec2 to = path.points[leg];
+			if (leg > 0)
+			{
+				const glm::vec2 from = path.points[leg - 1];
+				const glm::vec2 dir = glm::normalize(to - from);
+				const int frames = static_cast<int>(glm::length(to - from) / (speed * dt));
+				for (int f = 1; f <= frames; ++f)
+				{
+					const glm::vec2 xz = from + dir * (speed * dt * f);
+					world.setCameraMotion(glm::vec3(dir.x, 0.0f, dir.y) * speed, glm::vec3(dir.x, -0.3f, dir.y));
+					world.updateDynamic(glm::vec3(xz.x, eyeY, xz.y));
+				} // end for
+			}
+
+			// camera at rest on the waypoint until streaming goes idle
+			const glm::vec3 eye{ to.x, eyeY, to.y };
+			const int cx = static_cast<int>(std::floor(eye.x / CHUNK_SIZE));
+			const int cz = static_cast<int>(std::floor(eye.z / CHUNK_SIZE));
+			world.setCameraMotion(glm::vec3(0.0f), glm::vec3(1.0f, -0.3f, 0.0f));
+
+			bool resident = false;
+			for (int frame = 0; frame < 10000 && !resident; ++frame)
+			{
+				world.updateDynamic(eye);
+				resident = world.isStreamingIdle();
+				for (int z = cz - radius; z <= cz + radius && resident; ++z)
+				{
+					for (int x = cx - radius; x <= cx + radius && resident; ++x)
+					{
+						resident = world.isChunkLoaded(x, z);
+					} // end for
+				} // end for
+			} // end for
+
+			++waypoints;
+			incomplete += resident ? 0 : 1;
+		} // end for
+	} // end for
+
+	std::printf("%-32s %10s  (%d/%d waypoints fully resident)\n", "stream.walk_resident",
+		incomplete == 0 ? "yes" : "NO", waypoints - incomplete, waypoints);
+	if (incomplete != 0)
+	{
+		Fail(opt, "chunks missing around a waypoint after streaming went idle");
+	}
+
+	std::filesystem::remove_all(worldDir);
+} // end of BenchStream()
+
+// far terrain LOD meshes against full detail chunks (generation + meshing),
+// skirt depth against the lowest ground, then a world with a LOD ring:
+// ring coverage, LOD list culling and no overlap with drawn chunks
+static void BenchLod(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+	const int skirt = ChunkLodMesher::skirtBottom(TerrainGenerator::standard().getSettings());
+
+	double fullMs = 0.0;
+	uint64_t fullTriangles = 0;
+	size_t fullBytes = 0;
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			auto start = Clock::now();
+			ChunkData chunk(cx, cz);
+			ChunkMesh mesh(chunk);
+			mesh.rebuild();
+			fullMs += ElapsedMs(start);
+			fullTriangles += mesh.data().opaqueIndices.size() / 3;
+			fullBytes += mesh.data().uploadSizeBytes();
+		} // end for
+	} // end for
+	std::printf("%-32s %10.3f ms/chunk  (%.0f triangles, %.1f KB)\n", "lod.full",
+		fullMs / count, static_cast<double>(fullTriangles) / count, fullBytes / 1024.0 / count);
+	Record(opt, "lod.full", fullMs / count, "ms/chunk");
+
+	bool skirtsClosed = true;
+	ChunkMeshData lod;
+	for (int step : ChunkLodMesher::STEPS)
+	{
+		double ms = 0.0;
+		uint64_t triangles = 0;
+		size_t bytes = 0;
+		for (int cz = 0; cz < opt.side; ++cz)
+		{
+			for (int cx = 0; cx < opt.side; ++cx)
+			{
+				auto start = Clock::now();
+				ChunkLodMesher::build(TerrainGenerator::standard(), { cx, cz }, step, lod);
+				ms += ElapsedMs(start);
+				triangles += lod.opaqueIndices.size() / 3;
+				bytes += lod.uploadSizeBytes();
+				skirtsClosed &= lod.minY == static_cast<float>(skirt);
+			} // end for
+		} // end for
+
+		const std::string name = "lod.step" + std::to_string(step);
+		std::printf("%-32s %10.3f ms/chunk  (%.0f triangles, %.1f KB, %.1f%% of full)\n", name.c_str(),
+			ms / count, static_cast<double>(triangles) / count, bytes / 1024.0 / count,
+			100.0 * triangles / std::max<uint64_t>(1, fullTriangles));
+		Record(opt, name, ms / count, "ms/chunk");
+		Record(opt, name + ".triangles", static_cast<double>(triangles) / count, "triangles/chunk");
+	} // end for
+
+	// skirts hang below the lowest ground of a wide area, for the default
+	// world and one with deeper, rougher terrain
+	const auto lowestGround = [](const TerrainGenerator& terrain)
+		{
+			int lowest = CHUNK_SIZE_Y;
+			for (int cz = -64; cz < 64; cz += 4)
+			{
+				for (int cx = -64; cx < 64; cx += 4)
+				{
+					for (int z = 0; z < CHUNK_SIZE; ++z)
+					{
+						for (int x = 0; x < CHUNK_SIZE; ++x)
+						{
+							lowest = std::min(lowest, terrain.surfaceHeight(cx, cz, x, z));
+						} // end for
+					} // end for
+				} // end for
+			} // end for
+			return lowest;
+		};
+
+	const int lowest = lowestGround(TerrainGenerator::standard());
+	std::printf("%-32s %10d  (skirts to %d)\n", "lod.lowest_ground", lowest, skirt);
+	if (!skirtsClosed || lowest <= skirt)
+	{
+		Fail(opt, "lod skirts WRONG");
+	}
+
+	TerrainSettings rough;
+	rough.minGround = 70;
+	rough.maxTerrain = 100;
+	rough.heightOctaves = 6;
+	rough.heightPersistence = 0.55;
+	const TerrainGenerator roughTerrain(rough);
+	ChunkLodMesher::build(roughTerrain, { 0, 0 }, ChunkLodMesher::STEPS[0], lod);
+	const int roughLowest = lowestGround(roughTerrain);
+	const int roughSkirt = ChunkLodMesher::skirtBottom(rough);
+	std::printf("%-32s %10d  (skirts to %d)\n", "lod.lowest_ground_rough", roughLowest, roughSkirt);
+	if (lod.minY != static_cast<float>(roughSkirt) || roughLowest <= roughSkirt)
+	{
+		Fail(opt, "lod skirts of a custom world WRONG");
+	}
+
+	// world with a LOD ring
+	const std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / "HelloWorld";
+	const int radius = opt.radii.empty() ? 8 : std::clamp(opt.radii.front(), MIN_RADIUS, MAX_RADIUS);
+	const int lodRadius = 4 * radius;
+	const glm::vec3 cameraPos{ CHUNK_SIZE * 0.5f, 120.0f, CHUNK_SIZE * 0.5f };
+	const glm::mat4 view = glm::lookAt(cameraPos, cameraPos + glm::vec3(1.0f, -0.1f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+
+	std::filesystem::remove_all(worldDir);
+	{
+		ChunkManager world(radius, 0);
+		world.init();
+		world.setLodRadius(lodRadius);
+		const double streamMs = StreamWorld(world, cameraPos, radius);
+		std::printf("%-32s %10.1f ms  (%zu LOD chunks to radius %d)\n", "lod.stream",
+			streamMs, world.getLodChunkCount(), lodRadius);
+		Record(opt, "lod.stream", streamMs, "ms");
+
+		// everything past the view radius has far terrain
+		size_t ring = 0;
+		for (int dz = -lodRadius; dz <= lodRadius; ++dz)
+		{
+			for (int dx = -lodRadius; dx <= lodRadius; ++dx)
+			{
+				const int dist2 = dx * dx + dz * dz;
+				ring += (dist2 > radius * radius && dist2 <= lodRadius * lodRadius) ? 1 : 0;
+			} // end for
+		} // end for
+		if (world.getLodChunkCount() < ring)
+		{
+			Fail(opt, "lod ring coverage WRONG");
+		}
+
+		const int builds = 50;
+		world.updateDynamic(cameraPos);
+		auto start = Clock::now();
+		for (int i = 0; i < builds; ++i)
+		{
+			world.lodDrawListFor(view, proj);
+		} // end for
+		const double cullMs = ElapsedMs(start) / builds;
+
+		// a chunk is drawn either in full or as far terrain, never both
+		const ChunkDrawList& lodList = world.lodDrawListFor(view, proj);
+		const ChunkDrawList& opaqueList = world.opaqueDrawListFor(view, proj);
+		int overlaps = 0;
+		for (const ChunkDrawItem& far : lodList.items)
+		{
+			for (const ChunkDrawItem& near : opaqueList.items)
+			{
+				overlaps += (far.chunkOrigin.x == near.chunkOrigin.x && far.chunkOrigin.z == near.chunkOrigin.z) ? 1 : 0;
+			} // end for
+		} // end for
+
+		std::printf("%-32s %10.3f ms  (%u LOD chunks, %u triangles drawn)\n", "lod.cull",
+			cullMs, lodList.frameChunksRendered, lodList.frameTrianglesRendered);
+		Record(opt, "lod.cull", cullMs, "ms");
+		Record(opt, "lod.triangles", lodList.frameTrianglesRendered, "triangles");
+		if (lodList.items.empty() || overlaps != 0)
+		{
+			Fail(opt, "lod draw list overlap WRONG");
+		}
+	}
+	std::filesystem::remove_all(worldDir);
+} // end of BenchLod()
+
+// terrain generation through libnoise per sample vs. PerlinBatch lines
+// (identical chunks), then height statistics of a fixed area against the
+// values the original generator produced
+static void BenchNoise(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+
+	double msReference = 0.0;
+	double msBatch = 0.0;
+	int mismatches = 0;
+	std::vector<BlockID> reference(CHUNK_VOLUME);
+	std::vector<BlockID> batch(CHUNK_VOLUME);
+	for (int cz = 0; cz < opt.side; ++cz)
+	{
+		for (int cx = 0; cx < opt.side; ++cx)
+		{
+			ChunkData a(cx, cz, false);
+			ChunkData b(cx, cz, false);
+
+			auto start = Clock::now();
+			a.generate(NoisePath::Reference);
+			msReference += ElapsedMs(start);
+
+			start = Clock::now();
+			b.generate(NoisePath::Batch);
+			msBatch += ElapsedMs(start);
+
+			a.copyBlocks(reference.data());
+			b.copyBlocks(batch.data());
+			if (std::memcmp(reference.data(), batch.data(), CHUNK_VOLUME * sizeof(BlockID)) != 0)
+			{
+				++mismatches;
+			}
+		} // end for
+	} // end for
+
+	ReportPerChunk(opt, "noise.reference", msReference, count);
+	ReportPerChunk(opt, "noise.batch", msBatch, count);
+	std::printf("%-32s %10.0f -> %.0f chunks/sec  (%.2fx)\n", "noise.throughput",
+		1000.0 * count / msReference, 1000.0 * count / msBatch, msReference / msBatch);
+	std::printf("%-32s %10s  (%d/%d chunks match)\n", "noise.identical",
+		mismatches == 0 ? "yes" : "NO", count - mismatches, count);
+	Record(opt, "noise.reference_throughput", 1000.0 * count / msReference, "chunks/s");
+	Record(opt, "noise.batch_throughput", 1000.0 * count / msBatch, "chunks/s");
+	if (mismatches != 0)
+	{
+		opt.failed = true;
+	}
+
+	// ground heights (top sand / snow grass block) of chunks [0, 8)^2
+	int lowest = CHUNK_SIZE_Y;
+	int highest = 0;
+	int waterColumns = 0;
+	long long heightSum = 0;
+	uint32_t heightHash = 2166136261u;
+	for (int cz = 0; cz < 8; ++cz)
+	{
+		for (int cx = 0; cx < 8; ++cx)
+		{
+			ChunkData chunk(cx, cz);
+			for (int z = 0; z < CHUNK_SIZE; ++z)
+			{
+				for (int x = 0; x < CHUNK_SIZE; ++x)
+				{
+					int ground = 0;
+					for (int y = CHUNK_SIZE_Y - 1; y >= 0; --y)
+					{
+						const BlockID id = chunk.getBlockID(x, y, z);
+						if (id == BlockID::Sand || id == BlockID::SnowGrass)
+						{
+							ground = y;
+							break;
+						}
+					} // end for
+
+					lowest = std::min(lowest, ground);
+					highest = std::max(highest, ground);
+					heightSum += ground;
+					waterColumns += (ground < SEA_LEVEL) ? 1 : 0;
+					heightHash ^= static_cast<uint32_t>(ground);
+					heightHash *= 16777619u;
+				} // end for
+			} // end for
+		} // end for
+	} // end for
+
+	const int columns = 64 * CHUNK_SIZE * CHUNK_SIZE;
+	const bool golden = lowest == 100 && highest == 189 && heightSum == 1975897 &&
+		waterColumns == 7856 && heightHash == 0xf64520aeu;
+	std::printf("%-32s %10s  (ground %d..%d, mean %.2f, %d water columns)\n", "noise.golden_heights",
+		golden ? "yes" : "NO", lowest, highest, static_cast<double>(heightSum) / columns, waterColumns);
+	if (!golden)
+	{
+		Fail(opt, "terrain height statistics MISMATCH");
+	}
+} // end of BenchNoise()
+
+// one TerrainGenerator shared by every hardware thread, thousands of chunks
+// generated at once and each compared against the single-threaded result
+static void BenchTerrain(BenchOptions& opt)
+{
+	const int side = 48;
+	const int count = side * side;
+	const unsigned threadCount = std::max(4u, std::thread::hardware_concurrency());
+	const TerrainGenerator terrain;
+
+	const auto coordOf = [&](int i)
+		{
+			return ChunkCoord{ i % side - side / 2, i / side - side / 2 };
+		};
+	const auto hashOf = [](const ChunkData& chunk, std::vector<BlockID>& scratch)
+		{
+			chunk.copyBlocks(scratch.data());
+			uint64_t h = 14695981039346656037ull;
+			for (BlockID id : scratch)
+			{
+				h ^= static_cast<uint64_t>(id);
+				h *= 1099511628211ull;
+			} // end for
+			return h;
+		};
+
+	std::vector<uint64_t> expected(count);
+	auto start = Clock::now();
+	{
+		ChunkData chunk(0, 0, false);
+		std::vector<BlockID> scratch(CHUNK_VOLUME);
+		for (int i = 0; i < count; ++i)
+		{
+			terrain.generate(coordOf(i), chunk);
+			expected[i] = hashOf(chunk, scratch);
+		} // end for
+	}
+	const double singleMs = ElapsedMs(start);
+
+	std::atomic<int> next{ 0 };
+	std::atomic<int> mismatches{ 0 };
+	std::vector<std::thread> threads;
+	start = Clock::now();
+	for (unsigned t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&]()
+			{
+				ChunkData chunk(0, 0, false);
+				std::vector<BlockID> scratch(CHUNK_VOLUME);
+				for (int i = next++; i < count; i = next++)
+				{
+					terrain.generate(coordOf(i), chunk);
+					if (hashOf(chunk, scratch) != expected[i])
+					{
+						++mismatches;
+					}
+				} // end for
+			});
+	} // end for
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	} // end for
+	const double parallelMs = ElapsedMs(start);
+
+	std::printf("%-32s %10.0f -> %.0f chunks/sec  (%u threads, %.2fx)\n", "terrain.throughput",
+		1000.0 * count / singleMs, 1000.0 * count / parallelMs, threadCount, singleMs / parallelMs);
+	std::printf("%-32s %10s  (%d/%d chunks match)\n", "terrain.concurrent_identical",
+		mismatches == 0 ? "yes" : "NO", count - mismatches.load(), count);
+	Record(opt, "terrain.single_throughput", 1000.0 * count / singleMs, "chunks/s");
+	Record(opt, "terrain.parallel_throughput", 1000.0 * count / parallelMs, "chunks/s");
+	if (mismatches != 0)
+	{
+		opt.failed = true;
+	}
+} // end of BenchTerrain()
+
+// cave carving per block vs. coarse lattices of interpolated cave noise:
+// generation throughput and how many blocks come out different
+static void BenchCaves(BenchOptions& opt)
+{
+	struct Lattice
+	{
+		int xz;
+		int y;
+	};
+	const Lattice lattices[] = { { 1, 1 }, { 2, 4 }, { 4, 4 }, { 4, 8 }, { 8, 8 } };
+	const int count = opt.side * opt.side;
+
+	// blocks the exact carve turns to air, against a world without caves
+	long long caveBlocks = 0;
+	{
+		TerrainSettings settings;
+		const TerrainGenerator caves(settings);
+		settings.caveThreshold = 2.0;
+		const TerrainGenerator solid(settings);
+
+		ChunkData a(0, 0, false);
+		ChunkData b(0, 0, false);
+		std::vector<BlockID> carved(CHUNK_VOLUME);
+		std::vector<BlockID> uncarved(CHUNK_VOLUME);
+		for (int i = 0; i < count; ++i)
+		{
+			caves.generate(ChunkCoord{ i % opt.side, i / opt.side }, a);
+			solid.generate(ChunkCoord{ i % opt.side, i / opt.side }, b);
+			a.copyBlocks(carved.data());
+			b.copyBlocks(uncarved.data());
+			for (int k = 0; k < CHUNK_VOLUME; ++k)
+			{
+				caveBlocks += (carved[k] == BlockID::Air && uncarved[k] != BlockID::Air) ? 1 : 0;
+			} // end for
+		} // end for
+	}
+
+	std::vector<std::vector<BlockID>> exact;
+	double exactMs = 0.0;
+	for (const Lattice& lattice : lattices)
+	{
+		TerrainSettings settings;
+		settings.caveLatticeXZ = lattice.xz;
+		settings.caveLatticeY = lattice.y;
+		const TerrainGenerator terrain(settings);
+
+		ChunkData chunk(0, 0, false);
+		std::vector<std::vector<BlockID>> blocks(count, std::vector<BlockID>(CHUNK_VOLUME));
+		double ms = 0.0;
+		for (int i = 0; i < count; ++i)
+		{
+			auto start = Clock::now();
+			terrain.generate(ChunkCoord{ i % opt.side, i / opt.side }, chunk);
+			ms += ElapsedMs(start);
+			chunk.copyBlocks(blocks[i].data());
+		} // end for
+
+		const std::string name = "caves." + std::to_string(lattice.xz) + "x" + std::to_string(lattice.y);
+		if (exact.empty())
+		{
+			exact = std::move(blocks);
+			exactMs = ms;
+			std::printf("%-32s %10.0f chunks/sec  (per block)\n", name.c_str(), 1000.0 * count / ms);
+			Record(opt, name + "_throughput", 1000.0 * count / ms, "chunks/s");
+			continue;
+		}
+
+		long long changed = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			for (int b = 0; b < CHUNK_VOLUME; ++b)
+			{
+				changed += (blocks[i][b] != exact[i][b]) ? 1 : 0;
+			} // end for
+		} // end for
+
+		const double deviation = (caveBlocks > 0) ? 100.0 * changed / caveBlocks : 0.0;
+		std::printf("%-32s %10.0f chunks/sec  (%.2fx, %lld blocks differ, %.1f%% of cave volume)\n", name.c_str(),
+			1000.0 * count / ms, exactMs / ms, changed, deviation);
+		Record(opt, name + "_throughput", 1000.0 * count / ms, "chunks/s");
+		Record(opt, name + "_deviation", deviation, "%");
+	} // end for
+} // end of BenchCaves()
+
+// headless chunk generation throughput, then every block of chunks [0, 8)^2
+// against the hash the original column by column generator produced
+static void BenchGenerate(BenchOptions& opt)
+{
+	const int count = opt.side * opt.side;
+	const TerrainGenerator& terrain = TerrainGenerator::standard();
+
+	ChunkData chunk(0, 0, false);
+	auto start = Clock::now();
+	for (int i = 0; i < count; ++i)
+	{
+		terrain.generate(ChunkCoord{ i % opt.side, i / opt.side }, chunk);
+	} // end for
+	const double ms = ElapsedMs(start);
+	ReportPerChunk(opt, "generate.chunk", ms, count);
+	Record(opt, "generate.throughput", 1000.0 * count / ms, "chunks/s");
+
+	uint64_t h = 14695981039346656037ull;
+	std::vector<BlockID> blocks(CHUNK_VOLUME);
+	for (int cz = 0; cz < 8; ++cz)
+	{
+		for (int cx = 0; cx < 8; ++cx)
+		{
+			terrain.generate(ChunkCoord{ cx, cz }, chunk);
+			chunk.copyBlocks(blocks.data());
+			for (BlockID id : blocks)
+			{
+				h ^= static_cast<uint64_t>(id);
+				h *= 1099511628211ull;
+			} // end for
+		} // end for
+	} // end for
+
+	const bool golden = h == 0x62c166e89105b4dcull;
+	std::printf("%-32s %10s  (block hash %016llx)\n", "generate.golden_blocks",
+		golden ? "yes" : "NO", static_cast<unsigned long long>(h));
+	if (!golden)
+	{
+		Fail(opt, "generated blocks MISMATCH");
+	}
+} // end of BenchGenerate()
+
+// opaque + water index count of every chunk inside radius - 1 (all four
+// neighbours resident), keyed by (cx << 32) ^ cz
+static std::unordered_map<int64_t, uint32_t> InteriorIndexCounts(ChunkManager& world, int radius)
+{
+	world.enableFrustumCulling(false);
+	world.enableDistanceCulling(false);
+
+	std::unordered_map<int64_t, uint32_t> counts;
+	const ChunkDrawList& list = world.opaqueDrawListFor(glm::mat4(1.0f), glm::mat4(1.0f));
+	for (const ChunkDrawItem& item : list.items)
+	{
+		const int cx = static_cast<int>(std::floor(item.chunkOrigin.x / CHUNK_SIZE));
+		const int cz = static_cast<int>(std::floor(item.chunkOrigin.z / CHUNK_SIZE));
+		if (std::abs(cx) < radius && std::abs(cz) < radius)
+		{
+			counts[(static_cast<int64_t>(cx) << 32) ^ static_cast<uint32_t>(cz)] = item.opaqueIndexCount + item.waterIndexCount;
+		}
+	} // end for
+
+	world.enableFrustumCulling(true);
+	world.enableDistanceCulling(true);
+	return counts;
+} // end of InteriorIndexCounts()
+
+// entering a world: the uncached sessions generate every chunk, the cold
+// one generates too and fills the generated chunk cache as the chunks
+// unload, the warm ones load unmodified chunks from it. uncached and warm
+// are the median of 3 sessions. cached chunks are compared block for block
+// against fresh generation, warm meshes against the uncached ones
+static void BenchEntry(BenchOptions& opt)
+{
+	const int radius = std::clamp(opt.radii.front(), MIN_RADIUS, MAX_RADIUS);
+	const int count = (2 * radius + 1) * (2 * radius + 1);
+	const glm::vec3 cameraPos{ CHUNK_SIZE * 0.5f, 200.0f, CHUNK_SIZE * 0.5f };
+	const int repeats = 3;
+
+	WorldSettings settings;
+	settings.name = opt.worldName;
+	const std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / settings.name;
+
+	// a cache of an older generator version, dropped when caching starts
+	const std::filesystem::path staleCache = worldDir / "generated" / "0_v0_00000000";
+
+	std::filesystem::remove_all(worldDir);
+
+	// meshes with every neighbour resident, the warm sessions must match
+	std::unordered_map<int64_t, uint32_t> generatedCounts;
+	std::vector<double> uncachedMs;
+	for (int i = 0; i < repeats; ++i)
+	{
+		ChunkManager world(radius, -1, settings);
+		world.init();
+		uncachedMs.push_back(StreamWorld(world, cameraPos, radius));
+		if (world.getLoadedChunkCount() != static_cast<size_t>(count))
+		{
+			Fail(opt, "world did not finish streaming");
+		}
+		generatedCounts = InteriorIndexCounts(world, radius);
+	} // end for
+	ReportPerChunk(opt, "entry.uncached", Median(uncachedMs), count);
+
+	settings.cacheGenerated = true;
+	std::filesystem::create_directories(staleCache);
+	{
+		ChunkManager world(radius, -1, settings);
+		world.init();
+		ReportPerChunk(opt, "entry.cold", StreamWorld(world, cameraPos, radius), count);
+
+		const bool staleRemoved = !std::filesystem::exists(staleCache);
+		std::printf("%-32s %10s\n", "entry.stale_cache_removed", staleRemoved ? "yes" : "NO");
+		if (!staleRemoved)
+		{
+			Fail(opt, "stale generated chunk cache was kept");
+		}
+
+		// walk away so the generated chunks unload into the cache
+		const glm::vec3 away = cameraPos + glm::vec3((4 * radius + 2) * CHUNK_SIZE, 0.0f, 0.0f);
+		StreamWorld(world, away, radius);
+		world.flushWorld();
+	}
+
+	std::vector<double> warmMs;
+	int meshMismatches = 0;
+	for (int i = 0; i < repeats; ++i)
+	{
+		ChunkManager world(radius, -1, settings);
+		world.init();
+		warmMs.push_back(StreamWorld(world, cameraPos, radius));
+
+		// borders read from the cache give the meshes of resident neighbours
+		const std::unordered_map<int64_t, uint32_t> counts = InteriorIndexCounts(world, radius);
+		if (counts != generatedCounts)
+		{
+			++meshMismatches;
+		}
+
+		if (i == 0)
+		{
+			int mismatches = 0;
+			ChunkData chunk(0, 0, false);
+			for (int cz = -2; cz <= 2; ++cz)
+			{
+				for (int cx = -2; cx <= 2; ++cx)
+				{
+					world.getTerrain().generate(ChunkCoord{ cx, cz }, chunk);
+					bool same = true;
+					for (int y = 0; y < CHUNK_SIZE_Y && same; ++y)
+					{
+						for (int z = 0; z < CHUNK_SIZE && same; ++z)
+						{
+							for (int x = 0; x < CHUNK_SIZE && same; ++x)
+							{
+								same = world.getBlock(cx * CHUNK_SIZE + x, y, cz * CHUNK_SIZE + z) == chunk.getBlockID(x, y, z);
+							} // end for
+						} // end for
+					} // end for
+					mismatches += same ? 0 : 1;
+				} // end for
+			} // end for
+
+			std::printf("%-32s %10s  (%d/25 chunks match generation)\n", "entry.cache_identical",
+				mismatches == 0 ? "yes" : "NO", 25 - mismatches);
+			if (mismatches != 0)
+			{
+				Fail(opt, "cached chunks differ from generation");
+			}
+		}
+	} // end for
+	ReportPerChunk(opt, "entry.warm", Median(warmMs), count);
+
+	std::printf("%-32s %10s  (%zu interior chunks)\n", "entry.warm_meshes_identical",
+		meshMismatches == 0 ? "yes" : "NO", generatedCounts.size());
+	if (meshMismatches != 0)
+	{
+		Fail(opt, "meshes built with cached borders differ");
+	}
+
+	std::filesystem::remove_all(worldDir);
+} // end of BenchEntry()
+
+
+
+//--- MAIN ---//
+int main(int argc, char** argv)
+{
+	BenchOptions opt;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--side") == 0 && i + 1 < argc)
+		{
+			opt.side = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--radii") == 0 && i + 1 < argc)
+		{
+			opt.radii = ParseIntList(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--only") == 0 && i + 1 < argc)
+		{
+			opt.only = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			opt.jsonPath = argv[++i];
+		}
+		else
+		{
+			std::printf("usage: %s [--side N] [--radii R1,R2,...] [--json out.json]\n"
+				"       [--only load|save|storage|borders|mesher|lookup|cull|occlusion|world|stream|lod|noise|terrain|caves|generate|entry]\n", argv[0]);
+			return 1;
+		}
+	} // end for
+
+	struct Bench
+	{
+		const char* name;
+		void (*run)(BenchOptions&);
+	};
+	const Bench benches[] = {
+		{ "load", BenchChunkLoad },
+		{ "save", BenchSaveLoad },
+		{ "storage", BenchBlockStorage },
+		{ "borders", BenchBorderCulling },
+		{ "mesher", BenchMesher },
+		{ "lookup", BenchLookup },
+		{ "cull", BenchCulling },
+		{ "occlusion", BenchOcclusion },
+		{ "world", BenchWorld },
+		{ "stream", BenchStream },
+		{ "lod", BenchLod },
+		{ "noise", BenchNoise },
+		{ "terrain", BenchTerrain },
+		{ "caves", BenchCaves },
+		{ "generate", BenchGenerate },
+		{ "entry", BenchEntry },
+	};
+
+	bool ran = false;
+	for (const Bench& bench : benches)
+	{
+		if (opt.only.empty() || opt.only == bench.name)
+		{
+			bench.run(opt);
+			ran = true;
+		}
+	} // end for
+
+	if (!ran)
+	{
+		std::printf("unknown benchmark: %s\n", opt.only.c_str());
+		return 1;
+	}
+
+	if (!opt.jsonPath.empty() && !WriteJson(opt))
+	{
+		return 1;
+	}
+
+	return opt.failed ? 1 : 0;
+} // end of main()
@@ -18,6 +18,13 @@ inline constexpr float SPEED		= 7.5f;
 inline constexpr float SENSITIVITY	= 0.1f;
 inline constexpr float ZOOM			= 90.0f;
 
+// view and eye of a camera mirrored about a horizontal plane
+struct MirroredView
+{
+	glm::mat4 view;
+	glm::vec3 eye;
+};
+
 // cameracontroller class
 class Camera
 {
@@ -62,6 +69,9 @@ public:
 	// invert pitch
 	void invertPitch();
 
+	// mirrored about the plane y = planeY (water reflection)
+	MirroredView mirrored(float planeY) const;
+
 	void onResize(int w, int h);
 
 	// mouse handlers
@@ -79,6 +89,10 @@ public:
 	const glm::vec3& getCameraPosition() const;
 	void setCameraPosition(const glm::vec3& pos);
 
+	// velocity over the last update, call once per frame after movement
+	void updateVelocity(float deltaTime);
+	const glm::vec3& getCameraVelocity() const;
+
 	glm::vec3 getCameraDirection() const;
 	glm::vec3 getCameraUp() const;
 	glm::vec3 getCameraFront() const;
@@ -106,6 +120,8 @@ private:
 
 	// camera attributes
 	glm::vec3 position_{};
+	glm::vec3 lastPosition_{};
+	glm::vec3 velocity_{};
 	glm::vec3 front_{};
 	glm::vec3 up_{};
 	glm::vec3 right_{};
@@ -0,0 +1,23 @@
+#ifndef CHUNK_CODEC_H
+#define CHUNK_CODEC_H
+
+#include "constants.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// chunk block compression used by the region save format
+// stage 1: run-length encode the Y-major block array (mostly air/stone runs)
+// stage 2: LZ77 (LZ4-style block format) over the RLE stream
+namespace ChunkCodec
+{
+	void encode(const World::BlockID* blocks, size_t count, std::vector<uint8_t>& out);
+	bool decode(const uint8_t* data, size_t size, World::BlockID* blocks, size_t count);
+
+	// raw byte helpers, exposed for benchmarks
+	void compressLZ(const uint8_t* in, size_t size, std::vector<uint8_t>& out);
+	bool decompressLZ(const uint8_t* in, size_t size, std::vector<uint8_t>& out, size_t rawSize);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef CHUNK_CULL_H
+#define CHUNK_CULL_H
+
+#include "chunk_mesh_data.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Plane
+{
+	glm::vec3 n; // normal
+	float d;     // plane: dot(n, x) + d >= 0 is inside
+};
+
+struct Frustum
+{
+	Plane p[6]; // L, R, B, T, N, F
+};
+
+struct AABB
+{
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+Frustum ExtractFrustumPlanes(const glm::mat4& VP);
+bool IntersectsFrustum(const AABB& box, const Frustum& f);
+
+// resident chunk bounds as flat arrays (one entry per chunk), swept once
+// per frame for every view
+struct ChunkCullBounds
+{
+	std::vector<float> minX, minY, minZ;
+	std::vector<float> maxX, maxY, maxZ;
+	std::vector<int> chunkX, chunkZ;
+
+	size_t size() const { return chunkX.size(); }
+	void clear();
+	void push(int cx, int cz, const AABB& box);
+
+	AABB box(size_t i) const
+	{
+		return { { minX[i], minY[i], minZ[i] }, { maxX[i], maxY[i], maxZ[i] } };
+	}
+};
+
+// frustum test of every box in bounds, bit i of outVisible[i / 64] is set
+// when box i intersects f. CullFrustum tests 8 (AVX2) or 4 (SSE2) boxes
+// per instruction with the same arithmetic as IntersectsFrustum, so both
+// give identical masks
+void CullFrustum(const ChunkCullBounds& bounds, const Frustum& f, std::vector<uint64_t>& outVisible);
+void CullFrustumScalar(const ChunkCullBounds& bounds, const Frustum& f, std::vector<uint64_t>& outVisible);
+// frustum test of the mesh sections in sectionMask, boxes are column in x/z
+// and column.min.y + the section's y extent. returns the visible sections
+uint32_t CullSections(const AABB& column, const ChunkMeshSection* sections, uint32_t sectionMask, const Frustum& f);
+// "avx2", "sse2" or "scalar"
+const char* CullFrustumPath();
+
+#endif
@@ -3,26 +3,43 @@
 
 #include "constants.h"
 
-#include <noise/noiseutils.h>
+#include "chunk_section.h"
 
 #include <array>
-#include <istream>
+#include <cstddef>
 
 using namespace World;
 
+// terrain noise evaluation, both produce identical chunks
+enum class NoisePath
+{
+	// PerlinBatch lines, a row of the height map or a cave column at a time (default)
+	Batch,
+	// libnoise GetValue() per sample, kept for benchmarks/validation
+	Reference
+};
+
 class ChunkData
 {
 public:
 	int m_chunkX;
 	int m_chunkZ;
 	bool m_dirty = false;
+	// generated this session and not written to the generated chunk cache
+	bool m_cachePending = false;
 public:
-	ChunkData(int cx, int cz);
+	// shouldGenerate == false leaves the chunk empty (all air) so a saved
+	// copy can be loaded first and generate() only runs on a save miss
+	ChunkData(int cx, int cz, bool shouldGenerate = true);
 	~ChunkData();
 
+	// the standard world terrain (TerrainGenerator::standard()), worlds
+	// with other settings generate through their own TerrainGenerator
+	void generate(NoisePath path = NoisePath::Batch);
+
 	BlockID getBlockID(int x, int y, int z) const
 	{
-		return blocks_[x + CHUNK_SIZE * (z + CHUNK_SIZE * y)];
+		return sections_[y >> 4].get(x + CHUNK_SIZE * (z + CHUNK_SIZE * (y & 15)));
 	} // end of getBlockID()
 
 	void setBlockID(int x, int y, int z, BlockID id)
@@ -34,32 +51,20 @@ public:
 			return;
 		}
 
-		setBlocks(x, y, z, id);
+		sections_[y >> 4].set(x + CHUNK_SIZE * (z + CHUNK_SIZE * (y & 15)), id);
 	} // end of setBlockID()
 
-	void loadData(std::istream& in)
-	{
-		in.read(
-			reinterpret_cast<char*>(blocks_.data()),
-			static_cast<std::streamsize>(blocks_.size() * sizeof(BlockID))
-		);
-	} // end of loadData()
+	// dense CHUNK_VOLUME arrays in x + CHUNK_SIZE * (z + CHUNK_SIZE * y) order
+	void loadData(const BlockID* data);
+	void copyBlocks(BlockID* out) const;
 
-	const std::array<BlockID, CHUNK_SIZE* CHUNK_SIZE_Y* CHUNK_SIZE>& getBlocks() const
-	{
-		return blocks_;
-	} // end of getBlocks()
+	size_t memoryUsageBytes() const;
 
 private:
-	std::array<BlockID, CHUNK_SIZE * CHUNK_SIZE_Y * CHUNK_SIZE> blocks_;
-	utils::NoiseMap heightMap_;
-	module::Perlin caveNoise_;
-private:
-	void setBlocks(int x, int y, int z, BlockID id);
-	void setupHeightMap(int cx, int cz);
-	void setupCaveNoise();
-	void carveCave(int x, int y, int z);
-	void placeTree(int x, int groundY, int z);
+	static constexpr int SECTION_COUNT = CHUNK_SIZE_Y / ChunkSection::HEIGHT;
+	static_assert(CHUNK_SIZE_Y % ChunkSection::HEIGHT == 0, "chunk height must be whole sections");
+
+	std::array<ChunkSection, SECTION_COUNT> sections_;
 };
 
 #endif
@@ -1,41 +1,60 @@
 #ifndef CHUNK_DRAW_LIST_H
 #define CHUNK_DRAW_LIST_H
 
+#include "chunk_mesh_data.h"
+#include "chunk_mesh_slots.h"
+
 #include <glm/glm.hpp>
 
-#include <memory>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
 class IChunkMeshGPU;
 
+// plain data, lists are rebuilt every frame into kept capacity without
+// touching mesh reference counts
 struct ChunkDrawItem
 {
 	glm::vec3 chunkOrigin{};
-	std::shared_ptr<IChunkMeshGPU> gpu;
+	ChunkMeshHandle mesh{};
 
 	uint32_t opaqueIndexCount = 0;
 	uint32_t waterIndexCount = 0;
+	// opaque sections to draw (ChunkMeshData::opaqueSections)
+	uint32_t opaqueSectionMask = MESH_ALL_SECTIONS;
 
 	uint32_t renderedBlockCount = 0;
 
 	uint64_t geometryVersion = 0;
 
-	bool validOpaque() const noexcept { return gpu && opaqueIndexCount > 0; }
-	bool validWater() const noexcept { return gpu && waterIndexCount > 0; }
+	bool validOpaque() const noexcept { return mesh.valid() && opaqueIndexCount > 0; }
+	bool validWater() const noexcept { return mesh.valid() && waterIndexCount > 0; }
 };
+static_assert(std::is_trivially_copyable_v<ChunkDrawItem>, "draw items are copied as plain data");
 
 struct ChunkDrawList
 {
 	std::vector<ChunkDrawItem> items;
+	// resolves item handles, set by the list's builder
+	const ChunkMeshSlots* meshes = nullptr;
 	uint32_t frameChunksRendered = 0;
 	uint32_t frameBlocksRendered = 0;
+	// opaque triangles of the drawn sections
+	uint32_t frameTrianglesRendered = 0;
+	// in the frustum but hidden behind occluders
+	uint32_t frameChunksOccluded = 0;
+
+	// the item's GPU mesh, valid until the world next streams chunks
+	IChunkMeshGPU* gpu(const ChunkDrawItem& item) const { return meshes ? meshes->get(item.mesh) : nullptr; }
 
 	void clear()
 	{
 		items.clear();
 		frameChunksRendered = 0;
 		frameBlocksRendered = 0;
+		frameTrianglesRendered = 0;
+		frameChunksOccluded = 0;
 	}
 };
 
@@ -0,0 +1,36 @@
+#ifndef CHUNK_DRAW_SORT_H
+#define CHUNK_DRAW_SORT_H
+
+#include "chunk_draw_list.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// orders draw items by distance from the eye to the chunk column center.
+// distances are quantized to 1/8 block in 16 bits and sorted by a stable
+// two pass LSD radix sort, equal keys keep their list order. the buffers
+// are kept between calls, so a warm sorter does not allocate
+class ChunkDrawSorter
+{
+public:
+	enum class Order
+	{
+		FrontToBack,
+		BackToFront
+	};
+
+	void sort(std::vector<ChunkDrawItem>& items, const glm::vec3& eye, Order order);
+
+	// the quantized distance items are sorted by
+	static uint16_t distanceKey(const ChunkDrawItem& item, const glm::vec3& eye);
+private:
+	// key << 32 | item index
+	std::vector<uint64_t> entries_;
+	std::vector<uint64_t> scratch_;
+	// source item of every slot, then the in place permutation
+	std::vector<uint32_t> order_;
+};
+
+#endif
@@ -2,47 +2,61 @@
 #define CHUNK_ENTRY_H
 
 #include "chunk_mesh.h"
+#include "chunk_mesh_slots.h"
 
-#include "chunk_mesh_gpu_gl.h"
-#include "chunk_mesh_gpu_vk.h"
+#include "i_chunk_mesh_gpu.h"
 
 #include <memory>
 #include <cstdint>
-
-class IChunkMeshGPU;
-class VulkanMain;
+#include <utility>
 
 struct ChunkEntry
 {
 	std::unique_ptr<ChunkMesh> cpu;
 	std::shared_ptr<IChunkMeshGPU> gpu;
+	// gpu's handle in the manager's ChunkMeshSlots, for draw lists
+	ChunkMeshHandle gpuHandle{};
 
 	uint64_t geometryVersion = 0;
 
-	ChunkEntry(int chunkX, int chunkZ, VulkanMain* vk)
+	// bumped when the blocks or a neighbour border this chunk meshes
+	// against change, re-mesh results from older snapshots are dropped
+	uint64_t contentVersion = 0;
+	// ChunkBorders::presentMask of the current mesh
+	uint8_t meshedBorders = 0;
+	bool remeshPending = false;
+
+	ChunkEntry(std::unique_ptr<ChunkMesh> mesh, std::shared_ptr<IChunkMeshGPU> gpuMesh)
+		: cpu(std::move(mesh)), gpu(std::move(gpuMesh))
 	{
-		cpu = std::make_unique<ChunkMesh>(chunkX, chunkZ, false);
-
-		if (vk)
-		{
-			gpu = std::make_shared<ChunkMeshGPUVk>(*vk);
-		}
-		else
-		{
-			gpu = std::make_shared<ChunkMeshGPUGL>();
-		}
 	} // end of constructor
 
-	void rebuildCPU() const
+	void rebuildCPU(const ChunkBorders* borders)
 	{
-		cpu->rebuild();
+		cpu->rebuild(borders);
+		meshedBorders = borders ? borders->presentMask : 0;
 	} // end of rebuildCPU()
 
-	void uploadGPU(vk::CommandBuffer cmd)
+	void uploadGPU(GPUCommandContext context)
 	{
-		gpu->upload(cmd, cpu->data());
+		gpu->upload(context, cpu->data());
 		++geometryVersion;
 	} // end of uploadGPU()
 };
 
+// far terrain chunk (ChunkLodMesher), only the GPU mesh is kept
+struct ChunkLodEntry
+{
+	std::shared_ptr<IChunkMeshGPU> gpu;
+	ChunkMeshHandle gpuHandle{};
+	int step = 0;
+
+	uint32_t opaqueIndexCount = 0;
+	// chunk local y extent
+	float minY = 0.0f;
+	float maxY = -1.0f;
+
+	uint64_t geometryVersion = 0;
+};
+
 #endif
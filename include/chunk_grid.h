@@ -0,0 +1,168 @@
+#ifndef CHUNK_GRID_H
+#define CHUNK_GRID_H
+
+#include "chunk_mesh.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// floor division/modulo for negative world and chunk coordinates
+inline int FloorDiv(int v, int d)
+{
+	int q = v / d;
+	return q - ((v % d != 0) & ((v < 0) != (d < 0)));
+} // end of FloorDiv()
+
+inline int FloorMod(int v, int d)
+{
+	int r = v % d;
+	return r < 0 ? r + d : r;
+} // end of FloorMod()
+
+// resident chunks keyed by coordinate modulo the grid side (toroidal ring
+// buffer). the side is a power of two >= 2 * radius + 1, so any square of
+// 2 * radius + 1 chunks maps to distinct slots and the modulo is a mask.
+// chunks outside that square may share a slot with an in range chunk,
+// insert() hands the previous occupant back to the caller
+template <typename T>
+class ChunkGrid
+{
+public:
+	struct Slot
+	{
+		ChunkCoord coord{};
+		std::unique_ptr<T> value;
+	};
+
+	// skips empty slots
+	template <typename SlotT>
+	class Iterator
+	{
+	public:
+		Iterator(SlotT* slot, SlotT* end) : slot_(slot), end_(end) { skipEmpty(); }
+
+		SlotT& operator*() const { return *slot_; }
+		SlotT* operator->() const { return slot_; }
+		Iterator& operator++() { ++slot_; skipEmpty(); return *this; }
+		bool operator!=(const Iterator& other) const { return slot_ != other.slot_; }
+		bool operator==(const Iterator& other) const { return slot_ == other.slot_; }
+	private:
+		void skipEmpty() { while (slot_ != end_ && !slot_->value) ++slot_; }
+	private:
+		SlotT* slot_;
+		SlotT* end_;
+	};
+
+	explicit ChunkGrid(int radius = 0) { resize(radius, nullptr); }
+
+	int side() const { return side_; }
+	size_t size() const { return count_; }
+	bool empty() const { return count_ == 0; }
+
+	T* find(const ChunkCoord& coord) const
+	{
+		const Slot& slot = slots_[indexOf(coord)];
+		return (slot.value && slot.coord == coord) ? slot.value.get() : nullptr;
+	}
+	bool contains(const ChunkCoord& coord) const { return find(coord) != nullptr; }
+
+	// value must not be null. returns whatever occupied the slot before
+	// (a different chunk), if anything
+	std::unique_ptr<T> insert(const ChunkCoord& coord, std::unique_ptr<T> value, ChunkCoord* displacedCoord = nullptr)
+	{
+		Slot& slot = slots_[indexOf(coord)];
+		std::unique_ptr<T> displaced = std::move(slot.value);
+		if (displaced && displacedCoord)
+		{
+			*displacedCoord = slot.coord;
+		}
+
+		count_ += displaced ? 0 : 1;
+		slot.coord = coord;
+		slot.value = std::move(value);
+		return displaced;
+	}
+
+	std::unique_ptr<T> erase(const ChunkCoord& coord)
+	{
+		Slot& slot = slots_[indexOf(coord)];
+		if (!slot.value || !(slot.coord == coord))
+		{
+			return nullptr;
+		}
+		--count_;
+		return std::move(slot.value);
+	}
+
+	// rehash for a new radius, chunks that lose their slot to one nearer
+	// to center go to displaced (dropped if displaced is null)
+	void resize(int radius, const ChunkCoord* center, std::vector<Slot>* displaced = nullptr)
+	{
+		int side = 1;
+		while (side < 2 * radius + 1)
+		{
+			side <<= 1;
+		} // end while
+
+		std::vector<Slot> old = std::move(slots_);
+		slots_.clear();
+		slots_.resize(static_cast<size_t>(side) * side);
+		side_ = side;
+		mask_ = side - 1;
+		count_ = 0;
+
+		// in range chunks first, they never collide with each other
+		auto inRange = [&](const ChunkCoord& c)
+			{
+				return !center ||
+					(std::abs(c.x - center->x) <= radius && std::abs(c.z - center->z) <= radius);
+			};
+
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			for (Slot& slot : old)
+			{
+				if (!slot.value || inRange(slot.coord) != (pass == 0))
+				{
+					continue;
+				}
+
+				Slot& target = slots_[indexOf(slot.coord)];
+				if (target.value)
+				{
+					if (displaced)
+					{
+						displaced->push_back(std::move(slot));
+					}
+					continue;
+				}
+
+				target = std::move(slot);
+				++count_;
+			} // end for
+		} // end for
+	}
+
+	Iterator<Slot> begin() { return { slots_.data(), slots_.data() + slots_.size() }; }
+	Iterator<Slot> end() { return { slots_.data() + slots_.size(), slots_.data() + slots_.size() }; }
+	Iterator<const Slot> begin() const { return { slots_.data(), slots_.data() + slots_.size() }; }
+	Iterator<const Slot> end() const { return { slots_.data() + slots_.size(), slots_.data() + slots_.size() }; }
+
+private:
+	size_t indexOf(const ChunkCoord& coord) const
+	{
+		// two's complement & gives the floor modulo for negative coords
+		return static_cast<size_t>(coord.x & mask_) + static_cast<size_t>(coord.z & mask_) * side_;
+	}
+
+private:
+	std::vector<Slot> slots_;
+	int side_ = 1;
+	int mask_ = 0;
+	size_t count_ = 0;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef CHUNK_JOB_SYSTEM_H
+#define CHUNK_JOB_SYSTEM_H
+
+#include "chunk_mesh.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Save;
+class TerrainGenerator;
+
+// finished CPU work for one chunk, ready for GPU upload
+struct ChunkJobResult
+{
+	ChunkCoord coord{};
+	uint64_t ticket = 0;
+	std::unique_ptr<ChunkMesh> mesh;
+	size_t uploadBytes = 0;
+
+	// neighbour re-mesh of a resident chunk (not a fresh load)
+	bool remesh = false;
+	// ChunkEntry::contentVersion the re-mesh snapshot was taken at
+	uint64_t contentVersion = 0;
+	// ChunkBorders::presentMask the mesh was built with
+	uint8_t bordersMask = 0;
+
+	// far terrain mesh (ChunkLodMesher) instead of a chunk, mesh is null
+	std::unique_ptr<ChunkMeshData> lod;
+	int lodStep = 0;
+};
+
+// worker pool running the CPU side of chunk streaming
+// (load save or generate -> mesh) off the main thread
+class ChunkJobSystem
+{
+public:
+	// workerCount == 0 runs every job inline inside collect(),
+	// which keeps streaming fully deterministic (tests, benchmarks).
+	// workers share terrain, it must outlive the job system. chunks missing
+	// from worldName are loaded from cacheName, generated chunks are flagged
+	// m_cachePending for the chunk manager to save there (empty = no cache)
+	ChunkJobSystem(Save& save, std::string worldName, std::string cacheName, const TerrainGenerator& terrain, unsigned workerCount);
+	~ChunkJobSystem();
+
+	ChunkJobSystem(const ChunkJobSystem&) = delete;
+	ChunkJobSystem& operator=(const ChunkJobSystem&) = delete;
+
+	void submit(const ChunkCoord& coord, std::unique_ptr<ChunkBorders> borders);
+	// re-mesh a copy of resident chunk data against new neighbour borders
+	void submitRemesh(const ChunkData& data, std::unique_ptr<ChunkBorders> borders, uint64_t contentVersion);
+	// read the save region holding coord into the save's cache, no result
+	void submitPrefetch(const ChunkCoord& coord);
+	// far terrain mesh of coord at step blocks per cell
+	void submitLod(const ChunkCoord& coord, int step);
+
+	// drop load jobs that have not started yet (re-mesh and LOD jobs are kept)
+	void cancelQueued(std::vector<ChunkCoord>& outCancelled);
+
+	// move finished results to out (sorted by submit order)
+	void collect(std::vector<ChunkJobResult>& out);
+
+	// block until every submitted job has finished
+	void waitIdle();
+
+	size_t inFlight() const;
+	unsigned workerCount() const { return static_cast<unsigned>(workers_.size()); }
+
+	static unsigned defaultWorkerCount();
+
+private:
+	struct Job
+	{
+		uint64_t ticket = 0;
+		ChunkCoord coord{};
+		std::unique_ptr<ChunkBorders> borders;
+
+		// set for re-mesh jobs, otherwise load/generate
+		std::unique_ptr<ChunkData> data;
+		uint64_t contentVersion = 0;
+
+		// region prefetch, produces no result
+		bool prefetch = false;
+		// set for far terrain jobs
+		int lodStep = 0;
+	};
+private:
+	void workerLoop();
+	ChunkJobResult runJob(Job& job) const;
+	// world save first, then the generated chunk cache
+	bool loadStored(const ChunkCoord& coord, ChunkData& out) const;
+	// borders of neighbours missing from borders that are stored on disk
+	void fillStoredBorders(const ChunkCoord& coord, ChunkBorders& borders) const;
+	void prefetch(const ChunkCoord& coord) const;
+private:
+	Save& save_;
+	std::string worldName_;
+	std::string cacheName_;
+	const TerrainGenerator& terrain_;
+
+	std::vector<std::thread> workers_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable jobReady_;
+	std::condition_variable jobDone_;
+
+	std::deque<Job> jobs_;
+	std::vector<ChunkJobResult> results_;
+	size_t running_{ 0 };
+	uint64_t nextTicket_{ 0 };
+	bool stopping_{ false };
+};
+
+#endif
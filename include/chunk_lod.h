@@ -0,0 +1,39 @@
+#ifndef CHUNK_LOD_H
+#define CHUNK_LOD_H
+
+#include "chunk_mesh.h"
+#include "chunk_mesh_data.h"
+
+#include <array>
+
+class TerrainGenerator;
+struct TerrainSettings;
+
+// far terrain beyond the full detail view radius. a LOD chunk is the surface
+// of one chunk column built straight from the terrain height noise (no
+// blocks, caves, trees or 3D generation), as flat cells of step x step
+// blocks at the height of their center column. meshes use the regular
+// chunk vertex format, so the opaque pipelines draw them unchanged.
+// far water is an opaque water tile surface
+class ChunkLodMesher
+{
+public:
+	// cell size per level in blocks, steps divide CHUNK_SIZE since vertex
+	// x/z are chunk local
+	static constexpr int LEVEL_COUNT = 3;
+	static constexpr std::array<int, LEVEL_COUNT> STEPS = { 3, 5, 15 };
+	// chunk borders get skirts down to below the lowest ground the settings
+	// can produce (octave o adds at most persistence^o), neighbours at
+	// another step or full detail chunks never leave a crack
+	static int skirtBottom(const TerrainSettings& settings);
+
+	// step of a chunk dist2 (squared chunk distance) from the camera, each
+	// level reaches twice as far as the one before, the first to twice the
+	// view radius
+	static int stepFor(int dist2, int viewRadius);
+
+	// out is cleared first
+	static void build(const TerrainGenerator& terrain, const ChunkCoord& coord, int step, ChunkMeshData& out);
+};
+
+#endif
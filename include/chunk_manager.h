@@ -5,23 +5,34 @@
 
 #include "save.h"
 
+#include "chunk_cull.h"
 #include "chunk_draw_list.h"
+#include "chunk_draw_sort.h"
+#include "chunk_grid.h"
+#include "chunk_job_system.h"
 #include "chunk_mesh.h"
+#include "chunk_occlusion.h"
+#include "chunk_stream_queue.h"
+#include "gpu_command_context.h"
+#include "terrain_generator.h"
 
 #include <glm/glm.hpp>
 
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <string>
 #include <cstdint>
 #include <vector>
 #include <algorithm>
 
 struct ChunkEntry;
+struct ChunkLodEntry;
 struct ChunkDrawList;
-class VulkanMain;
-struct FrameContext;
+class IChunkMeshGPU;
 
 using namespace World;
 
@@ -32,14 +43,72 @@ struct BlockHit
 	glm::ivec3 normal{};
 };
 
+// GPU residency for chunk meshes, supplied by the renderer.
+// an empty factory uses the null backend (headless world)
+struct ChunkGPUBackend
+{
+	std::function<std::shared_ptr<IChunkMeshGPU>()> create;
+	// uploads are recorded into a command context (vulkan), ready chunks
+	// wait on frames that do not pass one
+	bool needsCommandContext = false;
+};
+
+// a world is its name (save folder under SAVE_PATH) and terrain. generated
+// chunks can be cached under the name, seed and generator version, chunks
+// that were never modified then load from the cache in later sessions.
+// cache entries are written when a generated chunk unloads
+struct WorldSettings
+{
+	std::string name = "HelloWorld";
+	TerrainSettings terrain;
+	bool cacheGenerated = false;
+};
+
+// one camera of the frame for ChunkManager::cullFrameViews()
+struct ChunkCullView
+{
+	enum Lists : uint32_t
+	{
+		Opaque = 1u << 0,
+		Water = 1u << 1,
+		// chunks with opaque or water geometry (RT)
+		Combined = 1u << 2,
+		// far terrain LOD chunks (frustum views only)
+		Lod = 1u << 3
+	};
+
+	glm::mat4 view{ 1.0f };
+	glm::mat4 proj{ 1.0f };
+	uint32_t lists = Opaque;
+	// false = distance culling only
+	bool frustum = true;
+	// also test against the solid sections of nearby chunks (OcclusionBuffer).
+	// meant for the camera, one view per sweep, never applied to Combined
+	bool occlusion = false;
+};
+
+struct ChunkViewLists
+{
+	ChunkDrawList opaque;
+	ChunkDrawList water;
+	ChunkDrawList combined;
+	ChunkDrawList lod;
+};
+
 class ChunkManager
 {
 public:
-	ChunkManager(int viewRadiusInChunks = 15);
+	// workerThreads < 0 picks a count from the hardware,
+	// workerThreads == 0 streams inline on the calling thread (deterministic),
+	// world.terrain generates every chunk missing from the save (and cache)
+	ChunkManager(int viewRadiusInChunks = 15, int workerThreads = -1, const WorldSettings& world = {});
 	~ChunkManager();
 
-	void init(VulkanMain* vk);
-	void updateDynamic(const glm::vec3& cameraPos, FrameContext* frame = nullptr);
+	void init(ChunkGPUBackend gpuBackend = {});
+	void updateDynamic(const glm::vec3& cameraPos, GPUCommandContext uploadContext = {});
+	// camera velocity (blocks per second) and look direction, streaming
+	// loads chunks along the predicted path first. call before updateDynamic()
+	void setCameraMotion(const glm::vec3& velocity, const glm::vec3& forward);
 
 	bool buildVisibleChunkBounds(
 		glm::vec3& outMin,
@@ -47,47 +116,100 @@ public:
 		int paddingChunks = 1
 	);
 
+	// culls every view of the frame in one sweep over the chunk bounds.
+	// draw list requests later in the frame for one of these views return
+	// the cached lists, other views are culled on demand.
+	// cleared by updateDynamic()
+	void cullFrameViews(const std::vector<ChunkCullView>& views);
+
 	void buildRTDrawList(
 		const glm::mat4& view,
 		const glm::mat4& proj
 	);
 
-	void buildOpaqueDrawList(
-		const glm::mat4& view, 
-		const glm::mat4& proj, 
-		ChunkDrawList& out
+	// valid until the next draw list request
+	const ChunkDrawList& opaqueDrawListFor(
+		const glm::mat4& view,
+		const glm::mat4& proj
 	);
-	void buildOpaqueDrawList(
-		const glm::mat4& view, 
+	const ChunkDrawList& waterDrawListFor(
+		const glm::mat4& view,
+		const glm::mat4& proj
+	);
+	// opaque chunks the light sees, view/proj is the light ortho fitted
+	// around buildVisibleChunkBounds()
+	const ChunkDrawList& shadowDrawListFor(
+		const glm::mat4& view,
+		const glm::mat4& proj
+	);
+	// far terrain of the view, drawn with the opaque pipelines after the
+	// opaque list
+	const ChunkDrawList& lodDrawListFor(
+		const glm::mat4& view,
 		const glm::mat4& proj
 	);
 
-	void buildWaterDrawList(
+	void buildOpaqueDrawList(
 		const glm::mat4& view, 
 		const glm::mat4& proj, 
 		ChunkDrawList& out
 	);
 	void buildWaterDrawList(
 		const glm::mat4& view, 
-		const glm::mat4& proj
+		const glm::mat4& proj, 
+		ChunkDrawList& out
 	);
 
 	BlockID getBlock(int wx, int wy, int wz) const;
 	void setBlock(int wx, int wy, int wz, BlockID id);
 	void placeOrRemoveBlock(bool shouldPlace, const glm::vec3& origin, const glm::vec3& dir);
+	// non-blocking, dirty chunks are handed to the save thread
 	void saveWorld();
+	// saveWorld() and wait until everything is on disk
+	void flushWorld();
 
 	void setLastBlockUsed(BlockID block) { lastBlockUsed_ = block; }
 	int getViewRadius() const { return viewRadius_; }
-	void setViewRadius(int r) { viewRadius_ = std::clamp(r, MIN_RADIUS, MAX_RADIUS); }
+	const TerrainGenerator& getTerrain() const { return terrain_; }
+	const std::string& getWorldName() const { return worldName_; }
+	void setViewRadius(int r);
 
 	const glm::vec3& getLastCameraPos() const { return lastCameraPos_; }
 
+	// far terrain out to this radius (chunks), a radius at or below the
+	// view radius turns it off
+	int getLodRadius() const { return lodRadius_; }
+	void setLodRadius(int r);
+	size_t getLodChunkCount() const { return lodChunks_.size(); }
+
+	// seconds of camera movement the stream queue looks ahead, 0 loads
+	// the nearest chunks first
+	float getStreamLookahead() const { return streamLookahead_; }
+	void setStreamLookahead(float seconds) { streamLookahead_ = std::max(0.0f, seconds); }
+	// save regions read ahead of the predicted path so far
+	uint32_t getRegionsPrefetched() const { return regionsPrefetched_; }
+
+	size_t getUploadBudgetBytes() const { return uploadBudgetBytes_; }
+	void setUploadBudgetBytes(size_t bytes) { uploadBudgetBytes_ = std::max<size_t>(1, bytes); }
+
+	bool isChunkLoaded(int cx, int cz) const { return chunks_.contains({ cx, cz }); }
+	size_t getLoadedChunkCount() const { return chunks_.size(); }
+	bool isStreamingIdle() const;
+	void waitForStreamingJobs();
+
 	float getAmbientStrength() const { return ambientStrength_; }
 	void setAmbientStrength(float strength) { ambientStrength_ = std::clamp(strength, MIN_AMBSTR, MAX_AMBSTR); }
 
 	uint32_t getFrameChunksRendered() const { return frameChunksRendered_; }
 	uint32_t getFrameBlocksRendered() const { return frameBlocksRendered_; }
+	uint32_t getFrameTrianglesRendered() const { return frameTrianglesRendered_; }
+	uint32_t getFrameChunksOccluded() const { return frameChunksOccluded_; }
+	uint32_t getFrameLodChunksRendered() const { return frameLodChunksRendered_; }
+	uint32_t getFrameLodTrianglesRendered() const { return frameLodTrianglesRendered_; }
+	// cull and sort time of the last draw list build
+	float getFrameDrawListMs() const { return frameDrawListMs_; }
+	// chunks whose distance membership was recomputed this frame
+	uint32_t getFrameChunksReevaluated() const { return frameChunksReevaluated_; }
 
 	bool statusFrustumCulling() const { return enableFrustumCulling_; }
 	void enableFrustumCulling(bool enable) { enableFrustumCulling_ = enable; }
@@ -95,23 +217,83 @@ public:
 	bool statusDistanceCulling() const { return enableDistanceCulling_; }
 	void enableDistanceCulling(bool enable) { enableDistanceCulling_ = enable; }
 
+	bool statusOcclusionCulling() const { return enableOcclusionCulling_; }
+	void enableOcclusionCulling(bool enable) { enableOcclusionCulling_ = enable; }
+
+	bool statusCaveCulling() const { return enableCaveCulling_; }
+	void enableCaveCulling(bool enable) { enableCaveCulling_ = enable; }
+
+	// off re-tests the distance of every chunk every sweep
+	bool statusIncrementalCulling() const { return enableIncrementalCulling_; }
+	void enableIncrementalCulling(bool enable) { enableIncrementalCulling_ = enable; }
+
 	const ChunkDrawList& getRTDrawList() const { return rtDrawList_; }
-	const ChunkDrawList& getOpaqueDrawList() const { return opaqueDrawList_; }
-	const ChunkDrawList& getWaterDrawList() const { return waterDrawList_; }
 
-private:
 	BlockHit raycastBlocks(const glm::vec3& origin, const glm::vec3& dir) const;
+private:
+	// neighbour borders for meshing (main thread, copies resident neighbours)
+	std::unique_ptr<ChunkBorders> gatherBorders(const ChunkCoord& coord) const;
+	uint8_t residentNeighborMask(const ChunkCoord& coord) const;
+	// async re-mesh when a neighbour became resident after coord was meshed
+	void remeshIfMissingBorders(const ChunkCoord& coord);
+	void requestRemesh(const ChunkCoord& coord);
+	// queue the chunks of the stream window that are not resident or queued
+	void enqueueMissingChunks();
+	// read ahead save regions the window around the predicted chunk reaches
+	void prefetchRegions(int predictedChunkX, int predictedChunkZ);
+	// queue a save and release the mesh handle of a chunk leaving the grid
+	void retireEntry(ChunkEntry& entry);
+
+	// far terrain around the camera chunk: evict, request and upload LOD
+	// chunks (their own job and upload budget)
+	void updateLod(int camChunkX, int camChunkZ, GPUCommandContext uploadContext, bool canUpload);
+	// LOD step coord should have around the camera chunk, 0 outside the ring
+	int lodStepAt(const ChunkCoord& coord, int camChunkX, int camChunkZ) const;
+	// LOD chunks of the frustum views with the Lod list, the occlusion view
+	// also tests them against occlusion_
+	void cullLod(const ChunkCullView* views, size_t viewCount, size_t occlusionView, ChunkViewLists* out);
+
+	// flat bounds of the resident chunks, rebuilt after chunks_ changed
+	void refreshCullBounds();
+	// distance membership and visible bounds, recomputed when the cull
+	// bounds, the camera chunk or the distance settings changed
+	void refreshCullRange(int camChunkX, int camChunkZ);
+	// single sweep over the cull bounds, out[i] gets the lists of views[i]
+	void cullViews(const ChunkCullView* views, size_t viewCount, ChunkViewLists* out);
+	// rasterizes the occluders of view into occlusion_
+	void buildOcclusion(const ChunkCullView& view, const std::vector<uint64_t>& visible, const glm::vec3& eye);
+	// walk the section connectivity from the eye's section through the
+	// frustum. false when it does not apply (eye outside the world or
+	// chunk, walk over budget), then nothing is cave culled
+	bool traverseCaves(const Frustum& frustum, const glm::vec3& eye);
+	// sections reached by the last traverseCaves()
+	uint32_t caveSections(const ChunkCoord& coord) const;
+	const ChunkViewLists* findFrameView(const glm::mat4& view, const glm::mat4& proj, uint32_t lists) const;
+	// one view culled into scratchLists_
+	ChunkViewLists& cullSingleView(const ChunkCullView& view);
+	void countRendered(const ChunkDrawList& list);
 private:
 	float ambientStrength_{ MIN_AMBSTR };
 	Save saveWorld_;
+	// shared by the streaming workers, declared before jobSystem_
+	TerrainGenerator terrain_;
 
 	// culling toggles 
 	bool enableFrustumCulling_ = true;
 	bool enableDistanceCulling_ = true;
+	// off by default, costs more cull time than it saves at surface views
+	bool enableOcclusionCulling_ = false;
+	bool enableCaveCulling_ = true;
+	bool enableIncrementalCulling_ = true;
 
 	// count
 	uint32_t frameChunksRendered_{ 0 };
 	uint32_t frameBlocksRendered_{ 0 };
+	uint32_t frameTrianglesRendered_{ 0 };
+	uint32_t frameChunksOccluded_{ 0 };
+	uint32_t frameChunksReevaluated_{ 0 };
+	uint32_t frameLodChunksRendered_{ 0 };
+	uint32_t frameLodTrianglesRendered_{ 0 };
 
 	glm::vec3 lastCameraPos_{};
 
@@ -121,18 +303,131 @@ private:
 	int streamRecenterThreshold_{ 0 };
 
 	int viewRadius_;
-	std::unordered_map<ChunkCoord, std::unique_ptr<ChunkEntry>, ChunkCoordHash> chunks_;
-	std::queue<ChunkCoord> pendingChunks_;
+	std::string worldName_;
+	// generated chunk cache folder, empty when not caching
+	std::string cacheName_;
+	// resident chunks, toroidal grid around the stream center
+	ChunkGrid<ChunkEntry> chunks_;
+
+	// requested but not yet resident (pending, in flight or ready)
+	ChunkStreamQueue pendingChunks_;
 	std::unordered_set<ChunkCoord, ChunkCoordHash> queuedChunks_;
+	std::vector<ChunkCoord> droppedChunks_;
+	// window last enqueued, dirty after a radius change
+	ChunkCoord enqueuedCenter_{};
+	bool streamWindowDirty_{ true };
+
+	// stream prediction
+	glm::vec3 cameraVelocity_{};
+	glm::vec3 cameraForward_{};
+	float streamLookahead_{ 2.0f };
+	std::vector<RegionCoord> prefetchedRegions_;
+	static constexpr size_t maxPrefetchedRegions_ = 64;
+	uint32_t regionsPrefetched_{ 0 };
+
+	// far terrain, LOD chunks from inside the view radius (they stand in
+	// for chunks still streaming) out to lodRadius_, off for headless worlds
+	int lodRadius_{ 0 };
+	ChunkGrid<ChunkLodEntry> lodChunks_;
+	// camera chunk the ring was last scanned around, dirty after a radius change
+	ChunkCoord lodCenter_{};
+	bool lodDirty_{ true };
+	struct LodRequest
+	{
+		int dist2;
+		ChunkCoord coord;
+		int step;
+	};
+	// missing or at another step, nearest last
+	std::vector<LodRequest> lodRequests_;
+	// submitted jobs, coord -> step
+	std::unordered_map<ChunkCoord, int, ChunkCoordHash> lodQueued_;
+	std::deque<ChunkJobResult> readyLods_;
+	size_t lodInFlight_{ 0 };
+	size_t maxLodJobsInFlight_{ 0 };
+	static constexpr int lodOverlap_ = 2;
+	static constexpr int maxLodUploadsPerFrame_ = 32;
+
+	// streaming jobs
+	std::unique_ptr<ChunkJobSystem> jobSystem_;
+	std::deque<ChunkJobResult> readyChunks_;
+	std::vector<ChunkJobResult> collectedChunks_;
+	size_t maxJobsInFlight_{ 0 };
+	size_t uploadBudgetBytes_{ 8u * 1024u * 1024u };
 
 	std::queue<ChunkCoord> dirtyChunks_;
 	std::unordered_set<ChunkCoord, ChunkCoordHash> queuedDirtyChunks_;
 
-	VulkanMain* vk_{ nullptr };
+	// in flight loads whose neighbour border was edited after submit
+	std::unordered_set<ChunkCoord, ChunkCoordHash> staleBorderChunks_;
+	// missing borders, re-mesh waits until queued neighbours arrive
+	std::unordered_set<ChunkCoord, ChunkCoordHash> deferredRemesh_;
+
+	ChunkGPUBackend gpuBackend_;
 
 	ChunkDrawList rtDrawList_{};
-	ChunkDrawList opaqueDrawList_{};
-	ChunkDrawList waterDrawList_{};
+
+	// culling input, cullEntries_[i] owns cullBounds_ entry i
+	ChunkCullBounds cullBounds_;
+	std::vector<ChunkEntry*> cullEntries_;
+	// bit i is set when cull bounds entry i has geometry and is within
+	// the view radius of cullRangeChunk_
+	std::vector<uint64_t> cullInRange_;
+	bool cullRangeDirty_{ true };
+	ChunkCoord cullRangeChunk_{};
+	int cullRangeRadius_{ 0 };
+	bool cullRangeDistance_{ true };
+	// per view frustum visibility bits, one per cull bounds entry
+	std::vector<std::vector<uint64_t>> cullVisible_;
+	// in range and visible to any view, the entries the sweep visits
+	std::vector<uint64_t> cullSweep_;
+	// per view planes for the section tests of visible chunks
+	std::vector<Frustum> cullFrustums_;
+	// depth of the occlusion view's occluders
+	OcclusionBuffer occlusion_;
+	// chunks this close to the camera contribute occluders
+	static constexpr int occluderRadius_ = 6;
+
+	// cave culling, sections reached from the camera per chunk slot
+	// (same toroidal layout as chunks_), valid when stamp == caveStamp_
+	struct CaveSlot
+	{
+		ChunkCoord coord{};
+		uint32_t stamp = 0;
+		uint32_t sections = 0;
+	};
+	struct CaveNode
+	{
+		int chunkX;
+		int chunkZ;
+		int section;
+		int8_t entryFace;
+		uint8_t directions;
+	};
+	std::vector<CaveSlot> caveGrid_;
+	std::vector<CaveNode> caveQueue_;
+	int caveSide_{ 0 };
+	uint32_t caveStamp_{ 0 };
+	static constexpr size_t caveSectionBudget_ = 16384;
+
+	// opaque lists front to back (early z), water back to front (blending)
+	ChunkDrawSorter drawSorter_;
+	// handles of the resident GPU meshes, draw items refer to these
+	ChunkMeshSlots meshSlots_;
+	float frameDrawListMs_{ 0.0f };
+	bool cullBoundsDirty_{ true };
+
+	// this frame's views and lists from cullFrameViews()
+	std::vector<ChunkCullView> frameViews_;
+	std::vector<ChunkViewLists> frameLists_;
+	ChunkViewLists scratchLists_{};
+	// view of scratchLists_, no lists once the frame is over
+	ChunkCullView scratchView_{ glm::mat4(1.0f), glm::mat4(1.0f), 0 };
+	// bounds of the in range chunks (buildVisibleChunkBounds)
+	bool frameBoundsValid_{ false };
+	bool frameBoundsAny_{ false };
+	glm::vec3 frameBoundsMin_{};
+	glm::vec3 frameBoundsMax_{};
 
 	// raycast data
 	BlockID lastBlockUsed_;
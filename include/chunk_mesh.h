@@ -70,6 +70,39 @@ enum class FaceDir : int {
     PosZ, NegZ
 };
 
+// world opaque vertices
+// LAYOUT (32u bits)
+// 0  - 1   : UV corner index
+// 2  - 6   : tileY
+// 7  - 11  : tileX
+// 12 - 14  : normal index
+// 15 - 18  : x pos
+// 19 - 27  : y pos
+// 28 - 31  : z pos
+inline uint32_t PackVertexU32(
+    uint32_t uvCorner, uint32_t tileX, uint32_t tileY,
+    uint32_t normalIdx, uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t packed{};
+    // uv corner index
+    packed |= (uvCorner & 3u) << 0;
+
+    // UV tileY
+    packed |= (tileY & 31u) << 2;
+    // UV tileX
+    packed |= (tileX & 31u) << 7;
+
+    // normal index
+    packed |= (normalIdx & 7u) << 12;
+
+    // pos
+    packed |= (x & 15u) << 15;
+    packed |= (y & 511u) << 19;
+    packed |= (z & 15u) << 28;
+
+    return packed;
+} // end of PackVertexU32()
+
 // helper for when texture is flipped vertically
 inline int tileYFromTop(int rowFromTop) 
 {
@@ -96,35 +129,83 @@ struct ChunkCoordHash
 };
 
 
+// border slices of the four horizontal neighbours, read-only mesher input
+// so faces against solid neighbour blocks are culled. sides that are not
+// present (neighbour not loaded) are treated as air
+struct ChunkBorders
+{
+    enum Side : int { NegX, PosX, NegZ, PosZ, SIDE_COUNT };
+
+    // [side][y * CHUNK_SIZE + i], i runs along the shared edge
+    // (z for the X sides, x for the Z sides)
+    std::array<std::array<BlockID, CHUNK_SIZE_Y * CHUNK_SIZE>, SIDE_COUNT> blocks{};
+    uint8_t presentMask = 0;
+
+    // copy the slice of neighbour touching this chunk on side
+    void capture(Side side, const ChunkData& neighbor);
+    bool has(Side side) const { return (presentMask >> side) & 1u; }
+
+    static Side opposite(Side side) { return static_cast<Side>(side ^ 1); }
+    static ChunkCoord neighborOf(const ChunkCoord& coord, Side side);
+};
+
+// opaque mesher implementation, both produce identical output
+enum class MeshPath
+{
+    // bitmask slices + tile lookup table (default)
+    Bitmask,
+    // original per-cell mask greedy mesher, kept for benchmarks/validation
+    Reference
+};
+
 class ChunkMesh
 {
 public:
     ChunkMesh(
         int chunkX, 
         int chunkZ, 
-        bool autoBuild = true
+        bool autoBuild = true,
+        bool generate = true
     );
+    // mesh an existing copy of chunk data (neighbour re-mesh jobs)
+    explicit ChunkMesh(const ChunkData& data);
     ~ChunkMesh();
 
     void setBlock(int x, int y, int z, BlockID id) { chunkData_.setBlockID(x, y, z, id); }
     BlockID getBlock(int x, int y, int z) const { return chunkData_.getBlockID(x, y, z); }
     ChunkData& getChunk() { return chunkData_; }
-    void rebuild() { buildChunkMesh(); }
+    void rebuild(const ChunkBorders* borders = nullptr, MeshPath path = MeshPath::Bitmask) { buildChunkMesh(borders, path); }
 
     const ChunkMeshData& data() const { return data_; }
     uint32_t getRenderedBlockCount() const { return data_.renderedBlockCount; }
     int32_t opaqueIndexCount() const { return data_.opaqueIndexCount; }
     int32_t waterIndexCount() const { return data_.waterIndexCount; }
+
+    // atlas tile of a block face (face unset = the block's default tile)
+    static void getBlockTile(BlockID id, int& tileX, int& tileY, std::optional<FaceDir> face);
 private:
     ChunkData chunkData_;
     ChunkMeshData data_;
+
+    // dense block copy and neighbour borders, only valid during buildChunkMesh()
+    const BlockID* blocks_ = nullptr;
+    const ChunkBorders* borders_ = nullptr;
+    // section of each emitted opaque quad, only valid during buildChunkMesh()
+    std::vector<uint8_t>* quadSections_ = nullptr;
 private:
-	void buildChunkMesh();
+	void buildChunkMesh(const ChunkBorders* borders, MeshPath path);
+    // returns the rendered block count, computed from the same masks
+    uint32_t buildOpaqueBitmask();
+    void buildOpaqueReference();
+    void emitOpaqueQuad(
+        const glm::ivec3& p0, const glm::ivec3& p1, const glm::ivec3& p2, const glm::ivec3& p3,
+        FaceDir dir, int tileX, int tileY
+    );
+    // groups opaqueIndices into data_.opaqueSections
+    void sortOpaqueBySection(const std::vector<uint8_t>& quadSections);
+    BlockID blockAt(int x, int y, int z) const { return blocks_[x + CHUNK_SIZE * (z + CHUNK_SIZE * y)]; }
 	bool isTransparent(int x, int y, int z);
     uint32_t computeRenderedBlockCount();
-
-    // atlas
-    void getBlockTile(BlockID id, int& tileX, int& tileY, std::optional<FaceDir> face);
 };
 
 #endif
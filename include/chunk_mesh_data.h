@@ -3,8 +3,82 @@
 
 #include "constants.h"
 
+#include <array>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+
+// opaque indices of one 16 block section (by the lowest y of each quad),
+// drawn as [firstIndex, firstIndex + indexCount)
+struct ChunkMeshSection
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    // chunk local y extent of the section's quads
+    float minY = 0.0f;
+    float maxY = 0.0f;
+};
+
+inline constexpr int MESH_SECTION_HEIGHT = 16;
+inline constexpr int MESH_SECTION_COUNT = World::CHUNK_SIZE_Y / MESH_SECTION_HEIGHT;
+inline constexpr uint32_t MESH_ALL_SECTIONS = (1u << MESH_SECTION_COUNT) - 1u;
+
+// section faces are numbered like FaceDir (PosX, NegX, PosY, NegY, PosZ, NegZ),
+// a face pair is one bit of ChunkMeshData::sectionConnectivity
+inline constexpr uint32_t SectionFacePair(int a, int b)
+{
+    return a < b ? 1u << (a * 6 + b) : 1u << (b * 6 + a);
+}
+inline constexpr uint32_t SectionAllFacePairs()
+{
+    uint32_t pairs = 0;
+    for (int a = 0; a < 6; ++a)
+    {
+        for (int b = a + 1; b < 6; ++b)
+        {
+            pairs |= SectionFacePair(a, b);
+        } // end for
+    } // end for
+    return pairs;
+}
+
+// index ranges covering the sections in sectionMask, neighbouring sections
+// (ignoring empty ones in between) merge into one range.
+// out arrays hold MESH_SECTION_COUNT entries, returns the range count
+inline int MeshSectionRanges(
+    const ChunkMeshSection* sections,
+    uint32_t sectionMask,
+    uint32_t* outFirst,
+    uint32_t* outCount
+)
+{
+    int ranges = 0;
+    bool open = false;
+    for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+    {
+        if (sections[s].indexCount == 0)
+        {
+            continue;
+        }
+
+        if ((sectionMask & (1u << s)) == 0)
+        {
+            open = false;
+        }
+        else if (open)
+        {
+            outCount[ranges - 1] += sections[s].indexCount;
+        }
+        else
+        {
+            outFirst[ranges] = sections[s].firstIndex;
+            outCount[ranges] = sections[s].indexCount;
+            ++ranges;
+            open = true;
+        }
+    } // end for
+    return ranges;
+} // end of MeshSectionRanges()
 
 struct ChunkMeshData
 {
@@ -13,6 +87,19 @@ struct ChunkMeshData
     std::vector<World::RTVertex> opaqueRTVertices;
     std::vector<uint32_t> opaqueIndices;
     int32_t opaqueIndexCount = 0;
+    // opaqueIndices ordered by section, bottom to top
+    std::array<ChunkMeshSection, MESH_SECTION_COUNT> opaqueSections{};
+    // bit s set when section s has opaque geometry
+    uint32_t opaqueSectionMask = 0;
+    // bit s set when every block of section s hides what is behind it
+    // (occluder for OcclusionBuffer)
+    uint32_t solidSectionMask = 0;
+    // chunk local y range [min, max) of the ground under the surface that
+    // every column fills, empty when min >= max (occluder for OcclusionBuffer)
+    uint16_t groundOccluderMinY = 0;
+    uint16_t groundOccluderMaxY = 0;
+    // per section, face pairs joined by a path through see-through blocks
+    std::array<uint32_t, MESH_SECTION_COUNT> sectionConnectivity{};
 
     // water
     std::vector<World::VertexWater> waterVertices;
@@ -21,6 +108,24 @@ struct ChunkMeshData
     int32_t waterIndexCount = 0;
 
     uint32_t renderedBlockCount = 0;
+
+    // chunk local y extent of all geometry (opaque and water),
+    // minY > maxY for an empty mesh
+    float minY = 0.0f;
+    float maxY = -1.0f;
+
+    bool hasGeometry() const { return minY <= maxY; }
+
+    // total bytes the GPU backends upload for this mesh
+    size_t uploadSizeBytes() const
+    {
+        return opaqueVertices.size() * sizeof(World::Vertex) +
+            opaqueRTVertices.size() * sizeof(World::RTVertex) +
+            opaqueIndices.size() * sizeof(uint32_t) +
+            waterVertices.size() * sizeof(World::VertexWater) +
+            waterRTVertices.size() * sizeof(World::RTVertex) +
+            waterIndices.size() * sizeof(uint32_t);
+    }
 };
 
 #endif
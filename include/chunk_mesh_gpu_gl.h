@@ -2,7 +2,9 @@
 #define CHUNK_MESH_GPU_GL_H
 
 #include "i_chunk_mesh_gpu.h"
+#include "chunk_mesh_data.h"
 
+#include <array>
 #include <cstdint>
 
 class ChunkMeshGPUGL final : public IChunkMeshGPU
@@ -12,11 +14,11 @@ public:
 	~ChunkMeshGPUGL() override;
 
 	void upload(
-        vk::CommandBuffer,
+        GPUCommandContext,
         const ChunkMeshData& data
     ) override;
-	void drawOpaque(vk::CommandBuffer cmd) override;
-	void drawWater(vk::CommandBuffer cmd) override;
+	void drawOpaque(GPUCommandContext, uint32_t sectionMask) override;
+	void drawWater(GPUCommandContext) override;
 
 private:
     // opaque
@@ -24,6 +26,7 @@ private:
     uint32_t opaqueVbo_{};
     uint32_t opaqueEbo_{};
     int32_t opaqueIndexCount_{};
+    std::array<ChunkMeshSection, MESH_SECTION_COUNT> opaqueSections_{};
 
 	// water
     uint32_t waterVao_{};
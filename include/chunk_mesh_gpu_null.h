@@ -0,0 +1,29 @@
+#ifndef CHUNK_MESH_GPU_NULL_H
+#define CHUNK_MESH_GPU_NULL_H
+
+#include "i_chunk_mesh_gpu.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// GPU backend that keeps nothing resident, for headless worlds
+// (servers, benchmarks). uploads are only counted
+class ChunkMeshGPUNull final : public IChunkMeshGPU
+{
+public:
+	void upload(
+		GPUCommandContext,
+		const ChunkMeshData& data
+	) override;
+	void drawOpaque(GPUCommandContext, uint32_t) override {}
+	void drawWater(GPUCommandContext) override {}
+
+	uint32_t getUploadCount() const { return uploadCount_; }
+	size_t getUploadedBytes() const { return uploadedBytes_; }
+
+private:
+	uint32_t uploadCount_{ 0 };
+	size_t uploadedBytes_{ 0 };
+};
+
+#endif
@@ -4,17 +4,18 @@
 #include "constants.h"
 
 #include "i_chunk_mesh_gpu.h"
+#include "chunk_mesh_data.h"
 
 #include "acceleration_structure_vk.h"
 #include "buffer_vk.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
 class VulkanMain;
-struct ChunkMeshData;
 
 class ChunkMeshGPUVk final : public IChunkMeshGPU
 {
@@ -23,11 +24,11 @@ public:
 	~ChunkMeshGPUVk() override;
 
 	void upload(
-		vk::CommandBuffer cmd,
+		GPUCommandContext context,
 		const ChunkMeshData& data
 	) override;
-	void drawOpaque(vk::CommandBuffer cmd) override;
-	void drawWater(vk::CommandBuffer cmd) override;
+	void drawOpaque(GPUCommandContext context, uint32_t sectionMask) override;
+	void drawWater(GPUCommandContext context) override;
 
 	const std::vector<World::RTVertex>& getOpaqueRTVerticesCPU() const { return opaqueRTVerticesCPU_; }
 	const std::vector<uint32_t>& getOpaqueRTIndicesCPU() const { return opaqueRTIndicesCPU_; }
@@ -73,6 +74,7 @@ private:
 	BufferVk opaqueVB_;
 	BufferVk opaqueIB_;
 	uint32_t opaqueIndexCount_{ 0 };
+	std::array<ChunkMeshSection, MESH_SECTION_COUNT> opaqueSections_{};
 
 	// water
 	BufferVk waterVB_;
@@ -0,0 +1,75 @@
+#ifndef CHUNK_MESH_SLOTS_H
+#define CHUNK_MESH_SLOTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class IChunkMeshGPU;
+
+// index + generation into ChunkMeshSlots, generation 0 is never issued
+struct ChunkMeshHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0;
+
+	bool valid() const noexcept { return generation != 0; }
+	bool operator==(const ChunkMeshHandle& other) const noexcept
+	{
+		return index == other.index && generation == other.generation;
+	}
+};
+
+// resident GPU meshes by stable handle. a released slot bumps its
+// generation, so stale handles resolve to nullptr instead of a reused
+// mesh. slots are recycled through a free list, the arrays only grow
+// when more meshes are resident than ever before
+class ChunkMeshSlots
+{
+public:
+	ChunkMeshHandle acquire(IChunkMeshGPU* mesh)
+	{
+		uint32_t index;
+		if (!free_.empty())
+		{
+			index = free_.back();
+			free_.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(meshes_.size());
+			meshes_.push_back(nullptr);
+			generations_.push_back(1);
+		}
+
+		meshes_[index] = mesh;
+		return { index, generations_[index] };
+	} // end of acquire()
+
+	void release(ChunkMeshHandle handle)
+	{
+		if (get(handle) == nullptr)
+		{
+			return;
+		}
+
+		meshes_[handle.index] = nullptr;
+		// skip 0 on wrap around
+		generations_[handle.index] = generations_[handle.index] + 1 ? generations_[handle.index] + 1 : 1;
+		free_.push_back(handle.index);
+	} // end of release()
+
+	IChunkMeshGPU* get(ChunkMeshHandle handle) const noexcept
+	{
+		return (handle.index < meshes_.size() && generations_[handle.index] == handle.generation) ?
+			meshes_[handle.index] : nullptr;
+	} // end of get()
+
+	size_t size() const { return meshes_.size() - free_.size(); }
+private:
+	std::vector<IChunkMeshGPU*> meshes_;
+	std::vector<uint32_t> generations_;
+	std::vector<uint32_t> free_;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef CHUNK_OCCLUSION_H
+#define CHUNK_OCCLUSION_H
+
+#include "chunk_cull.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// low resolution software depth buffer for chunk occlusion culling.
+// occluders are solid boxes, a texel is written only when the box outline
+// covers all of it, with the box's farthest depth, so the buffer never
+// claims more than the occluders hide. a max Hi-Z pyramid over it answers
+// box queries. depth is NDC z (larger = farther), everything is plain
+// float math on the calling thread, so results are deterministic
+class OcclusionBuffer
+{
+public:
+	static constexpr int DEFAULT_WIDTH = 128;
+	static constexpr int DEFAULT_HEIGHT = 64;
+
+	// empty buffer for a new view
+	void begin(const glm::mat4& viewProj, int width = DEFAULT_WIDTH, int height = DEFAULT_HEIGHT);
+	// box must be completely solid. boxes crossing the near plane are skipped
+	void addOccluder(const AABB& box);
+	// builds the Hi-Z pyramid, call after the last occluder
+	void finish();
+
+	// true when box is behind the occluders at every texel it may cover
+	bool isOccluded(const AABB& box) const;
+
+	int width() const { return width_; }
+	int height() const { return height_; }
+	uint32_t occluderCount() const { return occluderCount_; }
+	// level 0 depth, FLT_MAX where nothing was drawn
+	const std::vector<float>& depth() const { return levels_[0]; }
+private:
+	// screen space corners (texels) and the NDC depth range, false when a
+	// corner is behind the near plane
+	bool project(const AABB& box, glm::vec2* outPoints, float& outMinZ, float& outMaxZ) const;
+private:
+	glm::mat4 viewProj_{ 1.0f };
+	int width_{ 0 };
+	int height_{ 0 };
+	uint32_t occluderCount_{ 0 };
+
+	// levels_[0] is the depth buffer, level n is the max of 2x2 texels of n - 1.
+	// levels past levelSizes_ are stale until finish()
+	std::vector<std::vector<float>> levels_{ 1 };
+	std::vector<glm::ivec2> levelSizes_;
+};
+
+#endif
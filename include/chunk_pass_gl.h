@@ -58,6 +58,13 @@ public:
 		const glm::mat4& view,
 		const glm::mat4& proj
 	);
+	void renderOpaqueOffscreen(
+		UBOGL& uboGL,
+		void* ubo,
+		uint32_t uboSize,
+		glm::vec3& chunkOrigin,
+		const ChunkDrawList& list
+	);
 
 	Shader& getOpaqueShader() { return *opaqueShader_; }
 	ChunkOpaqueUBO& getOpaqueUBO() { return chunkOpaqueUBO_; }
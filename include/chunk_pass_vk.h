@@ -22,6 +22,7 @@ struct RenderInputs;
 struct RenderSettings;
 struct DrawContext;
 struct FrameContext;
+struct ChunkDrawList;
 
 class ChunkPassVk
 {
@@ -53,6 +54,8 @@ public:
 	);
 
 private:
+	// push each item's origin and draw its opaque sections
+	void drawList(vk::CommandBuffer cmd, vk::PipelineLayout layout, const ChunkDrawList& list) const;
 	void refreshTexBinding();
 	void createResources();
 	void createDescriptorSets();
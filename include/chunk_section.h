@@ -0,0 +1,64 @@
+#ifndef CHUNK_SECTION_H
+#define CHUNK_SECTION_H
+
+#include "constants.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace World;
+
+// 16 block tall slice of a chunk.
+// uniform sections (all air, all stone, ...) store a single BlockID,
+// mixed sections store a palette plus bit-packed palette indices
+// (1, 2, 4 or 8 bits per block, indices never straddle a 64-bit word)
+class ChunkSection
+{
+public:
+	static constexpr int HEIGHT = 16;
+	static constexpr int VOLUME = CHUNK_SIZE * HEIGHT * CHUNK_SIZE;
+public:
+	// index = x + CHUNK_SIZE * (z + CHUNK_SIZE * localY), same order as the chunk
+	// branchless: uniform sections read a shared zero word with a zero mask
+	BlockID get(int index) const
+	{
+		const uint32_t bit = static_cast<uint32_t>(index) << shift_;
+		const uint64_t word = wordData_[(bit >> 6) & wordMask_];
+
+		return paletteData_[(word >> (bit & 63)) & mask_];
+	} // end of get()
+
+	ChunkSection();
+	ChunkSection(const ChunkSection& other);
+	ChunkSection& operator=(const ChunkSection& other);
+
+	void set(int index, BlockID id);
+
+	void fill(BlockID id);
+	// rebuild from VOLUME dense blocks, picks the smallest palette
+	void pack(const BlockID* dense);
+	void unpack(BlockID* dense) const;
+
+	bool isUniform() const { return bitsPerIndex_ == 0; }
+	size_t memoryUsageBytes() const;
+private:
+	std::vector<BlockID> palette_;
+	std::vector<uint64_t> words_;
+	BlockID uniform_ = BlockID::Air;
+	uint8_t bitsPerIndex_ = 0;
+
+	// cached for get(), refreshed by updateView()
+	const BlockID* paletteData_ = nullptr;
+	const uint64_t* wordData_ = nullptr;
+	uint32_t wordMask_ = 0;
+	uint32_t mask_ = 0;
+	uint8_t shift_ = 0;
+private:
+	void updateView();
+	uint32_t readIndex(int index) const;
+	void writeIndex(int index, uint32_t value);
+	void resize(uint8_t bitsPerIndex);
+};
+
+#endif
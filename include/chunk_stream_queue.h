@@ -0,0 +1,57 @@
+#ifndef CHUNK_STREAM_QUEUE_H
+#define CHUNK_STREAM_QUEUE_H
+
+#include "chunk_mesh.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// chunks waiting to be loaded, lowest priority first. priority is the
+// distance to the predicted camera path (camera -> predicted position),
+// plus half the distance along it, weighted up to 1.5x for chunks behind
+// the look direction. the heap lives across frames, keys are only
+// recomputed (in place, no allocation) once the prediction moved or
+// turned enough to change the order
+class ChunkStreamQueue
+{
+public:
+	// xz camera position, predicted position and unit look direction
+	// (forward may be zero)
+	void setPrediction(const glm::vec2& position, const glm::vec2& predicted, const glm::vec2& forward);
+
+	void push(const ChunkCoord& coord);
+	// false when empty
+	bool pop(ChunkCoord& outCoord);
+	// drops every coord outside the square around center, for the caller
+	// to forget them too
+	void dropOutside(int centerX, int centerZ, int radius, std::vector<ChunkCoord>& outDropped);
+
+	bool empty() const { return heap_.empty(); }
+	size_t size() const { return heap_.size(); }
+	// times the keys were recomputed
+	uint32_t rekeyCount() const { return rekeys_; }
+
+	float priority(const ChunkCoord& coord) const;
+private:
+	struct Entry
+	{
+		float priority;
+		ChunkCoord coord;
+	};
+	// min heap on priority
+	static bool Later(const Entry& a, const Entry& b) { return a.priority > b.priority; }
+private:
+	std::vector<Entry> heap_;
+
+	// prediction the keys were computed with
+	glm::vec2 position_{ 0.0f };
+	glm::vec2 predicted_{ 0.0f };
+	glm::vec2 forward_{ 0.0f };
+	bool keyed_{ false };
+	uint32_t rekeys_{ 0 };
+};
+
+#endif
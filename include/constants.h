@@ -21,12 +21,18 @@ namespace World
  	const int MIN_GROUND = 100.0;
 	const int MAX_TERRAIN = MIN_GROUND;
 	const int SEA_LEVEL = MIN_GROUND + 40;
+	// water surface, the reflection mirror and clip plane
+	const float WATER_HEIGHT = static_cast<float>(SEA_LEVEL) + 0.9f;
 
 	const int CHUNK_SIZE = 15;
 	const int CHUNK_SIZE_Y = 256;
+	const int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE_Y * CHUNK_SIZE;
 
 	const int MIN_RADIUS = 5;
 	const int MAX_RADIUS = 100;
+	// far terrain LOD radius, reaches the far plane
+	const int MAX_LOD_RADIUS = 128;
+	const int DEFAULT_LOD_RADIUS = 64;
 	const float MIN_AMBSTR = 0.03f;
 	const float MAX_AMBSTR = 0.5f;
 
@@ -0,0 +1,14 @@
+#ifndef GPU_COMMAND_CONTEXT_H
+#define GPU_COMMAND_CONTEXT_H
+
+// graphics API neutral handle to the command stream a backend records into.
+// vulkan stores its VkCommandBuffer here (VkUtils::ToCommandContext),
+// opengl and the null backend leave it empty
+struct GPUCommandContext
+{
+	void* handle = nullptr;
+
+	explicit operator bool() const noexcept { return handle != nullptr; }
+};
+
+#endif
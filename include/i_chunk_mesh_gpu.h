@@ -1,7 +1,9 @@
 #ifndef I_CHUNK_MESH_GPU_H
 #define I_CHUNK_MESH_GPU_H
 
-#include <vulkan/vulkan.hpp>
+#include "gpu_command_context.h"
+
+#include <cstdint>
 
 struct ChunkMeshData;
 
@@ -11,11 +13,12 @@ public:
 	virtual ~IChunkMeshGPU() = default;
 
 	virtual void upload(
-		vk::CommandBuffer cmd, 
+		GPUCommandContext context, 
 		const ChunkMeshData& data
 	) = 0;
-	virtual void drawOpaque(vk::CommandBuffer cmd) = 0;
-	virtual void drawWater(vk::CommandBuffer cmd) = 0;
+	// sectionMask selects ChunkMeshData::opaqueSections (MESH_ALL_SECTIONS = whole mesh)
+	virtual void drawOpaque(GPUCommandContext context, uint32_t sectionMask) = 0;
+	virtual void drawWater(GPUCommandContext context) = 0;
 };
 
 #endif
@@ -0,0 +1,80 @@
+#ifndef REGION_FILE_H
+#define REGION_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Region_Constants
+{
+	// chunks per region side (REGION_SIZE x REGION_SIZE chunks per file)
+	const int REGION_SIZE = 32;
+	const int REGION_CHUNKS = REGION_SIZE * REGION_SIZE;
+
+	const uint32_t REGION_MAGIC = 0x4E475253; // "SRGN"
+	const int32_t REGION_VERSION = 2;
+
+	struct RegionFileHeader
+	{
+		uint32_t magic = REGION_MAGIC;
+		int32_t version = REGION_VERSION;
+		int32_t regionX{};
+		int32_t regionZ{};
+		int32_t regionSize = REGION_SIZE;
+		int32_t _pad0{};
+	};
+
+	// chunk index entry, offset from start of file (length 0 = not stored)
+	struct RegionChunkSlot
+	{
+		uint32_t offset{};
+		uint32_t length{};
+	};
+};
+
+struct RegionCoord
+{
+	int x;
+	int z;
+
+	bool operator==(const RegionCoord& other) const noexcept
+	{
+		return x == other.x && z == other.z;
+	}
+};
+
+// one region file: header, REGION_CHUNKS index slots, then compressed
+// chunk payloads. the whole file is read/written in one go,
+// writes go through a temp file + rename
+class RegionFile
+{
+public:
+	static RegionCoord regionOf(int cx, int cz);
+	static int localIndex(int cx, int cz);
+	static std::filesystem::path pathFor(const std::filesystem::path& worldDir, const RegionCoord& rc);
+
+	enum class ReadResult
+	{
+		Ok,
+		// no file, the region is empty
+		Missing,
+		// exists but cannot be opened or parsed, must not be overwritten
+		Unreadable
+	};
+
+	// clears every chunk first, they stay empty unless Ok
+	ReadResult read(const std::filesystem::path& path);
+	bool write(const std::filesystem::path& path, const RegionCoord& rc) const;
+
+	bool has(int index) const { return !chunks_[index].empty(); }
+	const std::vector<uint8_t>& payload(int index) const { return chunks_[index]; }
+	void setPayload(int index, std::vector<uint8_t> payload) { chunks_[index] = std::move(payload); }
+
+	size_t payloadBytes() const;
+private:
+	std::array<std::vector<uint8_t>, Region_Constants::REGION_CHUNKS> chunks_;
+};
+
+#endif
@@ -1,19 +1,123 @@
 #ifndef SAVE_H
 #define SAVE_H
 
+#include "constants.h"
+
+#include "region_file.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 class ChunkData;
 struct ChunkFileHeader;
 
+// world saves are stored as region files (see region_file.h), each
+// holding REGION_SIZE x REGION_SIZE compressed chunks. recently used
+// regions are kept in memory so streaming does not reopen files per chunk.
+// safe to call from chunk worker threads.
+// queueChunkSave() copies the chunk and returns, a background thread
+// writes queued chunks (latest copy wins) and loads see queued data
 class Save
 {
 public:
 	Save() = default;
 	~Save();
 
-	void saveChunkToFile(const ChunkData& chunk, const std::string_view& worldPath);
+	// non-blocking, snapshot is written by the save thread
+	void queueChunkSave(const ChunkData& chunk, const std::string_view& worldPath);
+	// blocks until every queued chunk is written, false when a region
+	// still could not be written (its chunks stay in memory)
+	bool flush();
+	size_t queuedChunkCount() const;
+
+	// false when a region could not be written, its chunks stay in memory
+	// and are written again with the next save or flush()
+	bool saveChunkToFile(const ChunkData& chunk, const std::string_view& worldPath);
 	bool loadChunkFromFile(ChunkData& dst, int cx, int cz, const std::string_view& worldPath);
+
+	// reads the region holding chunk (cx, cz) into the cache ahead of the
+	// chunk loads, the file is read without holding the cache lock
+	void prefetchRegion(int cx, int cz, const std::string_view& worldPath);
+
+	// batched variants, one region write/read per touched region
+	bool saveChunksToFile(const std::vector<const ChunkData*>& chunks, const std::string_view& worldPath);
+	std::vector<bool> loadChunksFromFile(const std::vector<ChunkData*>& dsts, const std::string_view& worldPath);
+
+	// converts per-chunk chunk_X_Z.bin files (version 1) into regions,
+	// returns number of chunks migrated
+	int migrateLegacyWorld(const std::string_view& worldPath);
+
+	// deletes every world folder under parentPath except keepName (stale
+	// generated chunk caches), call before anything loads from parentPath.
+	// returns number of folders removed
+	int removeWorldsExcept(const std::string_view& parentPath, const std::string_view& keepName);
+
+	void clearCache();
+private:
+	using BlockArray = std::array<World::BlockID, World::CHUNK_VOLUME>;
+	// (world, cx, cz)
+	using SnapshotKey = std::tuple<std::string, int, int>;
+	using SnapshotMap = std::map<SnapshotKey, std::shared_ptr<const BlockArray>>;
+
+	struct CachedRegion
+	{
+		std::filesystem::path path;
+		std::shared_ptr<RegionFile> file;
+		uint64_t lastUse{};
+		RegionCoord rc{};
+		// holds chunks that are not on disk yet (also after a failed
+		// write), never evicted
+		bool dirty = false;
+	};
+
+	// regions kept in memory (missing regions are cached as empty)
+	static constexpr size_t MAX_CACHED_REGIONS = 32;
+
+	// one region writer at a time, taken before mutex_. the files are
+	// written without mutex_ so loads do not wait for the disk
+	std::mutex writeMutex_;
+	std::mutex mutex_;
+	std::vector<CachedRegion> cache_;
+	uint64_t useCounter_ = 0;
+	// bumped by every region write, guarded by mutex_
+	uint64_t regionWrites_ = 0;
+
+	// save thread state, guarded by queueMutex_ (never held during disk io)
+	mutable std::mutex queueMutex_;
+	std::condition_variable queueCv_;
+	std::condition_variable idleCv_;
+	SnapshotMap queued_;
+	SnapshotMap writing_;
+	std::thread saveThread_;
+	bool stop_ = false;
+private:
+	void saveThreadLoop();
+	bool findQueuedSnapshot(const std::string_view& worldPath, int cx, int cz, BlockArray& out) const;
+	bool writeChunks(
+		const std::vector<std::tuple<int, int, const World::BlockID*>>& chunks,
+		const std::string_view& worldPath
+	);
+	// writes every dirty cached region, caller holds writeMutex_
+	bool writeDirtyRegions();
+
+	std::shared_ptr<RegionFile> findCachedLocked(const std::filesystem::path& path);
+	void setDirtyLocked(const std::filesystem::path& path, bool dirty);
+	std::shared_ptr<RegionFile> insertCachedLocked(
+		const std::filesystem::path& path,
+		const RegionCoord& rc,
+		std::shared_ptr<RegionFile> file
+	);
+	std::shared_ptr<RegionFile> acquireRegionLocked(const std::filesystem::path& worldDir, const RegionCoord& rc);
 };
 
 #endif
@@ -25,6 +25,11 @@ public:
 
 	void init();
 
+	// fits the light ortho around the visible chunks, call before the
+	// frame's views are culled so the light can be one of them.
+	// false when there is nothing to cast shadows
+	bool fitLightSpace(const RenderInputs& in);
+
 	void renderOffscreen(
 		ChunkPassGL& chunk,
 		const RenderInputs& in
@@ -34,6 +39,8 @@ public:
 	uint32_t getFBO() const { return fbo_; }
 
 	const glm::mat4& getLightSpaceMatrix() const { return lightSpaceMatrix_; }
+	const glm::mat4& getLightView() const { return lightView_; }
+	const glm::mat4& getLightProj() const { return lightProj_; }
 
 private:
 	int width_{ SHADOW_RESOLUTION };
@@ -42,6 +49,7 @@ private:
 	glm::mat4 lightSpaceMatrix_{};
 	glm::mat4 lightView_{};
 	glm::mat4 lightProj_{};
+	bool lightSpaceValid_{ false };
 
 	std::unique_ptr<Shader> shader_;
 
@@ -23,6 +23,11 @@ public:
 
 	void init();
 
+	// fits the light ortho around the visible chunks, call before the
+	// frame's views are culled so the light can be one of them.
+	// false when there is nothing to cast shadows
+	bool fitLightSpace(const RenderInputs& in);
+
 	void render(
 		ChunkPassVk& chunk,
 		const RenderInputs& in,
@@ -33,6 +38,8 @@ public:
 	const ImageVk& getDepthImage() const { return depthImage_; }
 
 	const glm::mat4& getLightSpaceMatrix() const { return lightSpaceMatrix_; }
+	const glm::mat4& getLightView() const { return lightView_; }
+	const glm::mat4& getLightProj() const { return lightProj_; }
 
 private:
 	void buildLightSpaceBounds(
@@ -50,6 +57,7 @@ private:
 	glm::mat4 lightSpaceMatrix_{};
 	glm::mat4 lightView_{};
 	glm::mat4 lightProj_{};
+	bool lightSpaceValid_{ false };
 
 	ImageVk depthImage_;
 	vk::Format depthFormat_ = vk::Format::eD32Sfloat;
@@ -0,0 +1,111 @@
+#ifndef TERRAIN_GENERATOR_H
+#define TERRAIN_GENERATOR_H
+
+#include "chunk_data.h"
+#include "perlin_batch.h"
+
+#include <string>
+
+struct ChunkCoord;
+
+// every knob of world generation, the defaults are the original world
+struct TerrainSettings
+{
+	// seeds both the height and the cave noise
+	int seed = 777;
+
+	// height map, sampled every block at heightScale noise units
+	double heightScale = 0.01;
+	double heightFrequency = 1.0;
+	double heightPersistence = 0.5;
+	double heightLacunarity = 2.0;
+	int heightOctaves = 5;
+	// noise [-1, 1] maps to ground in [minGround, minGround + maxTerrain]
+	int minGround = MIN_GROUND;
+	int maxTerrain = MAX_TERRAIN;
+	int seaLevel = SEA_LEVEL;
+
+	// caves where the 3D noise is above caveThreshold
+	double caveScale = 0.06;
+	double caveFrequency = 0.4;
+	double cavePersistence = 0.5;
+	double caveLacunarity = 2.0;
+	int caveOctaves = 3;
+	double caveThreshold = 0.65;
+	// cave noise lattice spacing in blocks, 1 samples every block. above
+	// that the noise is sampled on a world aligned lattice and trilinearly
+	// interpolated, cells with every corner below the threshold are skipped
+	int caveLatticeXZ = 1;
+	int caveLatticeY = 1;
+
+	// ore in stone below maxY, 1 in chance
+	struct Ore
+	{
+		BlockID block;
+		int maxY;
+		int chance;
+	};
+	Ore iron{ BlockID::IronOre, 30, 100 };
+	Ore diamond{ BlockID::DiamondOre, 20, 1000 };
+	Ore gold{ BlockID::GoldOre, 10, 50000 };
+
+	// percent of grass columns with a tree
+	int treeChance = 35;
+};
+
+// world generation, created once per world. generate() is const and keeps
+// its scratch on the stack, the noise modules are only read, so any number
+// of threads can generate chunks from one generator at the same time
+class TerrainGenerator
+{
+public:
+	// bump whenever generate() output changes for the same settings, it
+	// keys the generated chunk cache
+	static constexpr int VERSION = 1;
+
+	explicit TerrainGenerator(const TerrainSettings& settings = {});
+
+	// shared generator with the default settings (ChunkData::generate())
+	static const TerrainGenerator& standard();
+
+	// overwrites every block of out and sets its coord
+	void generate(const ChunkCoord& coord, ChunkData& out, NoisePath path = NoisePath::Batch) const;
+
+	// ground height of column (x, z) of chunk (cx, cz), the same value
+	// generate() puts the surface block at (far terrain LOD)
+	int surfaceHeight(int cx, int cz, int x, int z) const;
+
+	// "<seed>_v<VERSION>_<hash of the other settings>", generators with the
+	// same name produce the same chunks
+	std::string cacheName() const;
+
+	const TerrainSettings& getSettings() const { return settings_; }
+private:
+	// noise [-1, 1] -> ground height
+	int groundHeight(float n) const;
+	// sample positions of a height map axis over chunk c, accumulated like
+	// utils::NoiseMapBuilderPlane so the values are bit identical
+	void planeSamples(int c, double* out) const;
+	// heights in x + CHUNK_SIZE * z order
+	void sampleHeightMap(const ChunkCoord& coord, NoisePath path, float* heights) const;
+	// water, air, sand, grass, dirt and stone of every layer. layers under
+	// or over every surface are single runs, the rest go in layout order
+	void fillTerrain(const int* columnHeights, int lowest, int highest, BlockID* blocks) const;
+	// cave noise of world column (worldX, worldZ) at y = firstY + i * stepY
+	void sampleCaveColumn(int worldX, int worldZ, int firstY, int stepY, int count, NoisePath path, double* out) const;
+	// stone and dirt to air where the cave noise is above the threshold,
+	// for y in [1, height - 4) of every column
+	void carveCaves(const ChunkCoord& coord, NoisePath path, const int* columnHeights, BlockID* blocks) const;
+	void carveCavesLattice(const ChunkCoord& coord, NoisePath path, const int* columnHeights, BlockID* blocks) const;
+	void placeOre(BlockID* blocks, int worldX, int worldZ, int x, int y, int z) const;
+	void placeTree(BlockID* blocks, int worldX, int worldZ, int x, int groundY, int z) const;
+private:
+	TerrainSettings settings_;
+
+	noise::module::Perlin heightNoise_;
+	noise::module::Perlin caveNoise_;
+	PerlinBatch heightBatch_;
+	PerlinBatch caveBatch_;
+};
+
+#endif
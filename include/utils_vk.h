@@ -1,6 +1,8 @@
 #ifndef UTILS_VK_H
 #define UTILS_VK_H
 
+#include "gpu_command_context.h"
+
 #include <vulkan/vulkan.hpp>
 
 #include <cstdint>
@@ -37,6 +39,17 @@ namespace VkUtils
 		uint32_t layers,
 		uint32_t mipLevels
 	);
+
+	// command buffer <-> API neutral context used by the world code
+	inline GPUCommandContext ToCommandContext(vk::CommandBuffer cmd)
+	{
+		return { static_cast<void*>(static_cast<VkCommandBuffer>(cmd)) };
+	}
+
+	inline vk::CommandBuffer ToCommandBuffer(GPUCommandContext context)
+	{
+		return vk::CommandBuffer(static_cast<VkCommandBuffer>(context.handle));
+	}
 }
 
 #endif
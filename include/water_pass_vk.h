@@ -17,6 +17,7 @@
 
 class VulkanMain;
 class ShaderModuleVk;
+class Camera;
 struct RenderInputs;
 class ChunkPassVk;
 struct FrameContext;
@@ -53,6 +54,9 @@ public:
 		int width, int height
 	);
 
+	// projection of the mirrored camera at the reflection target size
+	glm::mat4 reflectionProj(const Camera& camera) const;
+
 	ImageVk& getReflColorImage() { return reflColorImage_; }
 	ImageVk& getReflDepthImage() { return reflDepthImage_; }
 
@@ -0,0 +1,236 @@
+#include "chunk_cull.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CHUNK_CULL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHUNK_CULL_SSE2
+#endif
+
+//--- HELPER ---//
+static Plane NormalizePlane(const Plane& pl)
+{
+	float len = glm::length(pl.n);
+	if (len <= 1e-8f) return pl;
+	return { pl.n / len, pl.d / len };
+} // end of NormalizePlane()
+
+static glm::vec3 PositiveVertex(const AABB& b, const glm::vec3& n)
+{
+	return glm::vec3(
+		(n.x >= 0.0f) ? b.max.x : b.min.x,
+		(n.y >= 0.0f) ? b.max.y : b.min.y,
+		(n.z >= 0.0f) ? b.max.z : b.min.z
+	);
+} // end of PositiveVertex()
+
+// per plane the positive vertex picks the min or max array for every box
+struct PlaneVertexArrays
+{
+	const float* x[6];
+	const float* y[6];
+	const float* z[6];
+};
+
+static PlaneVertexArrays SelectPlaneVertices(const ChunkCullBounds& b, const Frustum& f)
+{
+	PlaneVertexArrays v;
+	for (int k = 0; k < 6; ++k)
+	{
+		const glm::vec3& n = f.p[k].n;
+		v.x[k] = (n.x >= 0.0f) ? b.maxX.data() : b.minX.data();
+		v.y[k] = (n.y >= 0.0f) ? b.maxY.data() : b.minY.data();
+		v.z[k] = (n.z >= 0.0f) ? b.maxZ.data() : b.minZ.data();
+	} // end for
+	return v;
+} // end of SelectPlaneVertices()
+
+
+//--- PUBLIC ---//
+Frustum ExtractFrustumPlanes(const glm::mat4& VP)
+{
+	// GLM is column-major; to get row r: (VP[0][r], VP[1][r], VP[2][r], VP[3][r])
+	auto row = [&](int r) {
+		return glm::vec4(VP[0][r], VP[1][r], VP[2][r], VP[3][r]);
+		};
+
+	glm::vec4 r0 = row(0);
+	glm::vec4 r1 = row(1);
+	glm::vec4 r2 = row(2);
+	glm::vec4 r3 = row(3);
+
+	auto makePlane = [&](const glm::vec4& v) {
+		return NormalizePlane(Plane{ glm::vec3(v), v.w });
+		};
+
+	Frustum f;
+	f.p[0] = makePlane(r3 + r0); // Left
+	f.p[1] = makePlane(r3 - r0); // Right
+	f.p[2] = makePlane(r3 + r1); // Bottom
+	f.p[3] = makePlane(r3 - r1); // Top
+	f.p[4] = makePlane(r3 + r2); // Near
+	f.p[5] = makePlane(r3 - r2); // Far
+	return f;
+} // end of ExtractFrustumPlanes()
+
+bool IntersectsFrustum(const AABB& box, const Frustum& f)
+{
+	for (int i = 0; i < 6; ++i)
+	{
+		const Plane& p = f.p[i];
+		glm::vec3 v = PositiveVertex(box, p.n);
+
+		// if the most inside corner is still outside, whole AABB is outside
+		if (glm::dot(p.n, v) + p.d < 0.0f)
+			return false;
+	} // end for
+	return true;
+} // end of IntersectsFrustum()
+
+void ChunkCullBounds::clear()
+{
+	minX.clear(); minY.clear(); minZ.clear();
+	maxX.clear(); maxY.clear(); maxZ.clear();
+	chunkX.clear(); chunkZ.clear();
+} // end of clear()
+
+void ChunkCullBounds::push(int cx, int cz, const AABB& box)
+{
+	minX.push_back(box.min.x);
+	minY.push_back(box.min.y);
+	minZ.push_back(box.min.z);
+	maxX.push_back(box.max.x);
+	maxY.push_back(box.max.y);
+	maxZ.push_back(box.max.z);
+	chunkX.push_back(cx);
+	chunkZ.push_back(cz);
+} // end of push()
+
+void CullFrustum(const ChunkCullBounds& bounds, const Frustum& f, std::vector<uint64_t>& outVisible)
+{
+	const size_t count = bounds.size();
+	outVisible.assign((count + 63) / 64, 0);
+
+	const PlaneVertexArrays v = SelectPlaneVertices(bounds, f);
+	size_t i = 0;
+
+	// dot is (x + y) + z, then + d, the order glm::dot uses. lanes that end
+	// up < 0 for any plane are outside (NaN compares false, as in scalar)
+#if defined(CHUNK_CULL_AVX2)
+	const __m256 zero = _mm256_setzero_ps();
+	__m256 nx[6], ny[6], nz[6], nd[6];
+	for (int k = 0; k < 6; ++k)
+	{
+		nx[k] = _mm256_set1_ps(f.p[k].n.x);
+		ny[k] = _mm256_set1_ps(f.p[k].n.y);
+		nz[k] = _mm256_set1_ps(f.p[k].n.z);
+		nd[k] = _mm256_set1_ps(f.p[k].d);
+	} // end for
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 outside = zero;
+		for (int k = 0; k < 6; ++k)
+		{
+			__m256 x = _mm256_mul_ps(nx[k], _mm256_loadu_ps(v.x[k] + i));
+			__m256 y = _mm256_mul_ps(ny[k], _mm256_loadu_ps(v.y[k] + i));
+			__m256 z = _mm256_mul_ps(nz[k], _mm256_loadu_ps(v.z[k] + i));
+			__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(x, y), z), nd[k]);
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+		} // end for
+
+		uint64_t visible = static_cast<uint64_t>(~_mm256_movemask_ps(outside) & 0xFF);
+		outVisible[i >> 6] |= visible << (i & 63);
+	} // end for
+#elif defined(CHUNK_CULL_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	__m128 nx[6], ny[6], nz[6], nd[6];
+	for (int k = 0; k < 6; ++k)
+	{
+		nx[k] = _mm_set1_ps(f.p[k].n.x);
+		ny[k] = _mm_set1_ps(f.p[k].n.y);
+		nz[k] = _mm_set1_ps(f.p[k].n.z);
+		nd[k] = _mm_set1_ps(f.p[k].d);
+	} // end for
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 outside = zero;
+		for (int k = 0; k < 6; ++k)
+		{
+			__m128 x = _mm_mul_ps(nx[k], _mm_loadu_ps(v.x[k] + i));
+			__m128 y = _mm_mul_ps(ny[k], _mm_loadu_ps(v.y[k] + i));
+			__m128 z = _mm_mul_ps(nz[k], _mm_loadu_ps(v.z[k] + i));
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), nd[k]);
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+		} // end for
+
+		uint64_t visible = static_cast<uint64_t>(~_mm_movemask_ps(outside) & 0xF);
+		outVisible[i >> 6] |= visible << (i & 63);
+	} // end for
+#endif
+
+	// tail (and the whole array without SIMD)
+	for (; i < count; ++i)
+	{
+		bool inside = true;
+		for (int k = 0; k < 6 && inside; ++k)
+		{
+			const Plane& p = f.p[k];
+			float dist = p.n.x * v.x[k][i] + p.n.y * v.y[k][i] + p.n.z * v.z[k][i] + p.d;
+			inside = !(dist < 0.0f);
+		} // end for
+
+		if (inside)
+		{
+			outVisible[i >> 6] |= 1ull << (i & 63);
+		}
+	} // end for
+} // end of CullFrustum()
+
+void CullFrustumScalar(const ChunkCullBounds& bounds, const Frustum& f, std::vector<uint64_t>& outVisible)
+{
+	const size_t count = bounds.size();
+	outVisible.assign((count + 63) / 64, 0);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (IntersectsFrustum(bounds.box(i), f))
+		{
+			outVisible[i >> 6] |= 1ull << (i & 63);
+		}
+	} // end for
+} // end of CullFrustumScalar()
+
+uint32_t CullSections(const AABB& column, const ChunkMeshSection* sections, uint32_t sectionMask, const Frustum& f)
+{
+	uint32_t visible = 0;
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		if ((sectionMask & (1u << s)) == 0)
+		{
+			continue;
+		}
+
+		AABB box = column;
+		box.min.y = column.min.y + sections[s].minY;
+		box.max.y = column.min.y + sections[s].maxY;
+		if (IntersectsFrustum(box, f))
+		{
+			visible |= 1u << s;
+		}
+	} // end for
+	return visible;
+} // end of CullSections()
+
+const char* CullFrustumPath()
+{
+#if defined(CHUNK_CULL_AVX2)
+	return "avx2";
+#elif defined(CHUNK_CULL_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+} // end of CullFrustumPath()
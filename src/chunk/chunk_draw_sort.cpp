@@ -0,0 +1,90 @@
+#include "chunk_draw_sort.h"
+
+#include "constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace World;
+
+//--- PUBLIC ---//
+void ChunkDrawSorter::sort(std::vector<ChunkDrawItem>& items, const glm::vec3& eye, Order order)
+{
+	const size_t count = items.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	entries_.resize(count);
+	scratch_.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint64_t key = distanceKey(items[i], eye);
+		if (order == Order::BackToFront)
+		{
+			key = UINT16_MAX - key;
+		}
+		entries_[i] = (key << 32) | static_cast<uint64_t>(i);
+	} // end for
+
+	// low key byte, then high key byte
+	for (int shift = 32; shift < 48; shift += 8)
+	{
+		uint32_t offsets[256] = {};
+		for (size_t i = 0; i < count; ++i)
+		{
+			++offsets[(entries_[i] >> shift) & 0xFF];
+		} // end for
+
+		uint32_t sum = 0;
+		for (uint32_t& offset : offsets)
+		{
+			const uint32_t bucket = offset;
+			offset = sum;
+			sum += bucket;
+		} // end for
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			scratch_[offsets[(entries_[i] >> shift) & 0xFF]++] = entries_[i];
+		} // end for
+		entries_.swap(scratch_);
+	} // end for
+
+	// slot k takes item order_[k], moved along each permutation cycle
+	order_.resize(count);
+	for (size_t k = 0; k < count; ++k)
+	{
+		order_[k] = static_cast<uint32_t>(entries_[k]);
+	} // end for
+
+	for (size_t start = 0; start < count; ++start)
+	{
+		if (order_[start] == start)
+		{
+			continue;
+		}
+
+		ChunkDrawItem held = std::move(items[start]);
+		size_t slot = start;
+		while (order_[slot] != start)
+		{
+			const size_t from = order_[slot];
+			items[slot] = std::move(items[from]);
+			order_[slot] = static_cast<uint32_t>(slot);
+			slot = from;
+		} // end while
+		items[slot] = std::move(held);
+		order_[slot] = static_cast<uint32_t>(slot);
+	} // end for
+} // end of sort()
+
+uint16_t ChunkDrawSorter::distanceKey(const ChunkDrawItem& item, const glm::vec3& eye)
+{
+	const float dx = item.chunkOrigin.x + 0.5f * CHUNK_SIZE - eye.x;
+	const float dz = item.chunkOrigin.z + 0.5f * CHUNK_SIZE - eye.z;
+	const float key = std::sqrt(dx * dx + dz * dz) * 8.0f;
+	return static_cast<uint16_t>(std::min(key, static_cast<float>(UINT16_MAX)));
+} // end of distanceKey()
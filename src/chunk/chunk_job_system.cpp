@@ -0,0 +1,312 @@
+#include "chunk_job_system.h"
+
+#include "chunk_lod.h"
+#include "save.h"
+#include "terrain_generator.h"
+
+#include <algorithm>
+#include <utility>
+
+//--- PUBLIC ---//
+ChunkJobSystem::ChunkJobSystem(Save& save, std::string worldName, std::string cacheName, const TerrainGenerator& terrain, unsigned workerCount)
+	: save_(save), worldName_(std::move(worldName)), cacheName_(std::move(cacheName)), terrain_(terrain)
+{
+	workers_.reserve(workerCount);
+	for (unsigned i = 0; i < workerCount; ++i)
+	{
+		workers_.emplace_back(&ChunkJobSystem::workerLoop, this);
+	} // end for
+} // end of constructor
+
+ChunkJobSystem::~ChunkJobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+		jobs_.clear();
+	}
+	jobReady_.notify_all();
+
+	for (std::thread& worker : workers_)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	} // end for
+} // end of destructor
+
+void ChunkJobSystem::submit(const ChunkCoord& coord, std::unique_ptr<ChunkBorders> borders)
+{
+	Job job;
+	job.coord = coord;
+	job.borders = std::move(borders);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.ticket = nextTicket_++;
+		jobs_.push_back(std::move(job));
+	}
+	jobReady_.notify_one();
+} // end of submit()
+
+void ChunkJobSystem::submitRemesh(const ChunkData& data, std::unique_ptr<ChunkBorders> borders, uint64_t contentVersion)
+{
+	Job job;
+	job.coord = { data.m_chunkX, data.m_chunkZ };
+	job.borders = std::move(borders);
+	job.data = std::make_unique<ChunkData>(data);
+	job.contentVersion = contentVersion;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.ticket = nextTicket_++;
+		jobs_.push_back(std::move(job));
+	}
+	jobReady_.notify_one();
+} // end of submitRemesh()
+
+void ChunkJobSystem::submitPrefetch(const ChunkCoord& coord)
+{
+	Job job;
+	job.coord = coord;
+	job.prefetch = true;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.ticket = nextTicket_++;
+		jobs_.push_back(std::move(job));
+	}
+	jobReady_.notify_one();
+} // end of submitPrefetch()
+
+void ChunkJobSystem::submitLod(const ChunkCoord& coord, int step)
+{
+	Job job;
+	job.coord = coord;
+	job.lodStep = step;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.ticket = nextTicket_++;
+		jobs_.push_back(std::move(job));
+	}
+	jobReady_.notify_one();
+} // end of submitLod()
+
+void ChunkJobSystem::cancelQueued(std::vector<ChunkCoord>& outCancelled)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::deque<Job> kept;
+	for (Job& job : jobs_)
+	{
+		if (job.data || job.lodStep != 0)
+		{
+			kept.push_back(std::move(job));
+		}
+		else if (!job.prefetch)
+		{
+			outCancelled.push_back(job.coord);
+		}
+	} // end for
+	jobs_.swap(kept);
+
+	jobDone_.notify_all();
+} // end of cancelQueued()
+
+void ChunkJobSystem::collect(std::vector<ChunkJobResult>& out)
+{
+	// inline mode, do the work on the calling thread
+	if (workers_.empty())
+	{
+		std::deque<Job> jobs;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::swap(jobs, jobs_);
+		}
+
+		for (Job& job : jobs)
+		{
+			if (job.prefetch)
+			{
+				prefetch(job.coord);
+				continue;
+			}
+			out.push_back(runJob(job));
+		} // end for
+		return;
+	}
+
+	std::vector<ChunkJobResult> done;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::swap(done, results_);
+	}
+
+	// workers finish out of order, hand results back in submit order
+	std::sort(done.begin(), done.end(),
+		[](const ChunkJobResult& a, const ChunkJobResult& b)
+		{
+			return a.ticket < b.ticket;
+		});
+
+	for (ChunkJobResult& result : done)
+	{
+		out.push_back(std::move(result));
+	} // end for
+} // end of collect()
+
+void ChunkJobSystem::waitIdle()
+{
+	if (workers_.empty())
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	jobDone_.wait(lock, [&]() { return jobs_.empty() && running_ == 0; });
+} // end of waitIdle()
+
+size_t ChunkJobSystem::inFlight() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return jobs_.size() + running_ + results_.size();
+} // end of inFlight()
+
+unsigned ChunkJobSystem::defaultWorkerCount()
+{
+	// leave one core for the main/render thread
+	unsigned hw = std::thread::hardware_concurrency();
+	return (hw > 1) ? hw - 1 : 1;
+} // end of defaultWorkerCount()
+
+
+//--- PRIVATE ---//
+void ChunkJobSystem::workerLoop()
+{
+	for (;;)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobReady_.wait(lock, [&]() { return stopping_ || !jobs_.empty(); });
+
+			if (stopping_)
+			{
+				return;
+			}
+
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+			++running_;
+		}
+
+		if (job.prefetch)
+		{
+			prefetch(job.coord);
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			--running_;
+		}
+		else
+		{
+			ChunkJobResult result = runJob(job);
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			results_.push_back(std::move(result));
+			--running_;
+		}
+		jobDone_.notify_all();
+	} // end for
+} // end of workerLoop()
+
+ChunkJobResult ChunkJobSystem::runJob(Job& job) const
+{
+	ChunkJobResult result;
+	result.coord = job.coord;
+	result.ticket = job.ticket;
+	result.bordersMask = job.borders ? job.borders->presentMask : 0;
+
+	if (job.lodStep != 0)
+	{
+		result.lod = std::make_unique<ChunkMeshData>();
+		result.lodStep = job.lodStep;
+		ChunkLodMesher::build(terrain_, job.coord, job.lodStep, *result.lod);
+		result.uploadBytes = result.lod->uploadSizeBytes();
+		return result;
+	}
+
+	if (job.data)
+	{
+		// re-mesh, data was snapshotted on the main thread
+		result.remesh = true;
+		result.contentVersion = job.contentVersion;
+		result.mesh = std::make_unique<ChunkMesh>(*job.data);
+	}
+	else
+	{
+		// load save first, only generate terrain on a miss
+		result.mesh = std::make_unique<ChunkMesh>(job.coord.x, job.coord.z, false, false);
+
+		ChunkData& chunk = result.mesh->getChunk();
+		if (!loadStored(job.coord, chunk))
+		{
+			terrain_.generate(job.coord, chunk);
+			// written to the cache when it unloads
+			chunk.m_cachePending = !cacheName_.empty();
+		}
+
+		// neighbours still streaming in would re-mesh this chunk as each one
+		// arrives, the ones on disk give their borders now
+		if (job.borders)
+		{
+			fillStoredBorders(job.coord, *job.borders);
+			result.bordersMask = job.borders->presentMask;
+		}
+	}
+
+	// mesh
+	result.mesh->rebuild(job.borders.get());
+	result.uploadBytes = result.mesh->data().uploadSizeBytes();
+
+	return result;
+} // end of runJob()
+
+bool ChunkJobSystem::loadStored(const ChunkCoord& coord, ChunkData& out) const
+{
+	return save_.loadChunkFromFile(out, coord.x, coord.z, worldName_) ||
+		(!cacheName_.empty() && save_.loadChunkFromFile(out, coord.x, coord.z, cacheName_));
+} // end of loadStored()
+
+void ChunkJobSystem::fillStoredBorders(const ChunkCoord& coord, ChunkBorders& borders) const
+{
+	std::unique_ptr<ChunkData> neighbor;
+	for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+	{
+		const auto s = static_cast<ChunkBorders::Side>(side);
+		if (borders.has(s))
+		{
+			continue;
+		}
+
+		const ChunkCoord n = ChunkBorders::neighborOf(coord, s);
+		if (!neighbor)
+		{
+			neighbor = std::make_unique<ChunkData>(n.x, n.z, false);
+		}
+		if (loadStored(n, *neighbor))
+		{
+			borders.capture(s, *neighbor);
+		}
+	} // end for
+} // end of fillStoredBorders()
+
+void ChunkJobSystem::prefetch(const ChunkCoord& coord) const
+{
+	save_.prefetchRegion(coord.x, coord.z, worldName_);
+	if (!cacheName_.empty())
+	{
+		save_.prefetchRegion(coord.x, coord.z, cacheName_);
+	}
+} // end of prefetch()
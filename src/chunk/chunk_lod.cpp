@@ -0,0 +1,203 @@
+#include "chunk_lod.h"
+
+#include "chunk_data.h"
+#include "terrain_generator.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//--- HELPER ---//
+static const std::array<glm::vec3, 4>& FaceCorners(FaceDir dir)
+{
+	switch (dir)
+	{
+	case FaceDir::PosX: return FACE_POS_X;
+	case FaceDir::NegX: return FACE_NEG_X;
+	case FaceDir::PosY: return FACE_POS_Y;
+	case FaceDir::NegY: return FACE_NEG_Y;
+	case FaceDir::PosZ: return FACE_POS_Z;
+	default:            return FACE_NEG_Z;
+	}
+} // end of FaceCorners()
+
+
+//--- PUBLIC ---//
+int ChunkLodMesher::stepFor(int dist2, int viewRadius)
+{
+	int reach = 2 * viewRadius;
+	for (int level = 0; level < LEVEL_COUNT - 1; ++level)
+	{
+		if (dist2 <= reach * reach)
+		{
+			return STEPS[level];
+		}
+		reach *= 2;
+	} // end for
+	return STEPS[LEVEL_COUNT - 1];
+} // end of stepFor()
+
+int ChunkLodMesher::skirtBottom(const TerrainSettings& settings)
+{
+	// largest noise magnitude, the sum of every octave's persistence
+	double amplitude = 0.0;
+	double persistence = 1.0;
+	for (int octave = 0; octave < settings.heightOctaves; ++octave)
+	{
+		amplitude += persistence;
+		persistence *= std::abs(settings.heightPersistence);
+	} // end for
+
+	// groundHeight() of noise -amplitude, a block of margin below it
+	const double lowest = settings.minGround + (1.0 - amplitude) * 0.5 * settings.maxTerrain;
+	return std::max(0, static_cast<int>(std::floor(lowest)) - 1);
+} // end of skirtBottom()
+
+void ChunkLodMesher::build(const TerrainGenerator& terrain, const ChunkCoord& coord, int step, ChunkMeshData& out)
+{
+	out = ChunkMeshData{};
+
+	const int seaLevel = terrain.getSettings().seaLevel;
+	const int skirt = skirtBottom(terrain.getSettings());
+
+	// y of each cell's top face and the block it shows
+	const int cells = CHUNK_SIZE / step;
+	std::array<int, CHUNK_SIZE * CHUNK_SIZE> tops{};
+	std::array<BlockID, CHUNK_SIZE * CHUNK_SIZE> blocks{};
+	for (int j = 0; j < cells; ++j)
+	{
+		for (int i = 0; i < cells; ++i)
+		{
+			const int height = terrain.surfaceHeight(coord.x, coord.z, i * step + step / 2, j * step + step / 2);
+			if (height < seaLevel)
+			{
+				tops[i + cells * j] = seaLevel + 1;
+				blocks[i + cells * j] = BlockID::Water;
+			}
+			else
+			{
+				tops[i + cells * j] = height + 1;
+				blocks[i + cells * j] = (height < seaLevel + 2) ? BlockID::Sand : BlockID::SnowGrass;
+			}
+		} // end for
+	} // end for
+
+	// one face of the box lo..hi
+	std::vector<uint8_t> quadSections;
+	auto emit = [&](const glm::ivec3& lo, const glm::ivec3& hi, FaceDir dir, BlockID block)
+		{
+			// grass only tops the column, walls show the dirt below
+			int tileX;
+			int tileY;
+			ChunkMesh::getBlockTile((dir != FaceDir::PosY && block == BlockID::SnowGrass) ? BlockID::Dirt : block, tileX, tileY, dir);
+
+			const uint32_t start = static_cast<uint32_t>(out.opaqueVertices.size());
+			const std::array<glm::vec3, 4>& face = FaceCorners(dir);
+			for (int c = 0; c < 4; ++c)
+			{
+				const glm::ivec3 p = lo + glm::ivec3(face[c]) * (hi - lo);
+
+				Vertex v{};
+				v.sample = PackVertexU32(
+					static_cast<uint32_t>(c),
+					static_cast<uint32_t>(tileX), static_cast<uint32_t>(tileY),
+					static_cast<uint32_t>(dir),
+					static_cast<uint32_t>(p.x),
+					static_cast<uint32_t>(p.y),
+					static_cast<uint32_t>(p.z)
+				);
+				out.opaqueVertices.push_back(v);
+			} // end for
+
+			for (uint32_t index : FACE_INDICES)
+			{
+				out.opaqueIndices.push_back(start + index);
+			} // end for
+
+			// bucket by the section of the quad's lowest corner
+			const int s = std::min(lo.y / MESH_SECTION_HEIGHT, MESH_SECTION_COUNT - 1);
+			ChunkMeshSection& section = out.opaqueSections[s];
+			if (out.opaqueSectionMask & (1u << s))
+			{
+				section.minY = std::min(section.minY, static_cast<float>(lo.y));
+				section.maxY = std::max(section.maxY, static_cast<float>(hi.y));
+			}
+			else
+			{
+				section.minY = static_cast<float>(lo.y);
+				section.maxY = static_cast<float>(hi.y);
+				out.opaqueSectionMask |= 1u << s;
+			}
+			section.indexCount += 6;
+			quadSections.push_back(static_cast<uint8_t>(s));
+		};
+
+	for (int j = 0; j < cells; ++j)
+	{
+		for (int i = 0; i < cells; ++i)
+		{
+			const int top = tops[i + cells * j];
+			const BlockID block = blocks[i + cells * j];
+			const int x0 = i * step;
+			const int z0 = j * step;
+
+			emit({ x0, top - 1, z0 }, { x0 + step, top, z0 + step }, FaceDir::PosY, block);
+
+			// walls down to the lower neighbour cell, skirts on the chunk border
+			const int negX = (i > 0) ? tops[(i - 1) + cells * j] : skirt;
+			const int posX = (i < cells - 1) ? tops[(i + 1) + cells * j] : skirt;
+			const int negZ = (j > 0) ? tops[i + cells * (j - 1)] : skirt;
+			const int posZ = (j < cells - 1) ? tops[i + cells * (j + 1)] : skirt;
+
+			if (negX < top)
+			{
+				emit({ x0, negX, z0 }, { x0 + step, top, z0 + step }, FaceDir::NegX, block);
+			}
+			if (posX < top)
+			{
+				emit({ x0, posX, z0 }, { x0 + step, top, z0 + step }, FaceDir::PosX, block);
+			}
+			if (negZ < top)
+			{
+				emit({ x0, negZ, z0 }, { x0 + step, top, z0 + step }, FaceDir::NegZ, block);
+			}
+			if (posZ < top)
+			{
+				emit({ x0, posZ, z0 }, { x0 + step, top, z0 + step }, FaceDir::PosZ, block);
+			}
+		} // end for
+	} // end for
+
+	// order the indices by section, bottom to top
+	uint32_t first = 0;
+	for (ChunkMeshSection& section : out.opaqueSections)
+	{
+		section.firstIndex = first;
+		first += section.indexCount;
+	} // end for
+
+	std::vector<uint32_t> sorted(out.opaqueIndices.size());
+	std::array<uint32_t, MESH_SECTION_COUNT> next{};
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		next[s] = out.opaqueSections[s].firstIndex;
+	} // end for
+	for (size_t q = 0; q < quadSections.size(); ++q)
+	{
+		std::copy_n(out.opaqueIndices.begin() + q * 6, 6, sorted.begin() + next[quadSections[q]]);
+		next[quadSections[q]] += 6;
+	} // end for
+	out.opaqueIndices.swap(sorted);
+
+	out.opaqueIndexCount = static_cast<int32_t>(out.opaqueIndices.size());
+	out.minY = static_cast<float>(skirt);
+	out.maxY = out.minY;
+	for (const ChunkMeshSection& section : out.opaqueSections)
+	{
+		out.maxY = (section.indexCount > 0) ? std::max(out.maxY, section.maxY) : out.maxY;
+	} // end for
+} // end of build()
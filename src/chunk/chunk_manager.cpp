@@ -1,129 +1,155 @@
 #include "chunk_manager.h"
 
-#include "frame_context_vk.h"
-
 #include "chunk_mesh.h"
 #include "chunk_entry.h"
+#include "chunk_lod.h"
+#include "chunk_mesh_gpu_null.h"
 
 #include <limits>
+#include <chrono>
 #include <cmath>
 #include <utility>
 #include <cfloat>
 #include <iostream>
 
-//--- HELPER ---//
-struct Plane
-{
-	glm::vec3 n; // normal
-	float d;     // plane: dot(n, x) + d >= 0 is inside
-};
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-struct Frustum
+//--- HELPER ---//
+static inline int CountTrailingZeros64(uint64_t v)
 {
-	Plane p[6]; // L, R, B, T, N, F
-};
-
-static Plane NormalizePlane(const Plane& pl)
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, v);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(v);
+#endif
+} // end of CountTrailingZeros64()
+
+static glm::vec3 ChunkWorldOrigin(int chunkX, int chunkZ)
 {
-	float len = glm::length(pl.n);
-	if (len <= 1e-8f) return pl;
-	return { pl.n / len, pl.d / len };
-} // end of NormalizePlane()
+	return glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
+} // end of ChunkWorldOrigin()
 
-static Frustum ExtractFrustumPlanes(const glm::mat4& VP)
+// column of the chunk clamped to the y extent of its geometry
+static AABB ChunkWorldAABB(int chunkX, int chunkZ, const ChunkMeshData& mesh)
 {
-	// GLM is column-major; to get row r: (VP[0][r], VP[1][r], VP[2][r], VP[3][r])
-	auto row = [&](int r) {
-		return glm::vec4(VP[0][r], VP[1][r], VP[2][r], VP[3][r]);
-		};
-
-	glm::vec4 r0 = row(0);
-	glm::vec4 r1 = row(1);
-	glm::vec4 r2 = row(2);
-	glm::vec4 r3 = row(3);
+	glm::vec3 base = ChunkWorldOrigin(chunkX, chunkZ);
+	if (!mesh.hasGeometry())
+	{
+		return { base, base + glm::vec3(CHUNK_SIZE, 0.0f, CHUNK_SIZE) };
+	}
 
-	auto makePlane = [&](const glm::vec4& v) {
-		return NormalizePlane(Plane{ glm::vec3(v), v.w });
-		};
+	return {
+		base + glm::vec3(0.0f, mesh.minY, 0.0f),
+		base + glm::vec3(CHUNK_SIZE, mesh.maxY, CHUNK_SIZE)
+	};
+} // end of ChunkWorldAABB()
 
-	Frustum f;
-	f.p[0] = makePlane(r3 + r0); // Left
-	f.p[1] = makePlane(r3 - r0); // Right
-	f.p[2] = makePlane(r3 + r1); // Bottom
-	f.p[3] = makePlane(r3 - r1); // Top
-	f.p[4] = makePlane(r3 + r2); // Near
-	f.p[5] = makePlane(r3 - r2); // Far
-	return f;
-} // end of ExtractFrustumPlanes()
 
-struct AABB
+// sections a mesh section's quads touch, faces on a section boundary
+// are seen from both sides
+static uint32_t SectionSpanMask(const ChunkMeshSection& section)
 {
-	glm::vec3 min;
-	glm::vec3 max;
-};
+	const int lo = std::max(0, static_cast<int>(section.minY) - 1) / MESH_SECTION_HEIGHT;
+	const int hi = std::min(MESH_SECTION_COUNT - 1, static_cast<int>(section.maxY) / MESH_SECTION_HEIGHT);
+	return ((2u << hi) - 1u) & ~((1u << lo) - 1u);
+} // end of SectionSpanMask()
 
-static glm::vec3 PositiveVertex(const AABB& b, const glm::vec3& n)
-{
-	return glm::vec3(
-		(n.x >= 0.0f) ? b.max.x : b.min.x,
-		(n.y >= 0.0f) ? b.max.y : b.min.y,
-		(n.z >= 0.0f) ? b.max.z : b.min.z
-	);
-} // end of PositiveVertex()
 
-static bool IntersectsFrustum(const AABB& box, const Frustum& f)
+//--- PUBLIC ---//
+ChunkManager::ChunkManager(int viewRadiusInChunks, int workerThreads, const WorldSettings& world)
+	: terrain_(world.terrain), viewRadius_(viewRadiusInChunks), worldName_(world.name), lastBlockUsed_(BlockID::Dirt)
 {
-	for (int i = 0; i < 6; ++i)
-	{
-		const Plane& p = f.p[i];
-		glm::vec3 v = PositiveVertex(box, p.n);
-
-		// if the most inside corner is still outside, whole AABB is outside
-		if (glm::dot(p.n, v) + p.d < 0.0f)
-			return false;
-	} // end for
-	return true;
-} // end of IntersectsFrustum()
+	unsigned workers = (workerThreads < 0)
+		? ChunkJobSystem::defaultWorkerCount()
+		: static_cast<unsigned>(workerThreads);
 
-static AABB ChunkWorldAABB(int chunkX, int chunkZ)
-{
-	glm::vec3 base = glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
-	glm::vec3 size = glm::vec3(CHUNK_SIZE, CHUNK_SIZE_Y, CHUNK_SIZE);
+	// pristine chunks live next to the world's regions, one folder per
+	// seed and generator version, caches of other versions are dropped
+	if (world.cacheGenerated)
+	{
+		cacheName_ = worldName_ + "/generated/" + terrain_.cacheName();
+		saveWorld_.removeWorldsExcept(worldName_ + "/generated", terrain_.cacheName());
+	}
 
-	return { base, base + size };
-} // end of ChunkWorldAABB()
+	jobSystem_ = std::make_unique<ChunkJobSystem>(saveWorld_, worldName_, cacheName_, terrain_, workers);
 
+	// keep the job queue short so priority changes take effect quickly
+	maxJobsInFlight_ = std::max<size_t>(16, static_cast<size_t>(workers) * 4);
+	// LOD jobs are small, a few in flight keep up without delaying chunk loads
+	maxLodJobsInFlight_ = std::max<size_t>(4, workers);
 
-//--- PUBLIC ---//
-ChunkManager::ChunkManager(int viewRadiusInChunks)
-	: viewRadius_(viewRadiusInChunks), lastBlockUsed_(BlockID::Dirt)
-{
+	chunks_.resize(viewRadius_, nullptr);
 } // end of constructor
 
 ChunkManager::~ChunkManager() = default;
 
-void ChunkManager::init(VulkanMain* vk)
+void ChunkManager::init(ChunkGPUBackend gpuBackend)
 {
-	vk_ = vk;
+	gpuBackend_ = std::move(gpuBackend);
+	if (!gpuBackend_.create)
+	{
+		gpuBackend_.create = []() { return std::make_shared<ChunkMeshGPUNull>(); };
+		gpuBackend_.needsCommandContext = false;
+	}
+
+	// old saves stored one file per chunk
+	saveWorld_.migrateLegacyWorld(worldName_);
 
 	streamRecenterThreshold_ = std::max(1, viewRadius_ - 10);
 } // end of init()
 
-void ChunkManager::updateDynamic(const glm::vec3& cameraPos, FrameContext* frame)
+void ChunkManager::setViewRadius(int r)
 {
-	glm::vec3 prevCameraPos = lastCameraPos_;
-	lastCameraPos_ = cameraPos;
+	viewRadius_ = std::clamp(r, MIN_RADIUS, MAX_RADIUS);
+
+	// chunks outside the new radius that lose their slot unload right away
+	ChunkCoord center{ streamCenterX_, streamCenterZ_ };
+	std::vector<ChunkGrid<ChunkEntry>::Slot> displaced;
+	chunks_.resize(viewRadius_, streamCenterInitialized_ ? &center : nullptr, &displaced);
+	cullBoundsDirty_ = true;
+	streamWindowDirty_ = true;
 
-	glm::vec2 moveXZ(
-		cameraPos.x - prevCameraPos.x,
-		cameraPos.z - prevCameraPos.z
-	);
+	for (auto& slot : displaced)
+	{
+		retireEntry(*slot.value);
+	} // end for
 
-	bool hasMovement = glm::dot(moveXZ, moveXZ) > 0.0001f;
-	if (hasMovement)
+	// the LOD ring starts at the view radius
+	lodDirty_ = true;
+} // end of setViewRadius()
+
+void ChunkManager::setLodRadius(int r)
+{
+	r = std::clamp(r, 0, MAX_LOD_RADIUS);
+	if (r == lodRadius_)
 	{
-		moveXZ = glm::normalize(moveXZ);
+		return;
 	}
+	lodRadius_ = r;
+
+	std::vector<ChunkGrid<ChunkLodEntry>::Slot> displaced;
+	lodChunks_.resize(lodRadius_, &lodCenter_, &displaced);
+	lodDirty_ = true;
+
+	for (auto& slot : displaced)
+	{
+		meshSlots_.release(slot.value->gpuHandle);
+	} // end for
+} // end of setLodRadius()
+
+void ChunkManager::updateDynamic(const glm::vec3& cameraPos, GPUCommandContext uploadContext)
+{
+	lastCameraPos_ = cameraPos;
+
+	// last frame's culling results are stale
+	frameViews_.clear();
+	scratchView_.lists = 0;
+	frameBoundsValid_ = false;
+	frameChunksReevaluated_ = 0;
 
 	int cameraChunkX = static_cast<int>(std::floor(cameraPos.x / CHUNK_SIZE));
 	int cameraChunkZ = static_cast<int>(std::floor(cameraPos.z / CHUNK_SIZE));
@@ -160,243 +186,278 @@ void ChunkManager::updateDynamic(const glm::vec3& cameraPos, FrameContext* frame
 		recentered = true;
 	}
 
-	// if the center moved, rebuild pending work so old FIFO requests
-	// do not keep higher priority front chunks waiting
-	if (recentered)
+	// the threshold keeps a moving camera from thrashing the window, a
+	// camera at rest finishes centering once its chunks have streamed in
+	const bool atRest = cameraVelocity_.x == 0.0f && cameraVelocity_.z == 0.0f;
+	if (!recentered && atRest && pendingChunks_.empty() && readyChunks_.empty() &&
+		jobSystem_->inFlight() == lodInFlight_)
 	{
-		std::queue<ChunkCoord> emptyQueue;
-		std::swap(pendingChunks_, emptyQueue);
-		queuedChunks_.clear();
+		const int stepX = (cameraChunkX > streamCenterX_) - (cameraChunkX < streamCenterX_);
+		const int stepZ = (cameraChunkZ > streamCenterZ_) - (cameraChunkZ < streamCenterZ_);
+		streamCenterX_ += stepX;
+		streamCenterZ_ += stepZ;
+		recentered = (stepX != 0 || stepZ != 0);
 	}
 
-	std::vector<ChunkCoord> newCoords;
-	newCoords.reserve((viewRadius_ * 2 + 1) * (viewRadius_ * 2 + 1));
-	for (int dz = -viewRadius_; dz <= viewRadius_; ++dz)
+	// where the camera is heading, clamped to the window
+	const glm::vec2 position(cameraPos.x, cameraPos.z);
+	glm::vec2 travel = glm::vec2(cameraVelocity_.x, cameraVelocity_.z) * streamLookahead_;
+	const float maxTravel = static_cast<float>(viewRadius_ * CHUNK_SIZE);
+	if (glm::dot(travel, travel) > maxTravel * maxTravel)
 	{
-		for (int dx = -viewRadius_; dx <= viewRadius_; ++dx)
-		{
-			ChunkCoord coord{ streamCenterX_ + dx, streamCenterZ_ + dz };
+		travel = glm::normalize(travel) * maxTravel;
+	}
+	glm::vec2 forward(cameraForward_.x, cameraForward_.z);
+	forward = (glm::dot(forward, forward) > 0.0001f) ? glm::normalize(forward) : glm::vec2(0.0f);
 
-			if (chunks_.find(coord) == chunks_.end() &&
-				queuedChunks_.find(coord) == queuedChunks_.end())
-			{
-				newCoords.push_back(coord);
-			}
+	// the queue keeps its order across recenters, only chunks that left
+	// the window are dropped and the ones entering it are added
+	pendingChunks_.setPrediction(position, position + travel, forward);
+	if (recentered || streamWindowDirty_)
+	{
+		droppedChunks_.clear();
+		pendingChunks_.dropOutside(streamCenterX_, streamCenterZ_, viewRadius_, droppedChunks_);
+		for (const ChunkCoord& coord : droppedChunks_)
+		{
+			queuedChunks_.erase(coord);
 		} // end for
+	}
+	enqueueMissingChunks();
+
+	if (glm::dot(travel, travel) > 0.0f)
+	{
+		const glm::vec2 predicted = position + travel;
+		prefetchRegions(
+			static_cast<int>(std::floor(predicted.x / CHUNK_SIZE)),
+			static_cast<int>(std::floor(predicted.y / CHUNK_SIZE))
+		);
+	}
+
+	// unload chunks per frame
+	const int maxUnloadChunksPerFrame = 3;
+	int unloaded = 0;
+	for (auto it = chunks_.begin(); it != chunks_.end() &&
+		unloaded < maxUnloadChunksPerFrame; ++it)
+	{
+		int dx = it->coord.x - streamCenterX_;
+		int dz = it->coord.z - streamCenterZ_;
+
+		if (std::abs(dx) > viewRadius_ || std::abs(dz) > viewRadius_)
+		{
+			retireEntry(*it->value);
+			chunks_.erase(it->coord);
+			cullBoundsDirty_ = true;
+			++unloaded;
+		}
 	} // end for
 
-	// prioritize chunks in front of movement, then nearer chunks
-	std::sort(newCoords.begin(), newCoords.end(),
-		[&](const ChunkCoord& a, const ChunkCoord& b)
+	// hand pending chunks to the workers (LOD jobs have their own limit)
+	ChunkCoord coord;
+	while (jobSystem_->inFlight() - lodInFlight_ + readyChunks_.size() < maxJobsInFlight_ &&
+		pendingChunks_.pop(coord))
+	{
+		if (chunks_.contains(coord))
+		{
+			queuedChunks_.erase(coord);
+			continue;
+		}
+
+		jobSystem_->submit(coord, gatherBorders(coord));
+	} // end while
+
+	// gather finished CPU work
+	jobSystem_->collect(collectedChunks_);
+	for (ChunkJobResult& result : collectedChunks_)
+	{
+		if (result.lod)
 		{
-			glm::vec2 camXZ(cameraPos.x, cameraPos.z);
+			--lodInFlight_;
+			readyLods_.push_back(std::move(result));
+			continue;
+		}
+		readyChunks_.push_back(std::move(result));
+	} // end for
+	collectedChunks_.clear();
 
-			glm::vec2 aCenter(
-				a.x * CHUNK_SIZE + CHUNK_SIZE * 0.5f,
-				a.z * CHUNK_SIZE + CHUNK_SIZE * 0.5f
-			);
+	const bool canUpload = !gpuBackend_.needsCommandContext || static_cast<bool>(uploadContext);
+	updateLod(cameraChunkX, cameraChunkZ, uploadContext, canUpload);
 
-			glm::vec2 bCenter(
-				b.x * CHUNK_SIZE + CHUNK_SIZE * 0.5f,
-				b.z * CHUNK_SIZE + CHUNK_SIZE * 0.5f
-			);
+	// upload ready chunks within the per-frame byte budget
+	size_t uploadedBytes = 0;
+	while (!readyChunks_.empty())
+	{
+		ChunkJobResult& ready = readyChunks_.front();
+		const ChunkCoord coord = ready.coord;
 
-			glm::vec2 toA = aCenter - camXZ;
-			glm::vec2 toB = bCenter - camXZ;
+		// neighbour re-mesh of a resident chunk
+		if (ready.remesh)
+		{
+			ChunkEntry* resident = chunks_.find(coord);
+			if (!resident)
+			{
+				readyChunks_.pop_front();
+				continue;
+			}
 
-			float distA = glm::dot(toA, toA);
-			float distB = glm::dot(toB, toB);
+			ChunkEntry& entry = *resident;
 
-			float frontA = 0.0f;
-			float frontB = 0.0f;
+			// edited since the snapshot, the main thread rebuilt it already
+			if (ready.contentVersion != entry.contentVersion)
+			{
+				entry.remeshPending = false;
+				readyChunks_.pop_front();
+				remeshIfMissingBorders(coord);
+				continue;
+			}
 
-			if (hasMovement)
+			if (uploadedBytes > 0 && uploadedBytes + ready.uploadBytes > uploadBudgetBytes_)
 			{
-				glm::vec2 dirA =
-					(glm::dot(toA, toA) > 0.0001f) ? glm::normalize(toA) : glm::vec2(0.0f);
-				glm::vec2 dirB =
-					(glm::dot(toB, toB) > 0.0001f) ? glm::normalize(toB) : glm::vec2(0.0f);
+				break;
+			}
 
-				frontA = glm::dot(moveXZ, dirA);
-				frontB = glm::dot(moveXZ, dirB);
+			if (!canUpload)
+			{
+				break;
 			}
 
-			// prefer chunks more in front of movement
-			if (frontA != frontB)
-				return frontA > frontB;
+			entry.cpu = std::move(ready.mesh);
+			entry.meshedBorders = ready.bordersMask;
+			entry.remeshPending = false;
+			entry.uploadGPU(uploadContext);
+			cullBoundsDirty_ = true;
 
-			// prefer nearer chunks
-			return distA < distB;
-		});
+			uploadedBytes += ready.uploadBytes;
+			readyChunks_.pop_front();
 
-	// push to pending chunks queue
-	for (const ChunkCoord& coord : newCoords)
-	{
-		if (queuedChunks_.insert(coord).second)
-		{
-			pendingChunks_.push(coord);
+			// more neighbours may have arrived while this was in flight
+			remeshIfMissingBorders(coord);
+			continue;
 		}
-	} // end for
 
-	// unload chunks per frame
-	const int maxUnloadChunksPerFrame = 3;
-	int unloaded = 0;
-	for (auto it = chunks_.begin(); it != chunks_.end() &&
-		unloaded < maxUnloadChunksPerFrame;)
-	{
-		int dx = it->first.x - streamCenterX_;
-		int dz = it->first.z - streamCenterZ_;
+		int dx = coord.x - streamCenterX_;
+		int dz = coord.z - streamCenterZ_;
+		bool outOfRange = std::abs(dx) > viewRadius_ || std::abs(dz) > viewRadius_;
 
-		if (std::abs(dx) > viewRadius_ || std::abs(dz) > viewRadius_)
+		// stale result (moved away or already resident)
+		if (outOfRange || chunks_.contains(coord))
 		{
-			if (it->second->cpu->getChunk().m_dirty)
-			{
-				saveWorld_.saveChunkToFile(it->second->cpu->getChunk(), "HelloWorld");
-				it->second->cpu->getChunk().m_dirty = false;
-			}
-
-			it = chunks_.erase(it);
-			++unloaded;
+			queuedChunks_.erase(coord);
+			readyChunks_.pop_front();
+			continue;
 		}
-		else
+
+		// always allow at least one chunk per frame
+		if (uploadedBytes > 0 && uploadedBytes + ready.uploadBytes > uploadBudgetBytes_)
 		{
-			++it;
+			break;
 		}
-	} // end for
-
-	// load chunks per frame
-	const int maxNewChunksPerFrame = 3;
-	int built = 0;
-	while (!pendingChunks_.empty() && built < maxNewChunksPerFrame)
-	{
-		ChunkCoord coord = pendingChunks_.front();
-		pendingChunks_.pop();
-		queuedChunks_.erase(coord);
 
-		if (chunks_.find(coord) != chunks_.end())
+		if (!canUpload)
 		{
-			continue;
+			break;
 		}
 
 		std::unique_ptr<ChunkEntry> entry =
-			std::make_unique<ChunkEntry>(coord.x, coord.z, vk_);
-
-		auto& chunk = entry->cpu->getChunk();
-		saveWorld_.loadChunkFromFile(chunk, coord.x, coord.z, "HelloWorld");
+			std::make_unique<ChunkEntry>(std::move(ready.mesh), gpuBackend_.create());
+		entry->meshedBorders = ready.bordersMask;
+		entry->uploadGPU(uploadContext);
+		entry->gpuHandle = meshSlots_.acquire(entry->gpu.get());
 
-		entry->rebuildCPU();
+		uploadedBytes += ready.uploadBytes;
 
-		if (vk_)
+		// the slot may still hold an out of range chunk waiting to unload
+		if (std::unique_ptr<ChunkEntry> displaced = chunks_.insert(coord, std::move(entry)))
 		{
-			if (!frame) return;
-			entry->uploadGPU(frame->cmd);
+			retireEntry(*displaced);
 		}
-		else
+		cullBoundsDirty_ = true;
+		queuedChunks_.erase(coord);
+		readyChunks_.pop_front();
+
+		// a neighbour border was edited while this chunk was in flight
+		if (staleBorderChunks_.erase(coord) > 0)
 		{
-			entry->uploadGPU({});
+			requestRemesh(coord);
 		}
 
-		chunks_.emplace(coord, std::move(entry));
-		++built;
+		// cull faces between this chunk and neighbours that arrived first
+		remeshIfMissingBorders(coord);
+		for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+		{
+			ChunkCoord neighbor = ChunkBorders::neighborOf(coord, static_cast<ChunkBorders::Side>(side));
+			if (chunks_.contains(neighbor))
+			{
+				remeshIfMissingBorders(neighbor);
+			}
+		} // end for
 	} // end while
 
+	// deferred border re-meshes whose neighbours arrived or dropped out
+	if (!deferredRemesh_.empty())
+	{
+		std::vector<ChunkCoord> deferred(deferredRemesh_.begin(), deferredRemesh_.end());
+		for (const ChunkCoord& coord : deferred)
+		{
+			remeshIfMissingBorders(coord);
+		} // end for
+	}
+
 	// process dirty chunks
-	const int maxDirtyUploadsPerFrame = 1;
+	// (an edit plus up to two border neighbours land in the same frame)
+	const int maxDirtyUploadsPerFrame = 3;
 	int dirtyUploaded = 0;
-	while (!dirtyChunks_.empty() && dirtyUploaded < maxDirtyUploadsPerFrame)
+	while (canUpload && !dirtyChunks_.empty() && dirtyUploaded < maxDirtyUploadsPerFrame)
 	{
 		ChunkCoord coord = dirtyChunks_.front();
 		dirtyChunks_.pop();
 		queuedDirtyChunks_.erase(coord);
 
-		auto it = chunks_.find(coord);
-		if (it == chunks_.end())
+		ChunkEntry* entry = chunks_.find(coord);
+		if (!entry)
 		{
 			continue;
 		}
 
-		it->second->rebuildCPU();
-
-		if (vk_)
-		{
-			if (!frame) return;
-			it->second->uploadGPU(frame->cmd);
-		}
-		else
-		{
-			it->second->uploadGPU({});
-		}
+		std::unique_ptr<ChunkBorders> borders = gatherBorders(coord);
+		entry->rebuildCPU(borders.get());
+		entry->uploadGPU(uploadContext);
+		cullBoundsDirty_ = true;
 
 		++dirtyUploaded;
 	} // end while
 } // end of updateDynamic()
 
+bool ChunkManager::isStreamingIdle() const
+{
+	return pendingChunks_.empty() && readyChunks_.empty() && jobSystem_->inFlight() == 0 &&
+		lodRequests_.empty() && readyLods_.empty();
+} // end of isStreamingIdle()
+
+void ChunkManager::waitForStreamingJobs()
+{
+	jobSystem_->waitIdle();
+} // end of waitForStreamingJobs()
+
 bool ChunkManager::buildVisibleChunkBounds(
 	glm::vec3& outMin,
 	glm::vec3& outMax,
 	int paddingChunks
 )
 {
-	if (chunks_.empty())
+	// the frame sweep already collected the bounds
+	if (!frameBoundsValid_)
 	{
-		return false;
+		cullViews(nullptr, 0, nullptr);
 	}
 
-	bool hasAny = false;
-
-	glm::vec3 minWS(FLT_MAX);
-	glm::vec3 maxWS(-FLT_MAX);
-
-	const float maxDistSq = static_cast<float>(viewRadius_ * viewRadius_);
-	const glm::vec3 camXZ = { lastCameraPos_.x, 0.0f, lastCameraPos_.z };
-
-	for (const auto& [coord, entry] : chunks_)
-	{
-		const int cx = coord.x;
-		const int cz = coord.z;
-
-		// distance culling
-		if (enableDistanceCulling_)
-		{
-			glm::vec3 chunkCenter{
-				static_cast<float>(cx * CHUNK_SIZE + CHUNK_SIZE / 2),
-				0.0f,
-				static_cast<float>(cz * CHUNK_SIZE + CHUNK_SIZE / 2)
-			};
-
-			glm::vec3 delta = chunkCenter - camXZ;
-			float distSq = delta.x * delta.x + delta.z * delta.z;
-
-			if (distSq > maxDistSq * CHUNK_SIZE * CHUNK_SIZE)
-			{
-				continue;
-			}
-		}
-
-		// AABB
-		glm::vec3 chunkMin{
-			static_cast<float>(cx * CHUNK_SIZE),
-			0.0f,
-			static_cast<float>(cz * CHUNK_SIZE)
-		};
-
-		glm::vec3 chunkMax{
-			static_cast<float>(cx * CHUNK_SIZE + CHUNK_SIZE),
-			static_cast<float>(CHUNK_SIZE_Y),
-			static_cast<float>(cz * CHUNK_SIZE + CHUNK_SIZE)
-		};
-
-		minWS = glm::min(minWS, chunkMin);
-		maxWS = glm::max(maxWS, chunkMax);
-
-		hasAny = true;
-	} // end for
-
-	if (!hasAny)
+	if (!frameBoundsAny_)
 	{
 		return false;
 	}
 
+	glm::vec3 minWS = frameBoundsMin_;
+	glm::vec3 maxWS = frameBoundsMax_;
+
 	// padding (for shadow stability)
 	float pad = static_cast<float>(paddingChunks * CHUNK_SIZE);
 
@@ -414,67 +475,101 @@ bool ChunkManager::buildVisibleChunkBounds(
 	return true;
 } // end of buildVisibleChunkBounds()
 
+void ChunkManager::cullFrameViews(const std::vector<ChunkCullView>& views)
+{
+	frameViews_ = views;
+	frameLists_.resize(views.size());
+	cullViews(frameViews_.data(), frameViews_.size(), frameLists_.data());
+} // end of cullFrameViews()
+
+void ChunkManager::setCameraMotion(const glm::vec3& velocity, const glm::vec3& forward)
+{
+	cameraVelocity_ = velocity;
+	cameraForward_ = forward;
+} // end of setCameraMotion()
+
 void ChunkManager::buildRTDrawList(
 	const glm::mat4& view,
 	const glm::mat4& proj
 )
 {
-	rtDrawList_.clear();
-
-	int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
-	int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
-	int maxDist2 = viewRadius_ * viewRadius_;
+	const ChunkViewLists* cached = findFrameView(view, proj, ChunkCullView::Combined);
+	if (!cached)
+	{
+		cached = &cullSingleView({ view, proj, ChunkCullView::Combined });
+	}
 
-	frameBlocksRendered_ = 0;
-	frameChunksRendered_ = 0;
+	rtDrawList_ = cached->combined;
+	countRendered(rtDrawList_);
+} // end of buildRTDrawList()
 
-	// get frustum planes
-	Frustum fr = ExtractFrustumPlanes(proj * view);
-	for (auto& [coord, entry] : chunks_)
+const ChunkDrawList& ChunkManager::opaqueDrawListFor(
+	const glm::mat4& view,
+	const glm::mat4& proj
+)
+{
+	const ChunkViewLists* cached = findFrameView(view, proj, ChunkCullView::Opaque);
+	if (!cached)
 	{
-		ChunkMesh* cpu = entry->cpu.get();
-
-		// skip empty meshes
-		if (cpu->opaqueIndexCount() <= 0 && cpu->waterIndexCount() <= 0) continue;
+		// the far terrain of the view is drawn right after
+		cached = &cullSingleView({ view, proj, ChunkCullView::Opaque | ChunkCullView::Lod });
+	}
 
-		// chunkX, chunkZ
-		int chunkX = cpu->getChunk().m_chunkX;
-		int chunkZ = cpu->getChunk().m_chunkZ;
+	countRendered(cached->opaque);
+	return cached->opaque;
+} // end of opaqueDrawListFor()
 
-		// distance culling
-		int dx = chunkX - camChunkX;
-		int dz = chunkZ - camChunkZ;
-		int dist2 = dx * dx + dz * dz;
-		if (enableDistanceCulling_ && dist2 > maxDist2)
-		{
-			continue;
-		}
+const ChunkDrawList& ChunkManager::waterDrawListFor(
+	const glm::mat4& view,
+	const glm::mat4& proj
+)
+{
+	const ChunkViewLists* cached = findFrameView(view, proj, ChunkCullView::Water);
+	if (!cached)
+	{
+		cached = &cullSingleView({ view, proj, ChunkCullView::Water });
+	}
 
-		// set AABB
-		AABB box = ChunkWorldAABB(chunkX, chunkZ);
-		if (enableFrustumCulling_ && !IntersectsFrustum(box, fr))
-		{
-			continue;
-		}
+	return cached->water;
+} // end of waterDrawListFor()
 
-		// chunk/block count
-		frameChunksRendered_++;
-		frameBlocksRendered_ += cpu->getRenderedBlockCount();
+const ChunkDrawList& ChunkManager::shadowDrawListFor(
+	const glm::mat4& view,
+	const glm::mat4& proj
+)
+{
+	const ChunkViewLists* cached = findFrameView(view, proj, ChunkCullView::Opaque);
+	if (!cached)
+	{
+		cached = &cullSingleView({ view, proj, ChunkCullView::Opaque });
+	}
 
-		ChunkDrawItem item;
-		item.chunkOrigin = glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
-		item.gpu = entry->gpu;
-		item.opaqueIndexCount = static_cast<uint32_t>(cpu->opaqueIndexCount());
-		item.waterIndexCount = static_cast<uint32_t>(cpu->waterIndexCount());
-		item.renderedBlockCount = cpu->getRenderedBlockCount();
-		item.geometryVersion = entry->geometryVersion;
+	return cached->opaque;
+} // end of shadowDrawListFor()
 
-		rtDrawList_.items.push_back(item);
-	} // end for
+const ChunkDrawList& ChunkManager::lodDrawListFor(
+	const glm::mat4& view,
+	const glm::mat4& proj
+)
+{
+	const ChunkViewLists* cached = findFrameView(view, proj, ChunkCullView::Lod);
+	if (!cached && (scratchView_.lists & ChunkCullView::Lod) &&
+		scratchView_.view == view && scratchView_.proj == proj)
+	{
+		// culled along with the opaque list just before
+		cached = &scratchLists_;
+	}
+	if (!cached)
+	{
+		cached = &cullSingleView({ view, proj, ChunkCullView::Lod });
+	}
+	// used once, settings may change before the next call
+	scratchView_.lists = 0;
 
-	rtDrawList_.frameChunksRendered = frameChunksRendered_;
-	rtDrawList_.frameBlocksRendered = frameBlocksRendered_;
-} // end of buildRTDrawList()
+	frameLodChunksRendered_ = cached->lod.frameChunksRendered;
+	frameLodTrianglesRendered_ = cached->lod.frameTrianglesRendered;
+	return cached->lod;
+} // end of lodDrawListFor()
 
 void ChunkManager::buildOpaqueDrawList(
 	const glm::mat4& view, 
@@ -482,343 +577,982 @@ void ChunkManager::buildOpaqueDrawList(
 	ChunkDrawList& out
 )
 {
-	out.clear();
+	out = opaqueDrawListFor(view, proj);
+} // end of buildOpaqueDrawList()
 
-	int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
-	int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
-	int maxDist2 = viewRadius_ * viewRadius_;
+void ChunkManager::buildWaterDrawList(
+	const glm::mat4& view, 
+	const glm::mat4& proj, 
+	ChunkDrawList& out
+)
+{
+	out = waterDrawListFor(view, proj);
+} // end of buildWaterDrawList()
+
+BlockID ChunkManager::getBlock(int wx, int wy, int wz) const
+{
+	if (wy < 0 || wy >= CHUNK_SIZE_Y)
+	{
+		return BlockID::Air;
+	}
 
-	frameBlocksRendered_ = 0;
-	frameChunksRendered_ = 0;
+	// integer floor division, local coords are always in range
+	int chunkX = FloorDiv(wx, CHUNK_SIZE);
+	int chunkZ = FloorDiv(wz, CHUNK_SIZE);
 
-	// get frustum planes
-	Frustum fr = ExtractFrustumPlanes(proj * view);
-	for (auto& [coord, entry] : chunks_)
+	const ChunkEntry* entry = chunks_.find({ chunkX, chunkZ });
+	if (!entry)
 	{
-		ChunkMesh* cpu = entry->cpu.get();
+		return BlockID::Air;
+	}
 
-		// skip empty meshes
-		if (cpu->opaqueIndexCount() <= 0) continue;
+	return entry->cpu->getBlock(wx - chunkX * CHUNK_SIZE, wy, wz - chunkZ * CHUNK_SIZE);
+} // end of getBlock()
+
+void ChunkManager::setBlock(int wx, int wy, int wz, BlockID id)
+{
+	int chunkX = FloorDiv(wx, CHUNK_SIZE);
+	int chunkZ = FloorDiv(wz, CHUNK_SIZE);
 
-		// chunkX, chunkZ
-		int chunkX = cpu->getChunk().m_chunkX;
-		int chunkZ = cpu->getChunk().m_chunkZ;
+	ChunkCoord coord{ chunkX, chunkZ };
+	ChunkEntry* entry = chunks_.find(coord);
+	if (!entry)
+	{
+		return;
+	}
 
-		// distance culling
-		int dx = chunkX - camChunkX;
-		int dz = chunkZ - camChunkZ;
-		int dist2 = dx * dx + dz * dz;
-		if (enableDistanceCulling_ && dist2 > maxDist2)
+	int localX = wx - chunkX * CHUNK_SIZE;
+	int localY = wy;
+	int localZ = wz - chunkZ * CHUNK_SIZE;
+
+	if (localY < 0 || localY >= CHUNK_SIZE_Y)
+	{
+		return;
+	}
+
+	entry->cpu->setBlock(localX, localY, localZ, id);
+
+	// mark chunk as modified, it is no longer the generated terrain
+	entry->cpu->getChunk().m_dirty = true;
+	entry->cpu->getChunk().m_cachePending = false;
+	++entry->contentVersion;
+
+	if (queuedDirtyChunks_.insert(coord).second)
+	{
+		dirtyChunks_.push(coord);
+	}
+
+	// border edits change what the neighbours cull against
+	const bool onSide[ChunkBorders::SIDE_COUNT] = {
+		localX == 0,
+		localX == CHUNK_SIZE - 1,
+		localZ == 0,
+		localZ == CHUNK_SIZE - 1
+	};
+
+	for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+	{
+		if (!onSide[side])
 		{
 			continue;
 		}
 
-		// set AABB
-		AABB box = ChunkWorldAABB(chunkX, chunkZ);
-		if (enableFrustumCulling_ && !IntersectsFrustum(box, fr))
+		ChunkCoord neighbor = ChunkBorders::neighborOf(coord, static_cast<ChunkBorders::Side>(side));
+		ChunkEntry* neighborEntry = chunks_.find(neighbor);
+		if (!neighborEntry)
 		{
+			if (queuedChunks_.find(neighbor) != queuedChunks_.end())
+			{
+				staleBorderChunks_.insert(neighbor);
+			}
 			continue;
 		}
 
-		// chunk/block count
-		frameChunksRendered_++;
-		frameBlocksRendered_ += cpu->getRenderedBlockCount();
-
-		ChunkDrawItem item;
-		item.chunkOrigin = glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
-		item.gpu = entry->gpu;
-		item.opaqueIndexCount = static_cast<uint32_t>(cpu->opaqueIndexCount());
-		item.renderedBlockCount = cpu->getRenderedBlockCount();
-		item.geometryVersion = entry->geometryVersion;
-
-		out.items.push_back(item);
+		++neighborEntry->contentVersion;
+		if (queuedDirtyChunks_.insert(neighbor).second)
+		{
+			dirtyChunks_.push(neighbor);
+		}
 	} // end for
-} // end of buildOpaqueDrawList()
+} // end of setBlock()
 
-void ChunkManager::buildOpaqueDrawList(
-	const glm::mat4& view,
-	const glm::mat4& proj
-)
+void ChunkManager::placeOrRemoveBlock(bool shouldPlace, const glm::vec3& origin, const glm::vec3& dir)
 {
-	opaqueDrawList_.clear();
+	BlockHit hit = raycastBlocks(origin, dir);
+	// place op
+	if (shouldPlace)
+	{
+		if (hit.hit)
+		{
+			// DISALLOW block place in water
+			if (getBlock(hit.block.x, hit.block.y, hit.block.z) == BlockID::Water) return;
 
-	int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
-	int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
-	int maxDist2 = viewRadius_ * viewRadius_;
 
-	frameBlocksRendered_ = 0;
-	frameChunksRendered_ = 0;
+			glm::ivec3 placePos = hit.block + hit.normal;
+			setBlock(placePos.x, placePos.y, placePos.z, lastBlockUsed_);
+			// add block to counter
+			++frameBlocksRendered_;
 
-	// get frustum planes
-	Frustum fr = ExtractFrustumPlanes(proj * view);
-	for (auto& [coord, entry] : chunks_)
+			// save
+			saveWorld();
+		}
+	}
+	// destroy op
+	else
 	{
-		ChunkMesh* cpu = entry->cpu.get();
+		if (hit.hit)
+		{
+			// DISALLOW water deletion by player (direct water block or blocks next to water)
+			if (getBlock(hit.block.x, hit.block.y, hit.block.z) == BlockID::Water
+				|| getBlock(hit.block.x - 1, hit.block.y, hit.block.z) == BlockID::Water
+				|| getBlock(hit.block.x + 1, hit.block.y, hit.block.z) == BlockID::Water
+				|| getBlock(hit.block.x, hit.block.y, hit.block.z - 1) == BlockID::Water
+				|| getBlock(hit.block.x, hit.block.y, hit.block.z + 1) == BlockID::Water
+				//|| getBlock(hit.block.x, hit.block.y - 1, hit.block.z) == BlockID::Water
+				|| getBlock(hit.block.x, hit.block.y + 1, hit.block.z) == BlockID::Water) return;
 
-		// skip empty meshes
-		if (cpu->opaqueIndexCount() <= 0) continue;
+			setBlock(hit.block.x, hit.block.y, hit.block.z, BlockID::Air);
+			// remove block from counter
+			--frameBlocksRendered_;
+
+			// save
+			saveWorld();
+		}
+	}
+} // end of placeOrRemoveBlock()
 
-		// chunkX, chunkZ
-		int chunkX = cpu->getChunk().m_chunkX;
-		int chunkZ = cpu->getChunk().m_chunkZ;
+void ChunkManager::saveWorld()
+{
+	// queue all loaded chunks that have been modified,
+	// written by the save thread
+	for (auto& [coord, chunkMesh] : chunks_)
+	{
+		ChunkData& chunk = chunkMesh->cpu->getChunk();
 
-		// distance culling
-		int dx = chunkX - camChunkX;
-		int dz = chunkZ - camChunkZ;
-		int dist2 = dx * dx + dz * dz;
-		if (enableDistanceCulling_ && dist2 > maxDist2)
+		if (!chunk.m_dirty)
 		{
 			continue;
 		}
+		saveWorld_.queueChunkSave(chunk, worldName_);
+		chunk.m_dirty = false;
 
-		// set AABB
-		AABB box = ChunkWorldAABB(chunkX, chunkZ);
-		if (enableFrustumCulling_ && !IntersectsFrustum(box, fr))
+	} // end for
+} // end of saveWorld()
+
+void ChunkManager::flushWorld()
+{
+	saveWorld();
+	saveWorld_.flush();
+} // end of flushWorld()
+
+
+//--- PRIVATE ---//
+std::unique_ptr<ChunkBorders> ChunkManager::gatherBorders(const ChunkCoord& coord) const
+{
+	auto borders = std::make_unique<ChunkBorders>();
+
+	for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+	{
+		auto s = static_cast<ChunkBorders::Side>(side);
+
+		if (const ChunkEntry* neighbor = chunks_.find(ChunkBorders::neighborOf(coord, s)))
 		{
-			continue;
+			borders->capture(s, neighbor->cpu->getChunk());
+		}
+	} // end for
+
+	return borders;
+} // end of gatherBorders()
+
+uint8_t ChunkManager::residentNeighborMask(const ChunkCoord& coord) const
+{
+	uint8_t mask = 0;
+	for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+	{
+		if (chunks_.contains(ChunkBorders::neighborOf(coord, static_cast<ChunkBorders::Side>(side))))
+		{
+			mask |= static_cast<uint8_t>(1u << side);
 		}
+	} // end for
+	return mask;
+} // end of residentNeighborMask()
 
-		// chunk/block count
-		frameChunksRendered_++;
-		frameBlocksRendered_ += cpu->getRenderedBlockCount();
+void ChunkManager::remeshIfMissingBorders(const ChunkCoord& coord)
+{
+	const ChunkEntry* entry = chunks_.find(coord);
+	if (!entry)
+	{
+		deferredRemesh_.erase(coord);
+		return;
+	}
 
-		ChunkDrawItem item;
-		item.chunkOrigin = glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
-		item.gpu = entry->gpu;
-		item.opaqueIndexCount = static_cast<uint32_t>(cpu->opaqueIndexCount());
-		item.renderedBlockCount = cpu->getRenderedBlockCount();
-		item.geometryVersion = entry->geometryVersion;
+	// neighbours that unloaded do not matter, their faces point out of view
+	if ((residentNeighborMask(coord) & ~entry->meshedBorders) == 0)
+	{
+		deferredRemesh_.erase(coord);
+		return;
+	}
 
-		opaqueDrawList_.items.push_back(item);
+	// wait for neighbours still streaming in, one re-mesh covers them all
+	for (int side = 0; side < ChunkBorders::SIDE_COUNT; ++side)
+	{
+		ChunkCoord neighbor = ChunkBorders::neighborOf(coord, static_cast<ChunkBorders::Side>(side));
+		if (queuedChunks_.find(neighbor) != queuedChunks_.end())
+		{
+			deferredRemesh_.insert(coord);
+			return;
+		}
 	} // end for
 
-	opaqueDrawList_.frameChunksRendered = frameChunksRendered_;
-	opaqueDrawList_.frameBlocksRendered = frameBlocksRendered_;
-} // end of buildOpaqueDrawList()
+	deferredRemesh_.erase(coord);
+	requestRemesh(coord);
+} // end of remeshIfMissingBorders()
 
-void ChunkManager::buildWaterDrawList(
-	const glm::mat4& view, 
-	const glm::mat4& proj, 
-	ChunkDrawList& out
-)
+void ChunkManager::requestRemesh(const ChunkCoord& coord)
 {
-	out.clear();
+	ChunkEntry* entry = chunks_.find(coord);
+	if (!entry || entry->remeshPending)
+	{
+		return;
+	}
 
-	int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
-	int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
-	int maxDist2 = viewRadius_ * viewRadius_;
+	entry->remeshPending = true;
+	jobSystem_->submitRemesh(entry->cpu->getChunk(), gatherBorders(coord), entry->contentVersion);
+} // end of requestRemesh()
 
-	// get frustum planes
-	Frustum fr = ExtractFrustumPlanes(proj * view);
-	for (auto& [coord, entry] : chunks_)
+void ChunkManager::retireEntry(ChunkEntry& entry)
+{
+	ChunkData& chunk = entry.cpu->getChunk();
+	if (chunk.m_dirty)
+	{
+		saveWorld_.queueChunkSave(chunk, worldName_);
+		chunk.m_dirty = false;
+	}
+	else if (chunk.m_cachePending && !cacheName_.empty())
 	{
-		ChunkMesh* cpu = entry->cpu.get();
+		saveWorld_.queueChunkSave(chunk, cacheName_);
+	}
+	chunk.m_cachePending = false;
 
-		// skip empty meshes
-		if (cpu->waterIndexCount() <= 0) continue;
+	meshSlots_.release(entry.gpuHandle);
+	entry.gpuHandle = {};
+} // end of retireEntry()
 
-		// chunkX, chunkZ
-		int chunkX = cpu->getChunk().m_chunkX;
-		int chunkZ = cpu->getChunk().m_chunkZ;
+void ChunkManager::updateLod(int camChunkX, int camChunkZ, GPUCommandContext uploadContext, bool canUpload)
+{
+	const ChunkCoord center{ camChunkX, camChunkZ };
+	if (lodDirty_ || !(lodCenter_ == center))
+	{
+		lodCenter_ = center;
+		lodDirty_ = false;
 
-		// distance culling
-		int dx = chunkX - camChunkX;
-		int dz = chunkZ - camChunkZ;
-		int dist2 = dx * dx + dz * dz;
-		if (enableDistanceCulling_ && dist2 > maxDist2)
+		for (auto it = lodChunks_.begin(); it != lodChunks_.end(); ++it)
 		{
-			continue;
+			if (lodStepAt(it->coord, camChunkX, camChunkZ) == 0)
+			{
+				meshSlots_.release(it->value->gpuHandle);
+				lodChunks_.erase(it->coord);
+			}
+		} // end for
+
+		// missing or at another step, nearest first
+		lodRequests_.clear();
+		const int r = (lodRadius_ > viewRadius_) ? lodRadius_ : -1;
+		for (int dz = -r; dz <= r; ++dz)
+		{
+			for (int dx = -r; dx <= r; ++dx)
+			{
+				const ChunkCoord coord{ camChunkX + dx, camChunkZ + dz };
+				const int step = lodStepAt(coord, camChunkX, camChunkZ);
+				if (step == 0)
+				{
+					continue;
+				}
+
+				const ChunkLodEntry* entry = lodChunks_.find(coord);
+				const auto queued = lodQueued_.find(coord);
+				if ((entry && entry->step == step) ||
+					(queued != lodQueued_.end() && queued->second == step))
+				{
+					continue;
+				}
+
+				lodRequests_.push_back({ dx * dx + dz * dz, coord, step });
+			} // end for
+		} // end for
+
+		std::sort(lodRequests_.begin(), lodRequests_.end(),
+			[](const LodRequest& a, const LodRequest& b)
+			{
+				return a.dist2 > b.dist2;
+			});
+	}
+
+	while (lodInFlight_ < maxLodJobsInFlight_ && !lodRequests_.empty())
+	{
+		const LodRequest request = lodRequests_.back();
+		lodRequests_.pop_back();
+
+		jobSystem_->submitLod(request.coord, request.step);
+		lodQueued_[request.coord] = request.step;
+		++lodInFlight_;
+	} // end while
+
+	int uploaded = 0;
+	while (canUpload && !readyLods_.empty() && uploaded < maxLodUploadsPerFrame_)
+	{
+		ChunkJobResult ready = std::move(readyLods_.front());
+		readyLods_.pop_front();
+
+		const auto queued = lodQueued_.find(ready.coord);
+		if (queued != lodQueued_.end() && queued->second == ready.lodStep)
+		{
+			lodQueued_.erase(queued);
 		}
 
-		// set AABB
-		AABB box = ChunkWorldAABB(chunkX, chunkZ);
-		if (enableFrustumCulling_ && !IntersectsFrustum(box, fr))
+		// left the ring or changed step while in flight
+		if (lodStepAt(ready.coord, camChunkX, camChunkZ) != ready.lodStep)
 		{
 			continue;
 		}
 
-		ChunkDrawItem item;
-		item.chunkOrigin = glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
-		item.gpu = entry->gpu;
-		item.waterIndexCount = static_cast<uint32_t>(std::max(0, cpu->waterIndexCount()));
-		item.geometryVersion = entry->geometryVersion;
+		ChunkLodEntry* entry = lodChunks_.find(ready.coord);
+		if (!entry)
+		{
+			std::unique_ptr<ChunkLodEntry> created = std::make_unique<ChunkLodEntry>();
+			created->gpu = gpuBackend_.create();
+			created->gpuHandle = meshSlots_.acquire(created->gpu.get());
+			entry = created.get();
 
-		out.items.push_back(item);
-	} // end for
-} // end of buildWaterDrawList()
+			if (std::unique_ptr<ChunkLodEntry> displaced = lodChunks_.insert(ready.coord, std::move(created)))
+			{
+				meshSlots_.release(displaced->gpuHandle);
+			}
+		}
 
-void ChunkManager::buildWaterDrawList(
-	const glm::mat4& view, 
-	const glm::mat4& proj
-)
+		entry->gpu->upload(uploadContext, *ready.lod);
+		entry->step = ready.lodStep;
+		entry->opaqueIndexCount = static_cast<uint32_t>(std::max(0, ready.lod->opaqueIndexCount));
+		entry->minY = ready.lod->minY;
+		entry->maxY = ready.lod->maxY;
+		++entry->geometryVersion;
+		++uploaded;
+	} // end while
+} // end of updateLod()
+
+int ChunkManager::lodStepAt(const ChunkCoord& coord, int camChunkX, int camChunkZ) const
 {
-	waterDrawList_.clear();
+	const int dx = coord.x - camChunkX;
+	const int dz = coord.z - camChunkZ;
+	const int dist2 = dx * dx + dz * dz;
+	const int inner = std::max(0, viewRadius_ - lodOverlap_);
+	if (lodRadius_ <= viewRadius_ || dist2 > lodRadius_ * lodRadius_ || dist2 <= inner * inner)
+	{
+		return 0;
+	}
 
-	int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
-	int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
-	int maxDist2 = viewRadius_ * viewRadius_;
+	return ChunkLodMesher::stepFor(dist2, viewRadius_);
+} // end of lodStepAt()
 
-	// get frustum planes
-	Frustum fr = ExtractFrustumPlanes(proj * view);
-	for (auto& [coord, entry] : chunks_)
+void ChunkManager::cullLod(const ChunkCullView* views, size_t viewCount, size_t occlusionView, ChunkViewLists* out)
+{
+	if (lodChunks_.empty())
 	{
-		ChunkMesh* cpu = entry->cpu.get();
-
-		// skip empty meshes
-		if (cpu->waterIndexCount() <= 0) continue;
+		return;
+	}
 
-		// chunkX, chunkZ
-		int chunkX = cpu->getChunk().m_chunkX;
-		int chunkZ = cpu->getChunk().m_chunkZ;
+	const int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
+	const int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
+	const int maxDist2 = viewRadius_ * viewRadius_;
 
-		// distance culling
-		int dx = chunkX - camChunkX;
-		int dz = chunkZ - camChunkZ;
-		int dist2 = dx * dx + dz * dz;
-		if (enableDistanceCulling_ && dist2 > maxDist2)
+	for (const auto& [coord, entry] : lodChunks_)
+	{
+		if (entry->opaqueIndexCount == 0)
 		{
 			continue;
 		}
 
-		// set AABB
-		AABB box = ChunkWorldAABB(chunkX, chunkZ);
-		if (enableFrustumCulling_ && !IntersectsFrustum(box, fr))
+		// the full detail chunk is drawn instead
+		const int dx = coord.x - camChunkX;
+		const int dz = coord.z - camChunkZ;
+		if (chunks_.contains(coord) && (!enableDistanceCulling_ || dx * dx + dz * dz <= maxDist2))
 		{
 			continue;
 		}
 
 		ChunkDrawItem item;
-		item.chunkOrigin = glm::vec3(chunkX * CHUNK_SIZE, 0.0f, chunkZ * CHUNK_SIZE);
-		item.gpu = entry->gpu;
-		item.waterIndexCount = static_cast<uint32_t>(std::max(0, cpu->waterIndexCount()));
+		item.chunkOrigin = ChunkWorldOrigin(coord.x, coord.z);
+		item.mesh = entry->gpuHandle;
+		item.opaqueIndexCount = entry->opaqueIndexCount;
 		item.geometryVersion = entry->geometryVersion;
 
-		waterDrawList_.items.push_back(item);
+		const AABB box{
+			item.chunkOrigin + glm::vec3(0.0f, entry->minY, 0.0f),
+			item.chunkOrigin + glm::vec3(CHUNK_SIZE, entry->maxY, CHUNK_SIZE)
+		};
+
+		for (size_t v = 0; v < viewCount; ++v)
+		{
+			if (!(views[v].lists & ChunkCullView::Lod) || !views[v].frustum)
+			{
+				continue;
+			}
+			if (enableFrustumCulling_ && !IntersectsFrustum(box, cullFrustums_[v]))
+			{
+				continue;
+			}
+			if (v == occlusionView && occlusion_.isOccluded(box))
+			{
+				continue;
+			}
+
+			ChunkDrawList& list = out[v].lod;
+			list.items.push_back(item);
+			list.frameChunksRendered++;
+			list.frameTrianglesRendered += item.opaqueIndexCount / 3;
+		} // end for
 	} // end for
-} // end of buildWaterDrawList()
+} // end of cullLod()
 
-BlockID ChunkManager::getBlock(int wx, int wy, int wz) const
+void ChunkManager::enqueueMissingChunks()
 {
-	int chunkX = static_cast<int>(std::floor(wx / static_cast<float>(CHUNK_SIZE)));
-	int chunkZ = static_cast<int>(std::floor(wz / static_cast<float>(CHUNK_SIZE)));
-
-	ChunkCoord coord{ chunkX, chunkZ };
-	auto it = chunks_.find(coord);
-	if (it == chunks_.end())
+	const ChunkCoord center{ streamCenterX_, streamCenterZ_ };
+	if (!streamWindowDirty_ && enqueuedCenter_ == center)
 	{
-		return BlockID::Air;
+		return;
 	}
 
-	int localX = wx - chunkX * CHUNK_SIZE;
-	int localY = wy;
-	int localZ = wz - chunkZ * CHUNK_SIZE;
-
-	if (localX < 0 || localX >= CHUNK_SIZE ||
-		localY < 0 || localY >= CHUNK_SIZE_Y ||
-		localZ < 0 || localZ >= CHUNK_SIZE)
+	// after a recenter only the cells outside the previous window are new
+	const int r = viewRadius_;
+	const ChunkCoord prev = enqueuedCenter_;
+	for (int z = center.z - r; z <= center.z + r; ++z)
 	{
-		return BlockID::Air;
-	}
+		const bool rowNew = streamWindowDirty_ || std::abs(z - prev.z) > r;
+		const int spans[2][2] = {
+			{ center.x - r, rowNew ? center.x + r : std::min(center.x + r, prev.x - r - 1) },
+			{ rowNew ? center.x + r + 1 : std::max(center.x - r, prev.x + r + 1), center.x + r }
+		};
 
-	return it->second->cpu->getBlock(localX, localY, localZ);
-} // end of getBlock()
+		for (const auto& span : spans)
+		{
+			for (int x = span[0]; x <= span[1]; ++x)
+			{
+				const ChunkCoord coord{ x, z };
+				if (!chunks_.contains(coord) && queuedChunks_.insert(coord).second)
+				{
+					pendingChunks_.push(coord);
+				}
+			} // end for
+		} // end for
+	} // end for
 
-void ChunkManager::setBlock(int wx, int wy, int wz, BlockID id)
+	enqueuedCenter_ = center;
+	streamWindowDirty_ = false;
+} // end of enqueueMissingChunks()
+
+void ChunkManager::prefetchRegions(int predictedChunkX, int predictedChunkZ)
 {
-	int chunkX = static_cast<int>(std::floor(wx / static_cast<float>(CHUNK_SIZE)));
-	int chunkZ = static_cast<int>(std::floor(wz / static_cast<float>(CHUNK_SIZE)));
+	// regions the predicted window reaches and the current one does not,
+	// any region the current window touches was read by its chunk loads
+	const int r = viewRadius_;
+	const RegionCoord lo = RegionFile::regionOf(predictedChunkX - r, predictedChunkZ - r);
+	const RegionCoord hi = RegionFile::regionOf(predictedChunkX + r, predictedChunkZ + r);
+	const RegionCoord windowLo = RegionFile::regionOf(streamCenterX_ - r, streamCenterZ_ - r);
+	const RegionCoord windowHi = RegionFile::regionOf(streamCenterX_ + r, streamCenterZ_ + r);
+
+	for (int rz = lo.z; rz <= hi.z; ++rz)
+	{
+		for (int rx = lo.x; rx <= hi.x; ++rx)
+		{
+			const RegionCoord region{ rx, rz };
+			if ((rx >= windowLo.x && rx <= windowHi.x && rz >= windowLo.z && rz <= windowHi.z) ||
+				std::find(prefetchedRegions_.begin(), prefetchedRegions_.end(), region) != prefetchedRegions_.end())
+			{
+				continue;
+			}
 
-	ChunkCoord coord{ chunkX, chunkZ };
-	auto it = chunks_.find(coord);
-	if (it == chunks_.end())
+			// remember the last few requests
+			if (prefetchedRegions_.size() >= maxPrefetchedRegions_)
+			{
+				prefetchedRegions_.erase(prefetchedRegions_.begin());
+			}
+			prefetchedRegions_.push_back(region);
+
+			jobSystem_->submitPrefetch({ rx * Region_Constants::REGION_SIZE, rz * Region_Constants::REGION_SIZE });
+			++regionsPrefetched_;
+		} // end for
+	} // end for
+} // end of prefetchRegions()
+
+void ChunkManager::refreshCullBounds()
+{
+	if (!cullBoundsDirty_)
 	{
 		return;
 	}
 
-	int localX = wx - chunkX * CHUNK_SIZE;
-	int localY = wy;
-	int localZ = wz - chunkZ * CHUNK_SIZE;
+	cullBounds_.clear();
+	cullEntries_.clear();
 
-	if (localY < 0 || localY >= CHUNK_SIZE_Y)
+	for (auto& [coord, entry] : chunks_)
+	{
+		cullBounds_.push(coord.x, coord.z, ChunkWorldAABB(coord.x, coord.z, entry->cpu->data()));
+		cullEntries_.push_back(entry.get());
+	} // end for
+
+	cullBoundsDirty_ = false;
+	cullRangeDirty_ = true;
+} // end of refreshCullBounds()
+
+void ChunkManager::refreshCullRange(int camChunkX, int camChunkZ)
+{
+	if (enableIncrementalCulling_ && !cullRangeDirty_ &&
+		cullRangeChunk_ == ChunkCoord{ camChunkX, camChunkZ } &&
+		cullRangeRadius_ == viewRadius_ && cullRangeDistance_ == enableDistanceCulling_)
 	{
 		return;
 	}
 
-	it->second->cpu->setBlock(localX, localY, localZ, id);
+	const size_t count = cullBounds_.size();
+	const int maxDist2 = viewRadius_ * viewRadius_;
+	cullInRange_.assign((count + 63) / 64, 0ull);
+	glm::vec3 boundsMin(FLT_MAX);
+	glm::vec3 boundsMax(-FLT_MAX);
+	bool boundsAny = false;
 
-	// mark chunk as modified
-	it->second->cpu->getChunk().m_dirty = true;
+	for (size_t i = 0; i < count; ++i)
+	{
+		// skip empty meshes
+		const ChunkMesh* cpu = cullEntries_[i]->cpu.get();
+		if (cpu->opaqueIndexCount() <= 0 && cpu->waterIndexCount() <= 0) continue;
 
-	if (queuedDirtyChunks_.insert(coord).second)
+		// distance culling
+		const int dx = cullBounds_.chunkX[i] - camChunkX;
+		const int dz = cullBounds_.chunkZ[i] - camChunkZ;
+		if (enableDistanceCulling_ && dx * dx + dz * dz > maxDist2)
+		{
+			continue;
+		}
+
+		cullInRange_[i >> 6] |= 1ull << (i & 63);
+
+		// tight boxes, the shadow fit only covers geometry
+		const AABB box = cullBounds_.box(i);
+		boundsMin = glm::min(boundsMin, box.min);
+		boundsMax = glm::max(boundsMax, box.max);
+		boundsAny = true;
+	} // end for
+
+	frameBoundsAny_ = boundsAny;
+	frameBoundsMin_ = boundsMin;
+	frameBoundsMax_ = boundsMax;
+
+	cullRangeDirty_ = false;
+	cullRangeChunk_ = { camChunkX, camChunkZ };
+	cullRangeRadius_ = viewRadius_;
+	cullRangeDistance_ = enableDistanceCulling_;
+	frameChunksReevaluated_ += static_cast<uint32_t>(count);
+} // end of refreshCullRange()
+
+void ChunkManager::cullViews(const ChunkCullView* views, size_t viewCount, ChunkViewLists* out)
+{
+	const auto start = std::chrono::steady_clock::now();
+	refreshCullBounds();
+
+	int camChunkX = static_cast<int>(std::floor(lastCameraPos_.x / CHUNK_SIZE));
+	int camChunkZ = static_cast<int>(std::floor(lastCameraPos_.z / CHUNK_SIZE));
+	refreshCullRange(camChunkX, camChunkZ);
+
+	// batched frustum test per view up front, the sweep only reads bits
+	if (cullVisible_.size() < viewCount)
 	{
-		dirtyChunks_.push(coord);
+		cullVisible_.resize(viewCount);
+		cullFrustums_.resize(viewCount);
 	}
-} // end of setBlock()
 
-void ChunkManager::placeOrRemoveBlock(bool shouldPlace, const glm::vec3& origin, const glm::vec3& dir)
-{
-	BlockHit hit = raycastBlocks(origin, dir);
-	// place op
-	if (shouldPlace)
+	// one view per sweep gets occlusion culling
+	size_t occlusionView = viewCount;
+	for (size_t v = 0; v < viewCount; ++v)
 	{
-		if (hit.hit)
+		if (views[v].frustum && enableFrustumCulling_)
 		{
-			// DISALLOW block place in water
-			if (getBlock(hit.block.x, hit.block.y, hit.block.z) == BlockID::Water) return;
+			cullFrustums_[v] = ExtractFrustumPlanes(views[v].proj * views[v].view);
+			CullFrustum(cullBounds_, cullFrustums_[v], cullVisible_[v]);
 
+			if (views[v].occlusion && enableOcclusionCulling_ && occlusionView == viewCount)
+			{
+				occlusionView = v;
+			}
+		}
+		else
+		{
+			cullVisible_[v].assign((cullBounds_.size() + 63) / 64, ~0ull);
+		}
 
-			glm::ivec3 placePos = hit.block + hit.normal;
-			setBlock(placePos.x, placePos.y, placePos.z, lastBlockUsed_);
-			// add block to counter
-			++frameBlocksRendered_;
+		out[v].opaque.clear();
+		out[v].water.clear();
+		out[v].combined.clear();
+		out[v].lod.clear();
+		out[v].opaque.meshes = &meshSlots_;
+		out[v].water.meshes = &meshSlots_;
+		out[v].combined.meshes = &meshSlots_;
+		out[v].lod.meshes = &meshSlots_;
+	} // end for
 
-			// save
-			saveWorld();
-		}
+	// occluders and the cave walk start at the occlusion view's eye
+	bool caves = false;
+	if (occlusionView < viewCount)
+	{
+		const glm::vec3 eye = glm::vec3(glm::inverse(views[occlusionView].view)[3]);
+		buildOcclusion(views[occlusionView], cullVisible_[occlusionView], eye);
+		caves = enableCaveCulling_ && traverseCaves(cullFrustums_[occlusionView], eye);
 	}
-	// destroy op
-	else
+
+	// only in range chunks some view sees are visited
+	const size_t words = cullInRange_.size();
+	cullSweep_.assign(words, 0ull);
+	for (size_t v = 0; v < viewCount; ++v)
 	{
-		if (hit.hit)
+		for (size_t w = 0; w < words; ++w)
 		{
-			// DISALLOW water deletion by player (direct water block or blocks next to water)
-			if (getBlock(hit.block.x, hit.block.y, hit.block.z) == BlockID::Water
-				|| getBlock(hit.block.x - 1, hit.block.y, hit.block.z) == BlockID::Water
-				|| getBlock(hit.block.x + 1, hit.block.y, hit.block.z) == BlockID::Water
-				|| getBlock(hit.block.x, hit.block.y, hit.block.z - 1) == BlockID::Water
-				|| getBlock(hit.block.x, hit.block.y, hit.block.z + 1) == BlockID::Water
-				//|| getBlock(hit.block.x, hit.block.y - 1, hit.block.z) == BlockID::Water
-				|| getBlock(hit.block.x, hit.block.y + 1, hit.block.z) == BlockID::Water) return;
+			cullSweep_[w] |= cullVisible_[v][w];
+		} // end for
+	} // end for
 
-			setBlock(hit.block.x, hit.block.y, hit.block.z, BlockID::Air);
-			// remove block from counter
-			--frameBlocksRendered_;
+	for (size_t w = 0; w < words; ++w)
+	{
+		for (uint64_t bits = cullSweep_[w] & cullInRange_[w]; bits != 0; bits &= bits - 1)
+		{
+			const size_t i = w * 64 + CountTrailingZeros64(bits);
+
+			const int chunkX = cullBounds_.chunkX[i];
+			const int chunkZ = cullBounds_.chunkZ[i];
+			const AABB box = cullBounds_.box(i);
+
+			const ChunkEntry& entry = *cullEntries_[i];
+			const ChunkMesh* cpu = entry.cpu.get();
+			const ChunkMeshData& mesh = cpu->data();
+			const int opaqueCount = cpu->opaqueIndexCount();
+			const int waterCount = cpu->waterIndexCount();
+
+			ChunkDrawItem item;
+			item.chunkOrigin = ChunkWorldOrigin(chunkX, chunkZ);
+			item.mesh = entry.gpuHandle;
+			item.opaqueIndexCount = static_cast<uint32_t>(std::max(0, opaqueCount));
+			item.waterIndexCount = static_cast<uint32_t>(std::max(0, waterCount));
+			item.renderedBlockCount = cpu->getRenderedBlockCount();
+			item.geometryVersion = entry.geometryVersion;
+
+			for (size_t v = 0; v < viewCount; ++v)
+			{
+				const ChunkCullView& view = views[v];
+				if ((cullVisible_[v][i >> 6] & (1ull << (i & 63))) == 0)
+				{
+					continue;
+				}
+
+				ChunkViewLists& lists = out[v];
+				// RT needs the chunks behind occluders too
+				if ((view.lists & ChunkCullView::Combined))
+				{
+					lists.combined.items.push_back(item);
+					lists.combined.frameChunksRendered++;
+					lists.combined.frameBlocksRendered += item.renderedBlockCount;
+					lists.combined.frameTrianglesRendered += item.opaqueIndexCount / 3;
+				}
+
+				const bool occlusion = (v == occlusionView);
+				const uint32_t reachable = (occlusion && caves) ? caveSections({ chunkX, chunkZ }) : MESH_ALL_SECTIONS;
+				if (reachable == 0 || (occlusion && occlusion_.isOccluded(box)))
+				{
+					lists.opaque.frameChunksOccluded++;
+					continue;
+				}
+
+				if ((view.lists & ChunkCullView::Opaque) && opaqueCount > 0)
+				{
+					// sections above or below the frustum are skipped
+					uint32_t sections = mesh.opaqueSectionMask;
+					if (view.frustum && enableFrustumCulling_)
+					{
+						const AABB column{ item.chunkOrigin, item.chunkOrigin + glm::vec3(CHUNK_SIZE, 0.0f, CHUNK_SIZE) };
+						sections = CullSections(column, mesh.opaqueSections.data(), sections, cullFrustums_[v]);
+					}
+					// and so are sections hidden behind the occluders or not
+					// reachable from the camera through caves
+					const uint32_t inFrustum = sections;
+					for (int s = 0; occlusion && s < MESH_SECTION_COUNT; ++s)
+					{
+						if ((sections & (1u << s)) == 0)
+						{
+							continue;
+						}
+						if ((SectionSpanMask(mesh.opaqueSections[s]) & reachable) == 0)
+						{
+							sections &= ~(1u << s);
+							continue;
+						}
+
+						const AABB sectionBox{
+							item.chunkOrigin + glm::vec3(0.0f, mesh.opaqueSections[s].minY, 0.0f),
+							item.chunkOrigin + glm::vec3(CHUNK_SIZE, mesh.opaqueSections[s].maxY, CHUNK_SIZE)
+						};
+						if (occlusion_.isOccluded(sectionBox))
+						{
+							sections &= ~(1u << s);
+						}
+					} // end for
+
+					uint32_t indices = 0;
+					for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+					{
+						indices += (sections & (1u << s)) ? mesh.opaqueSections[s].indexCount : 0;
+					} // end for
+
+					if (indices > 0)
+					{
+						lists.opaque.items.push_back(item);
+						lists.opaque.items.back().waterIndexCount = 0;
+						lists.opaque.items.back().opaqueSectionMask = sections;
+						lists.opaque.frameChunksRendered++;
+						lists.opaque.frameBlocksRendered += item.renderedBlockCount;
+						lists.opaque.frameTrianglesRendered += indices / 3;
+					}
+					else if (occlusion && inFrustum != 0 && waterCount <= 0)
+					{
+						lists.opaque.frameChunksOccluded++;
+					}
+				}
+				if ((view.lists & ChunkCullView::Water) && waterCount > 0)
+				{
+					lists.water.items.push_back(item);
+					lists.water.items.back().opaqueIndexCount = 0;
+				}
+			} // end for
+		} // end for
+	} // end for
 
-			// save
-			saveWorld();
+	cullLod(views, viewCount, occlusionView, out);
+
+	// distance only views have no eye to sort by, the shadow view sorts
+	// from the light position
+	for (size_t v = 0; v < viewCount; ++v)
+	{
+		if (views[v].frustum)
+		{
+			const glm::vec3 eye = glm::vec3(glm::inverse(views[v].view)[3]);
+			drawSorter_.sort(out[v].opaque.items, eye, ChunkDrawSorter::Order::FrontToBack);
+			drawSorter_.sort(out[v].water.items, eye, ChunkDrawSorter::Order::BackToFront);
+			drawSorter_.sort(out[v].lod.items, eye, ChunkDrawSorter::Order::FrontToBack);
 		}
+	} // end for
+
+	if (viewCount > 0)
+	{
+		frameDrawListMs_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
 	}
-} // end of placeOrRemoveBlock()
 
-void ChunkManager::saveWorld()
+	frameBoundsValid_ = true;
+} // end of cullViews()
+
+void ChunkManager::buildOcclusion(const ChunkCullView& view, const std::vector<uint64_t>& visible, const glm::vec3& eye)
 {
-	// save all loaded chunks that have been modified
-	for (auto& [coord, chunkMesh] : chunks_)
+	occlusion_.begin(view.proj * view.view);
+	const int camChunkX = FloorDiv(static_cast<int>(std::floor(eye.x)), CHUNK_SIZE);
+	const int camChunkZ = FloorDiv(static_cast<int>(std::floor(eye.z)), CHUNK_SIZE);
+
+	// solid section runs and the ground under the surface of the nearest
+	// visible chunks are the occluders
+	const int maxDist2 = occluderRadius_ * occluderRadius_;
+	const size_t count = cullBounds_.size();
+	for (size_t i = 0; i < count; ++i)
 	{
-		ChunkData& chunk = chunkMesh->cpu->getChunk();
-
-		if (!chunk.m_dirty)
+		const int dx = cullBounds_.chunkX[i] - camChunkX;
+		const int dz = cullBounds_.chunkZ[i] - camChunkZ;
+		if (dx * dx + dz * dz > maxDist2 || (visible[i >> 6] & (1ull << (i & 63))) == 0)
 		{
 			continue;
 		}
-		saveWorld_.saveChunkToFile(chunk, "HelloWorld");
-		chunk.m_dirty = false;
 
+		const ChunkMeshData& mesh = cullEntries_[i]->cpu->data();
+		const uint32_t solid = mesh.solidSectionMask;
+		const glm::vec3 origin = ChunkWorldOrigin(cullBounds_.chunkX[i], cullBounds_.chunkZ[i]);
+		for (int first = 0; first < MESH_SECTION_COUNT; ++first)
+		{
+			if ((solid & (1u << first)) == 0)
+			{
+				continue;
+			}
+
+			// one box per run of solid sections
+			int last = first;
+			while (last + 1 < MESH_SECTION_COUNT && (solid & (1u << (last + 1))))
+			{
+				++last;
+			} // end while
+
+			occlusion_.addOccluder({
+				origin + glm::vec3(0.0f, static_cast<float>(first * MESH_SECTION_HEIGHT), 0.0f),
+				origin + glm::vec3(CHUNK_SIZE, static_cast<float>((last + 1) * MESH_SECTION_HEIGHT), CHUNK_SIZE)
+			});
+			first = last;
+		} // end for
+
+		// one box for the ground, a finer split per column tile costs more
+		// raster time than it hides
+		if (mesh.groundOccluderMinY < mesh.groundOccluderMaxY)
+		{
+			occlusion_.addOccluder({
+				origin + glm::vec3(0.0f, static_cast<float>(mesh.groundOccluderMinY), 0.0f),
+				origin + glm::vec3(CHUNK_SIZE, static_cast<float>(mesh.groundOccluderMaxY), CHUNK_SIZE)
+			});
+		}
 	} // end for
-} // end of saveWorld()
 
+	occlusion_.finish();
+} // end of buildOcclusion()
+
+bool ChunkManager::traverseCaves(const Frustum& frustum, const glm::vec3& eye)
+{
+	if (eye.y < 0.0f || eye.y >= static_cast<float>(CHUNK_SIZE_Y))
+	{
+		return false;
+	}
+
+	const int camChunkX = FloorDiv(static_cast<int>(std::floor(eye.x)), CHUNK_SIZE);
+	const int camChunkZ = FloorDiv(static_cast<int>(std::floor(eye.z)), CHUNK_SIZE);
+	const int camSection = static_cast<int>(eye.y) / MESH_SECTION_HEIGHT;
+	if (!chunks_.contains({ camChunkX, camChunkZ }))
+	{
+		return false;
+	}
+
+	// any square of 2 * radius + 1 chunks maps to distinct slots
+	int side = 1;
+	while (side < 2 * viewRadius_ + 1)
+	{
+		side <<= 1;
+	} // end while
+	if (side != caveSide_)
+	{
+		caveSide_ = side;
+		caveGrid_.assign(static_cast<size_t>(side) * side, {});
+	}
+	++caveStamp_;
+
+	// marks the section, false when it was already reached
+	auto reach = [&](int cx, int cz, int sy)
+		{
+			CaveSlot& slot = caveGrid_[static_cast<size_t>(cx & (side - 1)) + static_cast<size_t>(cz & (side - 1)) * side];
+			if (slot.stamp != caveStamp_ || !(slot.coord == ChunkCoord{ cx, cz }))
+			{
+				slot.coord = { cx, cz };
+				slot.stamp = caveStamp_;
+				slot.sections = 0;
+			}
+			if (slot.sections & (1u << sy))
+			{
+				return false;
+			}
+			slot.sections |= 1u << sy;
+			return true;
+		};
+
+	static constexpr int offsets[6][3] = {
+		{ 1, 0, 0 }, { -1, 0, 0 },
+		{ 0, 1, 0 }, { 0, -1, 0 },
+		{ 0, 0, 1 }, { 0, 0, -1 }
+	};
+
+	caveQueue_.clear();
+	caveQueue_.push_back({ camChunkX, camChunkZ, camSection, -1, 0 });
+	reach(camChunkX, camChunkZ, camSection);
+
+	// breadth first over sections, leaving a section through face f needs
+	// a see-through path from the face it was entered by, and the walk
+	// never turns back against a direction it already moved in
+	for (size_t head = 0; head < caveQueue_.size(); ++head)
+	{
+		const CaveNode node = caveQueue_[head];
+		const uint32_t connectivity = chunks_.find({ node.chunkX, node.chunkZ })->cpu->data().sectionConnectivity[node.section];
+
+		for (int face = 0; face < 6; ++face)
+		{
+			if ((node.directions & (1u << (face ^ 1))) ||
+				(node.entryFace >= 0 && (connectivity & SectionFacePair(node.entryFace, face)) == 0))
+			{
+				continue;
+			}
+
+			const int cx = node.chunkX + offsets[face][0];
+			const int sy = node.section + offsets[face][1];
+			const int cz = node.chunkZ + offsets[face][2];
+			if (sy < 0 || sy >= MESH_SECTION_COUNT ||
+				std::abs(cx - camChunkX) > viewRadius_ || std::abs(cz - camChunkZ) > viewRadius_ ||
+				!chunks_.contains({ cx, cz }))
+			{
+				continue;
+			}
+
+			const glm::vec3 origin(cx * CHUNK_SIZE, sy * MESH_SECTION_HEIGHT, cz * CHUNK_SIZE);
+			if (!IntersectsFrustum({ origin, origin + glm::vec3(CHUNK_SIZE, MESH_SECTION_HEIGHT, CHUNK_SIZE) }, frustum) ||
+				!reach(cx, cz, sy))
+			{
+				continue;
+			}
+
+			// open terrain reaches most of the world anyway, not worth the walk
+			if (caveQueue_.size() >= caveSectionBudget_)
+			{
+				return false;
+			}
+			caveQueue_.push_back({ cx, cz, sy, static_cast<int8_t>(face ^ 1), static_cast<uint8_t>(node.directions | (1u << face)) });
+		} // end for
+	} // end for
+
+	return true;
+} // end of traverseCaves()
+
+uint32_t ChunkManager::caveSections(const ChunkCoord& coord) const
+{
+	if (caveSide_ == 0)
+	{
+		return 0;
+	}
+
+	const CaveSlot& slot = caveGrid_[static_cast<size_t>(coord.x & (caveSide_ - 1)) + static_cast<size_t>(coord.z & (caveSide_ - 1)) * caveSide_];
+	return (slot.stamp == caveStamp_ && slot.coord == coord) ? slot.sections : 0;
+} // end of caveSections()
+
+const ChunkViewLists* ChunkManager::findFrameView(const glm::mat4& view, const glm::mat4& proj, uint32_t lists) const
+{
+	for (size_t i = 0; i < frameViews_.size(); ++i)
+	{
+		const ChunkCullView& frameView = frameViews_[i];
+		if (frameView.frustum && (frameView.lists & lists) &&
+			frameView.view == view && frameView.proj == proj)
+		{
+			return &frameLists_[i];
+		}
+	} // end for
+	return nullptr;
+} // end of findFrameView()
+
+ChunkViewLists& ChunkManager::cullSingleView(const ChunkCullView& view)
+{
+	cullViews(&view, 1, &scratchLists_);
+	scratchView_ = view;
+	return scratchLists_;
+} // end of cullSingleView()
+
+void ChunkManager::countRendered(const ChunkDrawList& list)
+{
+	frameChunksRendered_ = list.frameChunksRendered;
+	frameBlocksRendered_ = list.frameBlocksRendered;
+	frameTrianglesRendered_ = list.frameTrianglesRendered;
+	frameChunksOccluded_ = list.frameChunksOccluded;
+} // end of countRendered()
 
-//--- PRIVATE ---//
 BlockHit ChunkManager::raycastBlocks(const glm::vec3& origin, const glm::vec3& dir) const
 {
 	BlockHit hit;
@@ -2,291 +2,409 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cfloat>
 #include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 //--- HELPER ---//
-// world opaque vertices
-// LAYOUT (32u bits)
-// 0  - 1   : UV corner index
-// 2  - 6   : tileY
-// 7  - 11  : tileX
-// 12 - 14  : normal index
-// 15 - 18  : x pos
-// 19 - 27  : y pos
-// 28 - 31  : z pos
-static inline uint32_t PackVertexU32(
-	uint32_t uvCorner, uint32_t tileX, uint32_t tileY,
-	uint32_t normalIdx, uint32_t x, uint32_t y, uint32_t z)
+// bit helpers for the bitmask mesher, rows are arrays of 64-bit words
+static inline int CountTrailingZeros64(uint64_t v)
 {
-	uint32_t packed{};
-	// uv corner index
-	packed |= (uvCorner & 3u) << 0;
-
-	// UV tileY
-	packed |= (tileY & 31u) << 2;
-	// UV tileX
-	packed |= (tileX & 31u) << 7;
-
-	// normal index
-	packed |= (normalIdx & 7u) << 12;
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, v);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(v);
+#endif
+} // end of CountTrailingZeros64()
+
+static inline int PopCount64(uint64_t v)
+{
+#ifdef _MSC_VER
+	return static_cast<int>(__popcnt64(v));
+#else
+	return __builtin_popcountll(v);
+#endif
+} // end of PopCount64()
+
+static inline uint64_t RangeMask(int bit, int count)
+{
+	// count bits starting at bit, bit + count <= 64
+	return (count >= 64 ? ~0ull : ((1ull << count) - 1ull)) << bit;
+} // end of RangeMask()
 
-	// pos
-	packed |= (x & 15u) << 15;
-	packed |= (y & 511u) << 19;
-	packed |= (z & 15u) << 28;
+static inline int FindFirstSet(const uint64_t* row, int words)
+{
+	for (int w = 0; w < words; ++w)
+	{
+		if (row[w])
+		{
+			return w * 64 + CountTrailingZeros64(row[w]);
+		}
+	} // end for
+	return -1;
+} // end of FindFirstSet()
 
-	return packed;
-} // end of PackVertexU32()
+static inline int RunLength(const uint64_t* row, int i, int limit)
+{
+	// consecutive set bits starting at i, stops at limit
+	int n = 0;
+	while (i + n < limit)
+	{
+		int bit = (i + n) & 63;
+		uint64_t zeros = ~(row[(i + n) >> 6] >> bit);
+		int run = std::min(zeros ? CountTrailingZeros64(zeros) : 64, 64 - bit);
 
+		n += run;
+		if (bit + run < 64)
+		{
+			break;
+		}
+	} // end while
+	return std::min(n, limit - i);
+} // end of RunLength()
 
-//--- PUBLIC ---//
-ChunkMesh::ChunkMesh(
-	int chunkX,
-	int chunkZ,
-	bool autoBuild
-)
-	: chunkData_(chunkX, chunkZ)
+static inline bool TestRange(const uint64_t* row, int i, int count)
 {
-	if (autoBuild)
+	while (count > 0)
 	{
-		buildChunkMesh();
-	}
-} // end of other constructor
-
-ChunkMesh::~ChunkMesh() = default;
+		int bit = i & 63;
+		int n = std::min(count, 64 - bit);
+		uint64_t mask = RangeMask(bit, n);
+		if ((row[i >> 6] & mask) != mask)
+		{
+			return false;
+		}
+		i += n;
+		count -= n;
+	} // end while
+	return true;
+} // end of TestRange()
 
+static inline void ClearRange(uint64_t* row, int i, int count)
+{
+	while (count > 0)
+	{
+		int bit = i & 63;
+		int n = std::min(count, 64 - bit);
+		row[i >> 6] &= ~RangeMask(bit, n);
+		i += n;
+		count -= n;
+	} // end while
+} // end of ClearRange()
+
+static inline bool IsOpaqueBlock(BlockID id)
+{
+	return id != BlockID::Air && id != BlockID::Water;
+} // end of IsOpaqueBlock()
 
-//--- PRIVATE ---//
-void ChunkMesh::buildChunkMesh()
+static inline bool IsTransparentBlock(BlockID id)
 {
-	data_.opaqueVertices.clear();
-	data_.opaqueRTVertices.clear();
-	data_.opaqueIndices.clear();
+	return id == BlockID::Air || id == BlockID::Water || id == BlockID::Tree_Leaf;
+} // end of IsTransparentBlock()
 
-	// check if block is opaque
-	auto isOpaque = [&](BlockID id) {
-		return id != BlockID::Air && id != BlockID::Water;
-		};
+// full cube that nothing shows through
+static inline bool IsOccluderBlock(BlockID id)
+{
+	return !IsTransparentBlock(id) && id != BlockID::Flower;
+} // end of IsOccluderBlock()
 
-	// all attr must match for cells to merge
-	struct MaskCell {
-		bool valid = false;
-		BlockID id{};
-		FaceDir dir{};
-		int tileX = 0;
-		int tileY = 0;
-	};
+static uint32_t SolidSectionMask(const BlockID* blocks)
+{
+	const int sectionVolume = CHUNK_SIZE * CHUNK_SIZE * MESH_SECTION_HEIGHT;
 
-	// create quad data
-	auto emitQuad = [&](glm::ivec3 p0, glm::ivec3 p1, glm::ivec3 p2, glm::ivec3 p3,
-		FaceDir dir, int tileX, int tileY)
+	uint32_t mask = 0;
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		const BlockID* section = blocks + s * sectionVolume;
+		if (std::all_of(section, section + sectionVolume, IsOccluderBlock))
 		{
-			// base vertex index for quad
-			uint32_t start = static_cast<uint32_t>(data_.opaqueVertices.size());
+			mask |= 1u << s;
+		}
+	} // end for
+	return mask;
+} // end of SolidSectionMask()
 
-			// vert pos order
-			glm::ivec3 corners[4] = { p0, p1, p2, p3 };
+// the y range the top solid run of every column shares
+static void GroundOccluder(const BlockID* blocks, ChunkMeshData& data)
+{
+	const int layer = CHUNK_SIZE * CHUNK_SIZE;
 
-			// vert normal
-			glm::vec3 faceNormal{};
-			switch (dir)
+	int minY = 0;
+	int maxY = CHUNK_SIZE_Y;
+	for (int z = 0; z < CHUNK_SIZE; ++z)
+	{
+		for (int x = 0; x < CHUNK_SIZE; ++x)
+		{
+			const BlockID* column = blocks + x + CHUNK_SIZE * z;
+			int top = CHUNK_SIZE_Y - 1;
+			while (top >= 0 && !IsOccluderBlock(column[top * layer]))
 			{
-			case FaceDir::PosX: faceNormal = glm::vec3(1.0f, 0.0f, 0.0f); break;
-			case FaceDir::NegX: faceNormal = glm::vec3(-1.0f, 0.0f, 0.0f); break;
-			case FaceDir::PosY: faceNormal = glm::vec3(0.0f, 1.0f, 0.0f); break;
-			case FaceDir::NegY: faceNormal = glm::vec3(0.0f, -1.0f, 0.0f); break;
-			case FaceDir::PosZ: faceNormal = glm::vec3(0.0f, 0.0f, 1.0f); break;
-			case FaceDir::NegZ: faceNormal = glm::vec3(0.0f, 0.0f, -1.0f); break;
-			default:            faceNormal = glm::vec3(0.0f, 1.0f, 0.0f); break;
-			}
-
-			// pack vertex data
-			for (int c = 0; c < 4; ++c) 
+				--top;
+			} // end while
+			int bottom = top;
+			while (bottom > 0 && IsOccluderBlock(column[(bottom - 1) * layer]))
 			{
-				Vertex v{};
-				v.sample = PackVertexU32(
-					static_cast<uint32_t>(c),
-					static_cast<uint32_t>(tileX), static_cast<uint32_t>(tileY),
-					static_cast<uint32_t>(dir),
-					static_cast<uint32_t>(corners[c].x),
-					static_cast<uint32_t>(corners[c].y),
-					static_cast<uint32_t>(corners[c].z)
-				);
-				data_.opaqueVertices.push_back(v);
-
-				// RT vertex data
-				RTVertex rtv{};
-				rtv.position = glm::vec4(corners[c], 0.0f);
-				// RT normal data
-				rtv.normal = glm::vec4(faceNormal, 0.0f);
-				// RT tile data
-				rtv.tileData = glm::vec4(float(tileX), float(tileY), 0.0f, 0.0f);
-				data_.opaqueRTVertices.push_back(rtv);
-			} // end for
-
-			data_.opaqueIndices.push_back(start + 0);
-			data_.opaqueIndices.push_back(start + 1);
-			data_.opaqueIndices.push_back(start + 2);
-			data_.opaqueIndices.push_back(start + 0);
-			data_.opaqueIndices.push_back(start + 2);
-			data_.opaqueIndices.push_back(start + 3);
-		};
+				--bottom;
+			} // end while
 
-	// chunk size x, y, z
-	const int dims[3] = { CHUNK_SIZE, CHUNK_SIZE_Y, CHUNK_SIZE };
-
-	// sweep axis d (0 = x, 1 = y, 2 = z)
-	for (int d = 0; d < 3; ++d)
-	{
-		// get other two axes for mask
-		int u = (d + 1) % 3;
-		int v = (d + 2) % 3;
+			minY = std::max(minY, bottom);
+			maxY = std::min(maxY, top + 1);
+		} // end for
+	} // end for
 
-		// unit step
-		int q[3] = { 0, 0, 0 };
-		q[d] = 1;
+	data.groundOccluderMinY = static_cast<uint16_t>(minY);
+	data.groundOccluderMaxY = static_cast<uint16_t>(std::max(minY, maxY));
+} // end of GroundOccluder()
 
-		std::vector<MaskCell> mask(dims[u] * dims[v]);
-		int x[3] = { 0, 0, 0 };
+// flood fill of the see-through blocks of one section, every region joins
+// all section faces it touches. rows of x bits per (y, z), a region grows
+// along x with shifts and into the neighbouring rows until it stops changing
+static uint32_t SectionConnectivity(const BlockID* blocks, int section)
+{
+	const int sectionVolume = CHUNK_SIZE * CHUNK_SIZE * MESH_SECTION_HEIGHT;
+	const BlockID* cells = blocks + section * sectionVolume;
 
-		// when x[d] = -1, a is outside chunk and b is slice 0
-		// when x[d] = dims[d]-1, b is outside and a is last slice
-		for (x[d] = -1; x[d] < dims[d]; ++x[d])
+	const uint16_t fullRow = static_cast<uint16_t>((1u << CHUNK_SIZE) - 1u);
+	uint16_t open[MESH_SECTION_HEIGHT][CHUNK_SIZE] = {};
+	bool anyOccluder = false;
+	for (int y = 0; y < MESH_SECTION_HEIGHT; ++y)
+	{
+		for (int z = 0; z < CHUNK_SIZE; ++z)
 		{
-			// build mask for this slice
-			int n = 0;
-			for (x[v] = 0; x[v] < dims[v]; ++x[v])
+			const BlockID* row = cells + CHUNK_SIZE * (z + CHUNK_SIZE * y);
+			uint16_t bits = 0;
+			for (int x = 0; x < CHUNK_SIZE; ++x)
 			{
-				for (x[u] = 0; x[u] < dims[u]; ++x[u], ++n)
-				{
-					BlockID a = BlockID::Air;
-					BlockID b = BlockID::Air;
-
-					if (x[d] >= 0)
-						a = chunkData_.getBlockID(x[0], x[1], x[2]);
-					if (x[d] < dims[d] - 1)
-						b = chunkData_.getBlockID(x[0] + q[0], x[1] + q[1], x[2] + q[2]);
+				bits |= static_cast<uint16_t>(!IsOccluderBlock(row[x])) << x;
+			} // end for
+			open[y][z] = bits;
+			anyOccluder |= bits != fullRow;
+		} // end for
+	} // end for
 
-					// check which side is opaque
-					bool aSolid = (x[d] >= 0) && isOpaque(a);
-					bool bSolid = (x[d] < dims[d] - 1) && isOpaque(b);
+	if (!anyOccluder)
+	{
+		return SectionAllFacePairs();
+	}
 
-					MaskCell cell{};
-					cell.valid = false;
+	uint32_t pairs = 0;
+	for (int seedY = 0; seedY < MESH_SECTION_HEIGHT; ++seedY)
+	{
+		for (int seedZ = 0; seedZ < CHUNK_SIZE; ++seedZ)
+		{
+			while (open[seedY][seedZ])
+			{
+				// grow the region of the lowest open bit
+				uint16_t region[MESH_SECTION_HEIGHT][CHUNK_SIZE] = {};
+				region[seedY][seedZ] = open[seedY][seedZ] & static_cast<uint16_t>(-open[seedY][seedZ]);
 
-					// face between a and b if one is solid and the other is transparent
-					if (aSolid && isTransparent(x[0] + q[0], x[1] + q[1], x[2] + q[2]))
-					{
-						cell.valid = true;
-						cell.id = a;
-						cell.dir = (d == 0) ? FaceDir::PosX : (d == 1) ? FaceDir::PosY : FaceDir::PosZ;
-						getBlockTile(a, cell.tileX, cell.tileY, cell.dir);
-					}
-					else if (bSolid && isTransparent(x[0], x[1], x[2]))
+				// pull in the open bits next to the region, true when it grew
+				auto grow = [&](int y, int z)
 					{
-						cell.valid = true;
-						cell.id = b;
-						cell.dir = (d == 0) ? FaceDir::NegX : (d == 1) ? FaceDir::NegY : FaceDir::NegZ;
-						getBlockTile(b, cell.tileX, cell.tileY, cell.dir);
-					}
-
-					mask[n] = cell;
-				} // end for
-			} // end for
+						uint16_t r = region[y][z];
+						if (y > 0) r |= region[y - 1][z];
+						if (y + 1 < MESH_SECTION_HEIGHT) r |= region[y + 1][z];
+						if (z > 0) r |= region[y][z - 1];
+						if (z + 1 < CHUNK_SIZE) r |= region[y][z + 1];
+						r &= open[y][z];
+
+						uint16_t prev;
+						do
+						{
+							prev = r;
+							r |= ((r << 1) | (r >> 1)) & open[y][z];
+						} while (r != prev);
 
-			// greedy merge rectangles on mask
-			n = 0;
-			for (int j = 0; j < dims[v]; ++j)
-			{
-				for (int i = 0; i < dims[u]; )
+						if (r == region[y][z])
+						{
+							return false;
+						}
+						region[y][z] = r;
+						return true;
+					};
+
+				// rows before the seed are already taken by earlier regions,
+				// so only rows from seedY up to one past the region's top change.
+				// up then down sweeps, paths can wind back down
+				int top = seedY;
+				bool changed = true;
+				while (changed)
 				{
-					MaskCell c = mask[n];
-					if (!c.valid) 
-					{ 
-						++i; 
-						++n; 
-						continue; 
-					}
-
-					int w = 1;
-					while (i + w < dims[u]) 
+					changed = false;
+					for (int y = seedY; y <= std::min(top + 1, MESH_SECTION_HEIGHT - 1); ++y)
 					{
-						MaskCell c2 = mask[n + w];
-						if (!c2.valid || c2.id != c.id || c2.dir != c.dir ||
-							c2.tileX != c.tileX || c2.tileY != c.tileY)
+						for (int z = 0; z < CHUNK_SIZE; ++z)
 						{
-							break;
-						}
-						++w;
-					} // end while
+							if (grow(y, z))
+							{
+								changed = true;
+								top = std::max(top, y);
+							}
+						} // end for
+					} // end for
 
-					int h = 1;
-					bool stop = false;
-					while (j + h < dims[v] && !stop) 
+					for (int y = std::min(top + 1, MESH_SECTION_HEIGHT - 1); y >= seedY; --y)
 					{
-						for (int k = 0; k < w; ++k) 
+						for (int z = CHUNK_SIZE - 1; z >= 0; --z)
 						{
-							MaskCell c2 = mask[n + k + h * dims[u]];
-							if (!c2.valid || c2.id != c.id || c2.dir != c.dir ||
-								c2.tileX != c.tileX || c2.tileY != c.tileY)
+							if (grow(y, z))
 							{
-								stop = true;
-								break;
+								changed = true;
+								top = std::max(top, y);
 							}
 						} // end for
-						if (!stop) ++h;
-					} // end while
-
-					int du[3] = { 0,0,0 };
-					int dv[3] = { 0,0,0 };
-					du[u] = w;
-					dv[v] = h;
-
-					int base[3] = { 0,0,0 };
-					base[u] = i;
-					base[v] = j;
-					base[d] = x[d] + 1;
-
-					glm::ivec3 p0(base[0], base[1], base[2]);
-					glm::ivec3 p1(base[0] + dv[0], base[1] + dv[1], base[2] + dv[2]);
-					glm::ivec3 p2(base[0] + du[0] + dv[0], base[1] + du[1] + dv[1], base[2] + du[2] + dv[2]);
-					glm::ivec3 p3(base[0] + du[0], base[1] + du[1], base[2] + du[2]);
+					} // end for
+				} // end while
 
-					const bool neg = (c.dir == FaceDir::NegX || c.dir == FaceDir::NegY || c.dir == FaceDir::NegZ);
-					if (neg)
-					{
-						emitQuad(p0, p3, p2, p1, c.dir, c.tileX, c.tileY);
-					}
-					else
+				uint32_t faces = 0;
+				for (int y = seedY; y <= top; ++y)
+				{
+					for (int z = 0; z < CHUNK_SIZE; ++z)
 					{
-						emitQuad(p0, p1, p2, p3, c.dir, c.tileX, c.tileY);
-					}
+						const uint16_t r = region[y][z];
+						if (!r)
+						{
+							continue;
+						}
 
-					// clear mask region
-					for (int yy = 0; yy < h; ++yy)
+						faces |= (r & (1u << (CHUNK_SIZE - 1))) ? 1u << static_cast<int>(FaceDir::PosX) : 0u;
+						faces |= (r & 1u) ? 1u << static_cast<int>(FaceDir::NegX) : 0u;
+						faces |= (y == MESH_SECTION_HEIGHT - 1) ? 1u << static_cast<int>(FaceDir::PosY) : 0u;
+						faces |= (y == 0) ? 1u << static_cast<int>(FaceDir::NegY) : 0u;
+						faces |= (z == CHUNK_SIZE - 1) ? 1u << static_cast<int>(FaceDir::PosZ) : 0u;
+						faces |= (z == 0) ? 1u << static_cast<int>(FaceDir::NegZ) : 0u;
+						open[y][z] &= static_cast<uint16_t>(~r);
+					} // end for
+				} // end for
+
+				for (int a = 0; a < 6; ++a)
+				{
+					for (int b = a + 1; b < 6; ++b)
 					{
-						for (int xx = 0; xx < w; ++xx)
+						if ((faces & (1u << a)) && (faces & (1u << b)))
 						{
-							mask[n + xx + yy * dims[u]].valid = false;
-						} // end for
+							pairs |= SectionFacePair(a, b);
+						}
 					} // end for
-
-					i += w;
-					n += w;
 				} // end for
-			} // end for
+			} // end while
+		} // end for
+	} // end for
+
+	return pairs;
+} // end of SectionConnectivity()
+
+
+//--- PUBLIC ---//
+void ChunkBorders::capture(Side side, const ChunkData& neighbor)
+{
+	std::array<BlockID, CHUNK_SIZE_Y * CHUNK_SIZE>& out = blocks[side];
+
+	for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+	{
+		for (int i = 0; i < CHUNK_SIZE; ++i)
+		{
+			BlockID id{};
+			switch (side)
+			{
+			case NegX: id = neighbor.getBlockID(CHUNK_SIZE - 1, y, i); break;
+			case PosX: id = neighbor.getBlockID(0, y, i); break;
+			case NegZ: id = neighbor.getBlockID(i, y, CHUNK_SIZE - 1); break;
+			default:   id = neighbor.getBlockID(i, y, 0); break;
+			}
+			out[y * CHUNK_SIZE + i] = id;
 		} // end for
 	} // end for
 
+	presentMask |= static_cast<uint8_t>(1u << side);
+} // end of capture()
+
+ChunkCoord ChunkBorders::neighborOf(const ChunkCoord& coord, Side side)
+{
+	switch (side)
+	{
+	case NegX: return { coord.x - 1, coord.z };
+	case PosX: return { coord.x + 1, coord.z };
+	case NegZ: return { coord.x, coord.z - 1 };
+	default:   return { coord.x, coord.z + 1 };
+	}
+} // end of neighborOf()
+
+ChunkMesh::ChunkMesh(
+	int chunkX,
+	int chunkZ,
+	bool autoBuild,
+	bool generate
+)
+	: chunkData_(chunkX, chunkZ, generate)
+{
+	if (autoBuild)
+	{
+		buildChunkMesh(nullptr, MeshPath::Bitmask);
+	}
+} // end of other constructor
+
+ChunkMesh::ChunkMesh(const ChunkData& data)
+	: chunkData_(data)
+{
+} // end of data constructor
+
+ChunkMesh::~ChunkMesh() = default;
+
+
+//--- PRIVATE ---//
+void ChunkMesh::buildChunkMesh(const ChunkBorders* borders, MeshPath path)
+{
+	// chunk storage is palettized, mesh from a dense copy
+	std::vector<BlockID> blocks(CHUNK_VOLUME);
+	chunkData_.copyBlocks(blocks.data());
+	blocks_ = blocks.data();
+	borders_ = borders;
+
+	std::vector<uint8_t> quadSections;
+	quadSections_ = &quadSections;
+
+	data_.opaqueVertices.clear();
+	data_.opaqueRTVertices.clear();
+	data_.opaqueIndices.clear();
+	data_.opaqueSections = {};
+	data_.opaqueSectionMask = 0;
+
+	uint32_t renderedBlocks = 0;
+	switch (path)
+	{
+	case MeshPath::Reference:
+		buildOpaqueReference();
+		renderedBlocks = computeRenderedBlockCount();
+		break;
+	default:
+		renderedBlocks = buildOpaqueBitmask();
+		break;
+	}
+
+	sortOpaqueBySection(quadSections);
+
 	// water
 	data_.waterVertices.clear();
 	data_.waterRTVertices.clear();
 	data_.waterIndices.clear();
 
+	float waterMinY = FLT_MAX;
+	float waterMaxY = -FLT_MAX;
 	auto addWaterQuad = [&](int x0, int y, int z0, int w, int h)
 		{
 			// water surface height
 			float yPos = static_cast<float>(y) + 0.90f;
+			waterMinY = std::min(waterMinY, yPos);
+			waterMaxY = std::max(waterMaxY, yPos);
 
 			// pos, in chunk local space
 			glm::vec3 p0{ x0, yPos, z0 };
@@ -344,14 +462,14 @@ void ChunkMesh::buildChunkMesh()
 		{
 			for (int z = 0; z < CHUNK_SIZE; ++z)
 			{
-				BlockID block = chunkData_.getBlockID(x, y, z);
+				BlockID block = blockAt(x, y, z);
 
 				// skip opaque blocks
 				if (block != BlockID::Water) continue;
 
 				BlockID above = (y + 1) >= CHUNK_SIZE_Y ?
 					BlockID::Air :
-					chunkData_.getBlockID(x, y + 1, z);
+					blockAt(x, y + 1, z);
 
 				if (above != BlockID::Water)
 				{
@@ -410,20 +528,649 @@ void ChunkMesh::buildChunkMesh()
 	// update counts
 	data_.opaqueIndexCount = static_cast<int32_t>(data_.opaqueIndices.size());
 	data_.waterIndexCount = static_cast<int32_t>(data_.waterIndices.size());
-	data_.renderedBlockCount = computeRenderedBlockCount();
-} // end of buildChunkMesh()
-
-bool ChunkMesh::isTransparent(int x, int y, int z)
-{
-	// check for outside chunk (= air)
-	if (x < 0 || x >= CHUNK_SIZE ||
-		y < 0 || y >= CHUNK_SIZE_Y ||
-		z < 0 || z >= CHUNK_SIZE)
+	data_.renderedBlockCount = renderedBlocks;
+	data_.solidSectionMask = SolidSectionMask(blocks_);
+	GroundOccluder(blocks_, data_);
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		data_.sectionConnectivity[s] = (data_.solidSectionMask & (1u << s)) ? 0u : SectionConnectivity(blocks_, s);
+	} // end for
+
+	// tight y extent for culling and the shadow fit
+	data_.minY = waterMinY;
+	data_.maxY = waterMaxY;
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		if (data_.opaqueSectionMask & (1u << s))
+		{
+			data_.minY = std::min(data_.minY, data_.opaqueSections[s].minY);
+			data_.maxY = std::max(data_.maxY, data_.opaqueSections[s].maxY);
+		}
+	} // end for
+	if (!data_.hasGeometry())
+	{
+		data_.minY = 0.0f;
+		data_.maxY = -1.0f;
+	}
+
+	blocks_ = nullptr;
+	borders_ = nullptr;
+	quadSections_ = nullptr;
+} // end of buildChunkMesh()
+
+void ChunkMesh::emitOpaqueQuad(
+	const glm::ivec3& p0, const glm::ivec3& p1, const glm::ivec3& p2, const glm::ivec3& p3,
+	FaceDir dir, int tileX, int tileY)
+{
+	// base vertex index for quad
+	uint32_t start = static_cast<uint32_t>(data_.opaqueVertices.size());
+
+	// vert pos order
+	glm::ivec3 corners[4] = { p0, p1, p2, p3 };
+
+	// vert normal
+	glm::vec3 faceNormal{};
+	switch (dir)
+	{
+	case FaceDir::PosX: faceNormal = glm::vec3(1.0f, 0.0f, 0.0f); break;
+	case FaceDir::NegX: faceNormal = glm::vec3(-1.0f, 0.0f, 0.0f); break;
+	case FaceDir::PosY: faceNormal = glm::vec3(0.0f, 1.0f, 0.0f); break;
+	case FaceDir::NegY: faceNormal = glm::vec3(0.0f, -1.0f, 0.0f); break;
+	case FaceDir::PosZ: faceNormal = glm::vec3(0.0f, 0.0f, 1.0f); break;
+	case FaceDir::NegZ: faceNormal = glm::vec3(0.0f, 0.0f, -1.0f); break;
+	default:            faceNormal = glm::vec3(0.0f, 1.0f, 0.0f); break;
+	}
+
+	// pack vertex data
+	for (int c = 0; c < 4; ++c) 
+	{
+		Vertex v{};
+		v.sample = PackVertexU32(
+			static_cast<uint32_t>(c),
+			static_cast<uint32_t>(tileX), static_cast<uint32_t>(tileY),
+			static_cast<uint32_t>(dir),
+			static_cast<uint32_t>(corners[c].x),
+			static_cast<uint32_t>(corners[c].y),
+			static_cast<uint32_t>(corners[c].z)
+		);
+		data_.opaqueVertices.push_back(v);
+
+		// RT vertex data
+		RTVertex rtv{};
+		rtv.position = glm::vec4(corners[c], 0.0f);
+		// RT normal data
+		rtv.normal = glm::vec4(faceNormal, 0.0f);
+		// RT tile data
+		rtv.tileData = glm::vec4(float(tileX), float(tileY), 0.0f, 0.0f);
+		data_.opaqueRTVertices.push_back(rtv);
+	} // end for
+
+	// bucket by the section of the quad's lowest corner
+	int minY = std::min(std::min(p0.y, p1.y), std::min(p2.y, p3.y));
+	int maxY = std::max(std::max(p0.y, p1.y), std::max(p2.y, p3.y));
+	int s = std::min(minY / MESH_SECTION_HEIGHT, MESH_SECTION_COUNT - 1);
+
+	ChunkMeshSection& section = data_.opaqueSections[s];
+	if (data_.opaqueSectionMask & (1u << s))
+	{
+		section.minY = std::min(section.minY, static_cast<float>(minY));
+		section.maxY = std::max(section.maxY, static_cast<float>(maxY));
+	}
+	else
+	{
+		section.minY = static_cast<float>(minY);
+		section.maxY = static_cast<float>(maxY);
+		data_.opaqueSectionMask |= 1u << s;
+	}
+
+	data_.opaqueSections[s].indexCount += 6;
+	quadSections_->push_back(static_cast<uint8_t>(s));
+
+	data_.opaqueIndices.push_back(start + 0);
+	data_.opaqueIndices.push_back(start + 1);
+	data_.opaqueIndices.push_back(start + 2);
+	data_.opaqueIndices.push_back(start + 0);
+	data_.opaqueIndices.push_back(start + 2);
+	data_.opaqueIndices.push_back(start + 3);
+} // end of emitOpaqueQuad()
+
+void ChunkMesh::sortOpaqueBySection(const std::vector<uint8_t>& quadSections)
+{
+	// sections bottom to top, so a run of sections is one index range
+	uint32_t first = 0;
+	bool sorted = true;
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		data_.opaqueSections[s].firstIndex = first;
+		first += data_.opaqueSections[s].indexCount;
+	} // end for
+	for (size_t q = 1; q < quadSections.size() && sorted; ++q)
+	{
+		sorted = quadSections[q - 1] <= quadSections[q];
+	} // end for
+
+	if (sorted)
+	{
+		return;
+	}
+
+	// counting sort of the quads, vertices keep their order
+	std::array<uint32_t, MESH_SECTION_COUNT> next{};
+	for (int s = 0; s < MESH_SECTION_COUNT; ++s)
+	{
+		next[s] = data_.opaqueSections[s].firstIndex;
+	} // end for
+
+	std::vector<uint32_t> indices(data_.opaqueIndices.size());
+	for (size_t q = 0; q < quadSections.size(); ++q)
+	{
+		uint32_t& dst = next[quadSections[q]];
+		std::copy_n(data_.opaqueIndices.begin() + q * 6, 6, indices.begin() + dst);
+		dst += 6;
+	} // end for
+
+	data_.opaqueIndices.swap(indices);
+} // end of sortOpaqueBySection()
+
+uint32_t ChunkMesh::buildOpaqueBitmask()
+{
+	// tile per (block, face), replaces the getBlockTile switch per cell
+	struct TileLUT
+	{
+		std::array<std::array<uint8_t, 6>, 256> x{};
+		std::array<std::array<uint8_t, 6>, 256> y{};
+	};
+	static const TileLUT tiles = []()
+		{
+			TileLUT lut;
+			for (int id = 0; id < 256; ++id)
+			{
+				for (int f = 0; f < 6; ++f)
+				{
+					int tx = 0;
+					int ty = 0;
+					getBlockTile(static_cast<BlockID>(id), tx, ty, static_cast<FaceDir>(f));
+					lut.x[id][f] = static_cast<uint8_t>(tx);
+					lut.y[id][f] = static_cast<uint8_t>(ty);
+				} // end for
+			} // end for
+			return lut;
+		}();
+
+	const int dims[3] = { CHUNK_SIZE, CHUNK_SIZE_Y, CHUNK_SIZE };
+
+	// per axis d: slices x[d] = -1 .. dims[d] (stored at +1), rows along v,
+	// bits along u. opaque/transparent share the layout
+	struct AxisMasks
+	{
+		int u = 0;
+		int v = 0;
+		int dimsV = 0;
+		int words = 0;
+		std::vector<uint64_t> opaque;
+		std::vector<uint64_t> transparent;
+
+		uint64_t* row(std::vector<uint64_t>& bits, int slice, int j) { return bits.data() + (slice * dimsV + j) * words; }
+	};
+
+	AxisMasks axes[3];
+	for (int d = 0; d < 3; ++d)
+	{
+		AxisMasks& a = axes[d];
+		a.u = (d + 1) % 3;
+		a.v = (d + 2) % 3;
+		a.dimsV = dims[a.v];
+		a.words = (dims[a.u] + 63) / 64;
+		a.opaque.assign((dims[d] + 2) * a.dimsV * a.words, 0);
+		a.transparent.assign((dims[d] + 2) * a.dimsV * a.words, 0);
+	} // end for
+
+	// interior cells: build x rows per (y, z) once, then scatter the set
+	// bits into the y and z major layouts of the other two axes
+	AxisMasks& ax = axes[0];
+	AxisMasks& ay = axes[1];
+	AxisMasks& az = axes[2];
+
+	for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+	{
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			const BlockID* row = blocks_ + CHUNK_SIZE * (z + CHUNK_SIZE * y);
+
+			uint64_t opaqueRow = 0;
+			uint64_t transparentRow = 0;
+			for (int x = 0; x < CHUNK_SIZE; ++x)
+			{
+				opaqueRow |= static_cast<uint64_t>(IsOpaqueBlock(row[x])) << x;
+				transparentRow |= static_cast<uint64_t>(IsTransparentBlock(row[x])) << x;
+			} // end for
+
+			az.row(az.opaque, z + 1, y)[0] = opaqueRow;
+			az.row(az.transparent, z + 1, y)[0] = transparentRow;
+
+			const uint64_t yBit = 1ull << (y & 63);
+			const uint64_t zBit = 1ull << z;
+
+			for (uint64_t bits = opaqueRow; bits; bits &= bits - 1)
+			{
+				int x = CountTrailingZeros64(bits);
+				ax.row(ax.opaque, x + 1, z)[y >> 6] |= yBit;
+				ay.row(ay.opaque, y + 1, x)[0] |= zBit;
+			} // end for
+			for (uint64_t bits = transparentRow; bits; bits &= bits - 1)
+			{
+				int x = CountTrailingZeros64(bits);
+				ax.row(ax.transparent, x + 1, z)[y >> 6] |= yBit;
+				ay.row(ay.transparent, y + 1, x)[0] |= zBit;
+			} // end for
+		} // end for
+	} // end for
+
+	// outside slices are never opaque (faces belong to the neighbour),
+	// transparency comes from neighbour borders (missing = air)
+	for (int d = 0; d < 3; ++d)
+	{
+		AxisMasks& a = axes[d];
+
+		for (int side = 0; side < 2; ++side)
+		{
+			const int slice = side == 0 ? 0 : dims[d] + 1;
+
+			for (int j = 0; j < dims[a.v]; ++j)
+			{
+				uint64_t* row = a.row(a.transparent, slice, j);
+
+				for (int i = 0; i < dims[a.u]; ++i)
+				{
+					int cell[3] = {};
+					cell[d] = side == 0 ? -1 : dims[d];
+					cell[a.u] = i;
+					cell[a.v] = j;
+
+					if (isTransparent(cell[0], cell[1], cell[2]))
+					{
+						row[i >> 6] |= 1ull << (i & 63);
+					}
+				} // end for
+			} // end for
+		} // end for
+	} // end for
+
+	// rendered blocks: opaque with any transparent neighbour, done on the
+	// z major rows (x bits), x neighbours come from the x axis border slices
+	uint32_t renderedBlocks = 0;
+	for (int z = 0; z < CHUNK_SIZE; ++z)
+	{
+		for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+		{
+			const uint64_t opaque = az.row(az.opaque, z + 1, y)[0];
+			if (!opaque)
+			{
+				continue;
+			}
+
+			const uint64_t yBit = 1ull << (y & 63);
+			const uint64_t negX = (ax.row(ax.transparent, 0, z)[y >> 6] & yBit) ? 1ull : 0ull;
+			const uint64_t posX = (ax.row(ax.transparent, CHUNK_SIZE + 1, z)[y >> 6] & yBit) ? 1ull : 0ull;
+
+			// bit 0 = x - 1 border, bits 1..CHUNK_SIZE = row, then x + 1 border
+			const uint64_t wide = negX | (az.row(az.transparent, z + 1, y)[0] << 1) | (posX << (CHUNK_SIZE + 1));
+
+			uint64_t visible = wide | (wide >> 2);
+			visible |= y + 1 < CHUNK_SIZE_Y ? az.row(az.transparent, z + 1, y + 1)[0] : ~0ull;
+			visible |= y > 0 ? az.row(az.transparent, z + 1, y - 1)[0] : ~0ull;
+			visible |= az.row(az.transparent, z + 2, y)[0];
+			visible |= az.row(az.transparent, z, y)[0];
+
+			renderedBlocks += PopCount64(opaque & visible);
+		} // end for
+	} // end for
+
+	// per slice scratch: face bits and per-key rows for merging
+	std::vector<uint64_t> remaining;
+	std::vector<uint64_t> keyRows;
+	std::vector<uint8_t> cellSlot;
+	std::array<int16_t, 512> slotOfKey;
+	std::vector<uint16_t> slotKeys;
+
+	for (int d = 0; d < 3; ++d)
+	{
+		AxisMasks& a = axes[d];
+		const int u = a.u;
+		const int v = a.v;
+		const int words = a.words;
+		const int rows = dims[v];
+		const int rowWords = rows * words;
+
+		remaining.assign(rowWords, 0);
+		cellSlot.assign(rows * dims[u], 0);
+
+		int x[3] = { 0, 0, 0 };
+		for (x[d] = -1; x[d] < dims[d]; ++x[d])
+		{
+			// face visibility for the whole slice with word ops
+			bool any = false;
+			for (int j = 0; j < rows; ++j)
+			{
+				const uint64_t* opA = a.row(a.opaque, x[d] + 1, j);
+				const uint64_t* opB = a.row(a.opaque, x[d] + 2, j);
+				const uint64_t* trA = a.row(a.transparent, x[d] + 1, j);
+				const uint64_t* trB = a.row(a.transparent, x[d] + 2, j);
+
+				for (int w = 0; w < words; ++w)
+				{
+					uint64_t pos = opA[w] & trB[w];
+					uint64_t neg = opB[w] & trA[w] & ~pos;
+					remaining[j * words + w] = pos | neg;
+					any |= (pos | neg) != 0;
+				} // end for
+			} // end for
+
+			if (!any)
+			{
+				continue;
+			}
+
+			// split faces by (block, direction), only merge equal keys
+			slotOfKey.fill(-1);
+			slotKeys.clear();
+
+			for (int j = 0; j < rows; ++j)
+			{
+				for (int w = 0; w < words; ++w)
+				{
+					uint64_t bits = remaining[j * words + w];
+					const uint64_t pos = a.row(a.opaque, x[d] + 1, j)[w] & a.row(a.transparent, x[d] + 2, j)[w];
+
+					while (bits)
+					{
+						int b = CountTrailingZeros64(bits);
+						bits &= bits - 1;
+
+						int i = w * 64 + b;
+						bool isPos = (pos >> b) & 1ull;
+
+						int cell[3] = {};
+						cell[d] = isPos ? x[d] : x[d] + 1;
+						cell[u] = i;
+						cell[v] = j;
+
+						uint16_t key = static_cast<uint16_t>(
+							(static_cast<uint16_t>(blockAt(cell[0], cell[1], cell[2])) << 1) | (isPos ? 0 : 1));
+
+						if (slotOfKey[key] < 0)
+						{
+							slotOfKey[key] = static_cast<int16_t>(slotKeys.size());
+							slotKeys.push_back(key);
+							keyRows.resize(slotKeys.size() * rowWords);
+							std::fill(keyRows.end() - rowWords, keyRows.end(), 0);
+						}
+
+						int slot = slotOfKey[key];
+						cellSlot[j * dims[u] + i] = static_cast<uint8_t>(slot);
+						keyRows[slot * rowWords + j * words + w] |= 1ull << b;
+					} // end while
+				} // end for
+			} // end for
+
+			// greedy merge in the same scan order as the reference mesher
+			for (int j = 0; j < rows; ++j)
+			{
+				uint64_t* rem = remaining.data() + j * words;
+
+				for (int i = FindFirstSet(rem, words); i >= 0; i = FindFirstSet(rem, words))
+				{
+					const int slot = cellSlot[j * dims[u] + i];
+					uint64_t* keyRow = keyRows.data() + slot * rowWords;
+
+					int w = RunLength(keyRow + j * words, i, dims[u]);
+
+					int h = 1;
+					while (j + h < rows && TestRange(keyRow + (j + h) * words, i, w))
+					{
+						++h;
+					} // end while
+
+					for (int k = 0; k < h; ++k)
+					{
+						ClearRange(keyRow + (j + k) * words, i, w);
+						ClearRange(remaining.data() + (j + k) * words, i, w);
+					} // end for
+
+					const uint16_t key = slotKeys[slot];
+					const BlockID id = static_cast<BlockID>(key >> 1);
+					const bool neg = (key & 1) != 0;
+					const FaceDir dir = static_cast<FaceDir>(d * 2 + (neg ? 1 : 0));
+
+					int du[3] = { 0,0,0 };
+					int dv[3] = { 0,0,0 };
+					du[u] = w;
+					dv[v] = h;
+
+					int base[3] = { 0,0,0 };
+					base[u] = i;
+					base[v] = j;
+					base[d] = x[d] + 1;
+
+					glm::ivec3 p0(base[0], base[1], base[2]);
+					glm::ivec3 p1(base[0] + dv[0], base[1] + dv[1], base[2] + dv[2]);
+					glm::ivec3 p2(base[0] + du[0] + dv[0], base[1] + du[1] + dv[1], base[2] + du[2] + dv[2]);
+					glm::ivec3 p3(base[0] + du[0], base[1] + du[1], base[2] + du[2]);
+
+					const int tileX = tiles.x[static_cast<uint8_t>(id)][static_cast<int>(dir)];
+					const int tileY = tiles.y[static_cast<uint8_t>(id)][static_cast<int>(dir)];
+
+					if (neg)
+					{
+						emitOpaqueQuad(p0, p3, p2, p1, dir, tileX, tileY);
+					}
+					else
+					{
+						emitOpaqueQuad(p0, p1, p2, p3, dir, tileX, tileY);
+					}
+				} // end for
+			} // end for
+		} // end for
+	} // end for
+
+	return renderedBlocks;
+} // end of buildOpaqueBitmask()
+
+void ChunkMesh::buildOpaqueReference()
+{
+	// check if block is opaque
+	auto isOpaque = [&](BlockID id) {
+		return id != BlockID::Air && id != BlockID::Water;
+		};
+
+	// all attr must match for cells to merge
+	struct MaskCell {
+		bool valid = false;
+		BlockID id{};
+		FaceDir dir{};
+		int tileX = 0;
+		int tileY = 0;
+	};
+
+	// chunk size x, y, z
+	const int dims[3] = { CHUNK_SIZE, CHUNK_SIZE_Y, CHUNK_SIZE };
+
+	// sweep axis d (0 = x, 1 = y, 2 = z)
+	for (int d = 0; d < 3; ++d)
+	{
+		// get other two axes for mask
+		int u = (d + 1) % 3;
+		int v = (d + 2) % 3;
+
+		// unit step
+		int q[3] = { 0, 0, 0 };
+		q[d] = 1;
+
+		std::vector<MaskCell> mask(dims[u] * dims[v]);
+		int x[3] = { 0, 0, 0 };
+
+		// when x[d] = -1, a is outside chunk and b is slice 0
+		// when x[d] = dims[d]-1, b is outside and a is last slice
+		for (x[d] = -1; x[d] < dims[d]; ++x[d])
+		{
+			// build mask for this slice
+			int n = 0;
+			for (x[v] = 0; x[v] < dims[v]; ++x[v])
+			{
+				for (x[u] = 0; x[u] < dims[u]; ++x[u], ++n)
+				{
+					BlockID a = BlockID::Air;
+					BlockID b = BlockID::Air;
+
+					if (x[d] >= 0)
+						a = blockAt(x[0], x[1], x[2]);
+					if (x[d] < dims[d] - 1)
+						b = blockAt(x[0] + q[0], x[1] + q[1], x[2] + q[2]);
+
+					// check which side is opaque
+					bool aSolid = (x[d] >= 0) && isOpaque(a);
+					bool bSolid = (x[d] < dims[d] - 1) && isOpaque(b);
+
+					MaskCell cell{};
+					cell.valid = false;
+
+					// face between a and b if one is solid and the other is transparent
+					if (aSolid && isTransparent(x[0] + q[0], x[1] + q[1], x[2] + q[2]))
+					{
+						cell.valid = true;
+						cell.id = a;
+						cell.dir = (d == 0) ? FaceDir::PosX : (d == 1) ? FaceDir::PosY : FaceDir::PosZ;
+						getBlockTile(a, cell.tileX, cell.tileY, cell.dir);
+					}
+					else if (bSolid && isTransparent(x[0], x[1], x[2]))
+					{
+						cell.valid = true;
+						cell.id = b;
+						cell.dir = (d == 0) ? FaceDir::NegX : (d == 1) ? FaceDir::NegY : FaceDir::NegZ;
+						getBlockTile(b, cell.tileX, cell.tileY, cell.dir);
+					}
+
+					mask[n] = cell;
+				} // end for
+			} // end for
+
+			// greedy merge rectangles on mask
+			n = 0;
+			for (int j = 0; j < dims[v]; ++j)
+			{
+				for (int i = 0; i < dims[u]; )
+				{
+					MaskCell c = mask[n];
+					if (!c.valid) 
+					{ 
+						++i; 
+						++n; 
+						continue; 
+					}
+
+					int w = 1;
+					while (i + w < dims[u]) 
+					{
+						MaskCell c2 = mask[n + w];
+						if (!c2.valid || c2.id != c.id || c2.dir != c.dir ||
+							c2.tileX != c.tileX || c2.tileY != c.tileY)
+						{
+							break;
+						}
+						++w;
+					} // end while
+
+					int h = 1;
+					bool stop = false;
+					while (j + h < dims[v] && !stop) 
+					{
+						for (int k = 0; k < w; ++k) 
+						{
+							MaskCell c2 = mask[n + k + h * dims[u]];
+							if (!c2.valid || c2.id != c.id || c2.dir != c.dir ||
+								c2.tileX != c.tileX || c2.tileY != c.tileY)
+							{
+								stop = true;
+								break;
+							}
+						} // end for
+						if (!stop) ++h;
+					} // end while
+
+					int du[3] = { 0,0,0 };
+					int dv[3] = { 0,0,0 };
+					du[u] = w;
+					dv[v] = h;
+
+					int base[3] = { 0,0,0 };
+					base[u] = i;
+					base[v] = j;
+					base[d] = x[d] + 1;
+
+					glm::ivec3 p0(base[0], base[1], base[2]);
+					glm::ivec3 p1(base[0] + dv[0], base[1] + dv[1], base[2] + dv[2]);
+					glm::ivec3 p2(base[0] + du[0] + dv[0], base[1] + du[1] + dv[1], base[2] + du[2] + dv[2]);
+					glm::ivec3 p3(base[0] + du[0], base[1] + du[1], base[2] + du[2]);
+
+					const bool neg = (c.dir == FaceDir::NegX || c.dir == FaceDir::NegY || c.dir == FaceDir::NegZ);
+					if (neg)
+					{
+						emitOpaqueQuad(p0, p3, p2, p1, c.dir, c.tileX, c.tileY);
+					}
+					else
+					{
+						emitOpaqueQuad(p0, p1, p2, p3, c.dir, c.tileX, c.tileY);
+					}
+
+					// clear mask region
+					for (int yy = 0; yy < h; ++yy)
+					{
+						for (int xx = 0; xx < w; ++xx)
+						{
+							mask[n + xx + yy * dims[u]].valid = false;
+						} // end for
+					} // end for
+
+					i += w;
+					n += w;
+				} // end for
+			} // end for
+		} // end for
+	} // end for
+} // end of buildOpaqueReference()
+
+bool ChunkMesh::isTransparent(int x, int y, int z)
+{
+	BlockID id{};
+
+	// above/below the world is air
+	if (y < 0 || y >= CHUNK_SIZE_Y)
 	{
 		return true;
 	}
 
-	BlockID id = chunkData_.getBlockID(x, y, z);
+	// outside chunk, look at neighbour border (missing neighbour = air)
+	if (x < 0 || x >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE)
+	{
+		ChunkBorders::Side side;
+		int i;
+
+		if (x < 0)                { side = ChunkBorders::NegX; i = z; }
+		else if (x >= CHUNK_SIZE) { side = ChunkBorders::PosX; i = z; }
+		else if (z < 0)           { side = ChunkBorders::NegZ; i = x; }
+		else                      { side = ChunkBorders::PosZ; i = x; }
+
+		if (!borders_ || !borders_->has(side) || i < 0 || i >= CHUNK_SIZE)
+		{
+			return true;
+		}
+
+		id = borders_->blocks[side][y * CHUNK_SIZE + i];
+	}
+	else
+	{
+		id = blockAt(x, y, z);
+	}
 
 	if (id == BlockID::Tree_Leaf || id == BlockID::Water)
 	{
@@ -441,7 +1188,7 @@ uint32_t ChunkMesh::computeRenderedBlockCount()
 		for (int y = 0; y < CHUNK_SIZE_Y; ++y)
 			for (int z = 0; z < CHUNK_SIZE; ++z)
 			{
-				BlockID id = chunkData_.getBlockID(x, y, z);
+				BlockID id = blockAt(x, y, z);
 				if (id == BlockID::Air || id == BlockID::Water) continue;
 
 				// count block if ANY face is visible
@@ -0,0 +1,262 @@
+#include "chunk_occlusion.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+//--- HELPER ---//
+static float Cross(const glm::vec2& o, const glm::vec2& a, const glm::vec2& b)
+{
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+} // end of Cross()
+
+// counter clockwise convex hull (monotone chain), returns the vertex count
+static int ConvexHull(glm::vec2* points, int count, glm::vec2* outHull)
+{
+	std::sort(points, points + count, [](const glm::vec2& a, const glm::vec2& b)
+		{
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		});
+
+	int n = 0;
+	// lower hull
+	for (int i = 0; i < count; ++i)
+	{
+		while (n >= 2 && Cross(outHull[n - 2], outHull[n - 1], points[i]) <= 0.0f)
+		{
+			--n;
+		} // end while
+		outHull[n++] = points[i];
+	} // end for
+
+	// upper hull
+	const int lower = n + 1;
+	for (int i = count - 2; i >= 0; --i)
+	{
+		while (n >= lower && Cross(outHull[n - 2], outHull[n - 1], points[i]) <= 0.0f)
+		{
+			--n;
+		} // end while
+		outHull[n++] = points[i];
+	} // end for
+
+	// last point repeats the first
+	return n - 1;
+} // end of ConvexHull()
+
+
+//--- PUBLIC ---//
+void OcclusionBuffer::begin(const glm::mat4& viewProj, int width, int height)
+{
+	viewProj_ = viewProj;
+	width_ = std::max(1, width);
+	height_ = std::max(1, height);
+	occluderCount_ = 0;
+
+	levels_[0].assign(static_cast<size_t>(width_) * height_, FLT_MAX);
+	levelSizes_.assign(1, glm::ivec2(width_, height_));
+} // end of begin()
+
+void OcclusionBuffer::addOccluder(const AABB& box)
+{
+	glm::vec2 points[8];
+	float minZ;
+	float maxZ;
+	if (!project(box, points, minZ, maxZ))
+	{
+		return;
+	}
+
+	glm::vec2 hull[16];
+	const int hullCount = ConvexHull(points, 8, hull);
+	if (hullCount < 3)
+	{
+		return;
+	}
+
+	// inside when nx * x + ny * y + c >= 0 for every edge
+	float edgeNX[8];
+	float edgeNY[8];
+	float edgeC[8];
+	float top = -FLT_MAX;
+	float bottom = FLT_MAX;
+	for (int e = 0; e < hullCount; ++e)
+	{
+		const glm::vec2& a = hull[e];
+		const glm::vec2& b = hull[(e + 1) % hullCount];
+		edgeNX[e] = -(b.y - a.y);
+		edgeNY[e] = b.x - a.x;
+		edgeC[e] = -(edgeNX[e] * a.x + edgeNY[e] * a.y);
+		top = std::max(top, a.y);
+		bottom = std::min(bottom, a.y);
+	} // end for
+
+	const int y0 = static_cast<int>(std::max(0.0f, std::floor(bottom)));
+	const int y1 = static_cast<int>(std::min(static_cast<float>(height_), std::ceil(top))) - 1;
+	std::vector<float>& depth = levels_[0];
+
+	// a texel is covered when all four of its corners are inside, per edge
+	// that is the corner the edge function is smallest at
+	for (int y = y0; y <= y1; ++y)
+	{
+		float lo = 0.0f;
+		float hi = static_cast<float>(width_ - 1);
+
+		for (int e = 0; e < hullCount && lo <= hi; ++e)
+		{
+			const float nx = edgeNX[e];
+			const float ny = edgeNY[e];
+			const float k = ny * static_cast<float>(ny > 0.0f ? y : y + 1) + edgeC[e];
+
+			if (nx > 0.0f)
+			{
+				lo = std::max(lo, std::ceil(-k / nx));
+			}
+			else if (nx < 0.0f)
+			{
+				hi = std::min(hi, std::floor(-k / nx) - 1.0f);
+			}
+			else if (k < 0.0f)
+			{
+				hi = -1.0f;
+			}
+		} // end for
+
+		if (lo > hi)
+		{
+			continue;
+		}
+
+		float* row = depth.data() + static_cast<size_t>(y) * width_;
+		for (int x = static_cast<int>(lo); x <= static_cast<int>(hi); ++x)
+		{
+			row[x] = std::min(row[x], maxZ);
+		} // end for
+	} // end for
+
+	++occluderCount_;
+} // end of addOccluder()
+
+void OcclusionBuffer::finish()
+{
+	// level buffers are kept between frames
+	levelSizes_.resize(1);
+
+	while (levelSizes_.back().x > 1 || levelSizes_.back().y > 1)
+	{
+		const glm::ivec2 src = levelSizes_.back();
+		const glm::ivec2 dst((src.x + 1) / 2, (src.y + 1) / 2);
+
+		const size_t index = levelSizes_.size();
+		if (levels_.size() <= index)
+		{
+			levels_.emplace_back();
+		}
+		std::vector<float>& level = levels_[index];
+		level.resize(static_cast<size_t>(dst.x) * dst.y);
+		const std::vector<float>& prev = levels_[index - 1];
+		for (int y = 0; y < dst.y; ++y)
+		{
+			const int sy0 = 2 * y;
+			const int sy1 = std::min(2 * y + 1, src.y - 1);
+			for (int x = 0; x < dst.x; ++x)
+			{
+				const int sx0 = 2 * x;
+				const int sx1 = std::min(2 * x + 1, src.x - 1);
+				level[static_cast<size_t>(y) * dst.x + x] = std::max(
+					std::max(prev[static_cast<size_t>(sy0) * src.x + sx0], prev[static_cast<size_t>(sy0) * src.x + sx1]),
+					std::max(prev[static_cast<size_t>(sy1) * src.x + sx0], prev[static_cast<size_t>(sy1) * src.x + sx1])
+				);
+			} // end for
+		} // end for
+
+		levelSizes_.push_back(dst);
+	} // end while
+	levels_.resize(levelSizes_.size());
+} // end of finish()
+
+bool OcclusionBuffer::isOccluded(const AABB& box) const
+{
+	glm::vec2 points[8];
+	float minZ;
+	float maxZ;
+	if (occluderCount_ == 0 || !project(box, points, minZ, maxZ))
+	{
+		return false;
+	}
+
+	glm::vec2 lo = points[0];
+	glm::vec2 hi = points[0];
+	for (int i = 1; i < 8; ++i)
+	{
+		lo = glm::min(lo, points[i]);
+		hi = glm::max(hi, points[i]);
+	} // end for
+
+	// off screen parts are never seen, the frustum test handles the rest
+	if (hi.x <= 0.0f || hi.y <= 0.0f || lo.x >= width_ || lo.y >= height_)
+	{
+		return false;
+	}
+
+	const int x0 = static_cast<int>(std::max(0.0f, std::floor(lo.x)));
+	const int y0 = static_cast<int>(std::max(0.0f, std::floor(lo.y)));
+	const int x1 = std::max(x0, static_cast<int>(std::min(static_cast<float>(width_), std::ceil(hi.x))) - 1);
+	const int y1 = std::max(y0, static_cast<int>(std::min(static_cast<float>(height_), std::ceil(hi.y))) - 1);
+
+	// coarsest level where the rect is at most 2x2 texels
+	size_t level = 0;
+	while (level + 1 < levelSizes_.size() &&
+		((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+	{
+		++level;
+	} // end while
+
+	const std::vector<float>& depth = levels_[level];
+	const int levelWidth = levelSizes_[level].x;
+	for (int y = y0 >> level; y <= (y1 >> level); ++y)
+	{
+		for (int x = x0 >> level; x <= (x1 >> level); ++x)
+		{
+			if (depth[static_cast<size_t>(y) * levelWidth + x] >= minZ)
+			{
+				return false;
+			}
+		} // end for
+	} // end for
+
+	return true;
+} // end of isOccluded()
+
+
+//--- PRIVATE ---//
+bool OcclusionBuffer::project(const AABB& box, glm::vec2* outPoints, float& outMinZ, float& outMaxZ) const
+{
+	outMinZ = FLT_MAX;
+	outMaxZ = -FLT_MAX;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		const glm::vec4 corner(
+			(i & 1) ? box.max.x : box.min.x,
+			(i & 2) ? box.max.y : box.min.y,
+			(i & 4) ? box.max.z : box.min.z,
+			1.0f
+		);
+		const glm::vec4 clip = viewProj_ * corner;
+		if (clip.w <= 1e-5f)
+		{
+			return false;
+		}
+
+		const float invW = 1.0f / clip.w;
+		outPoints[i] = glm::vec2(
+			(clip.x * invW * 0.5f + 0.5f) * static_cast<float>(width_),
+			(clip.y * invW * 0.5f + 0.5f) * static_cast<float>(height_)
+		);
+		outMinZ = std::min(outMinZ, clip.z * invW);
+		outMaxZ = std::max(outMaxZ, clip.z * invW);
+	} // end for
+
+	return true;
+} // end of project()
@@ -0,0 +1,206 @@
+#include "chunk_section.h"
+
+#include <algorithm>
+#include <array>
+
+//--- HELPER ---//
+static uint8_t BitsForPaletteSize(size_t size)
+{
+	// power of two widths keep every index inside one word
+	if (size <= 2) return 1;
+	if (size <= 4) return 2;
+	if (size <= 16) return 4;
+	return 8;
+} // end of BitsForPaletteSize()
+
+// read by uniform sections
+static const uint64_t ZERO_WORD[1] = { 0 };
+
+static size_t WordCount(uint8_t bitsPerIndex)
+{
+	return (static_cast<size_t>(ChunkSection::VOLUME) * bitsPerIndex + 63) / 64;
+} // end of WordCount()
+
+
+//--- PUBLIC ---//
+ChunkSection::ChunkSection()
+{
+	updateView();
+} // end of constructor
+
+ChunkSection::ChunkSection(const ChunkSection& other)
+	: palette_(other.palette_),
+	words_(other.words_),
+	uniform_(other.uniform_),
+	bitsPerIndex_(other.bitsPerIndex_)
+{
+	updateView();
+} // end of copy constructor
+
+ChunkSection& ChunkSection::operator=(const ChunkSection& other)
+{
+	palette_ = other.palette_;
+	words_ = other.words_;
+	uniform_ = other.uniform_;
+	bitsPerIndex_ = other.bitsPerIndex_;
+	updateView();
+	return *this;
+} // end of operator=()
+
+void ChunkSection::set(int index, BlockID id)
+{
+	if (bitsPerIndex_ == 0)
+	{
+		if (id == uniform_)
+		{
+			return;
+		}
+
+		// uniform -> two entry palette, everything else stays index 0
+		palette_ = { uniform_, id };
+		bitsPerIndex_ = 1;
+		words_.assign(WordCount(bitsPerIndex_), 0);
+		writeIndex(index, 1);
+		updateView();
+		return;
+	}
+
+	auto it = std::find(palette_.begin(), palette_.end(), id);
+	uint32_t paletteIndex = static_cast<uint32_t>(it - palette_.begin());
+
+	if (it == palette_.end())
+	{
+		if (palette_.size() >= (size_t(1) << bitsPerIndex_))
+		{
+			resize(BitsForPaletteSize(palette_.size() + 1));
+		}
+		palette_.push_back(id);
+		updateView();
+	}
+
+	writeIndex(index, paletteIndex);
+} // end of set()
+
+void ChunkSection::fill(BlockID id)
+{
+	uniform_ = id;
+	bitsPerIndex_ = 0;
+	palette_.clear();
+	palette_.shrink_to_fit();
+	words_.clear();
+	words_.shrink_to_fit();
+	updateView();
+} // end of fill()
+
+void ChunkSection::pack(const BlockID* dense)
+{
+	// palette in order of first appearance
+	std::array<int16_t, 256> lookup;
+	lookup.fill(-1);
+
+	std::vector<BlockID> palette;
+	for (int i = 0; i < VOLUME; ++i)
+	{
+		uint8_t raw = static_cast<uint8_t>(dense[i]);
+		if (lookup[raw] < 0)
+		{
+			lookup[raw] = static_cast<int16_t>(palette.size());
+			palette.push_back(dense[i]);
+		}
+	} // end for
+
+	if (palette.size() == 1)
+	{
+		fill(palette[0]);
+		return;
+	}
+
+	palette_ = std::move(palette);
+	palette_.shrink_to_fit();
+	bitsPerIndex_ = BitsForPaletteSize(palette_.size());
+	words_.assign(WordCount(bitsPerIndex_), 0);
+	words_.shrink_to_fit();
+	updateView();
+
+	for (int i = 0; i < VOLUME; ++i)
+	{
+		writeIndex(i, static_cast<uint32_t>(lookup[static_cast<uint8_t>(dense[i])]));
+	} // end for
+} // end of pack()
+
+void ChunkSection::unpack(BlockID* dense) const
+{
+	if (bitsPerIndex_ == 0)
+	{
+		std::fill(dense, dense + VOLUME, uniform_);
+		return;
+	}
+
+	for (int i = 0; i < VOLUME; ++i)
+	{
+		dense[i] = palette_[readIndex(i)];
+	} // end for
+} // end of unpack()
+
+size_t ChunkSection::memoryUsageBytes() const
+{
+	return sizeof(ChunkSection) +
+		palette_.capacity() * sizeof(BlockID) +
+		words_.capacity() * sizeof(uint64_t);
+} // end of memoryUsageBytes()
+
+
+//--- PRIVATE ---//
+void ChunkSection::updateView()
+{
+	if (bitsPerIndex_ == 0)
+	{
+		paletteData_ = &uniform_;
+		wordData_ = ZERO_WORD;
+		wordMask_ = 0;
+		mask_ = 0;
+		shift_ = 0;
+		return;
+	}
+
+	paletteData_ = palette_.data();
+	wordData_ = words_.data();
+	wordMask_ = ~0u;
+	mask_ = (1u << bitsPerIndex_) - 1u;
+	shift_ = static_cast<uint8_t>(bitsPerIndex_ == 1 ? 0 : bitsPerIndex_ == 2 ? 1 : bitsPerIndex_ == 4 ? 2 : 3);
+} // end of updateView()
+
+uint32_t ChunkSection::readIndex(int index) const
+{
+	const uint32_t bit = static_cast<uint32_t>(index) * bitsPerIndex_;
+	const uint32_t mask = (1u << bitsPerIndex_) - 1u;
+	return static_cast<uint32_t>(words_[bit >> 6] >> (bit & 63)) & mask;
+} // end of readIndex()
+
+void ChunkSection::writeIndex(int index, uint32_t value)
+{
+	const uint32_t bit = static_cast<uint32_t>(index) * bitsPerIndex_;
+	const uint64_t mask = (uint64_t(1) << bitsPerIndex_) - 1u;
+
+	uint64_t& word = words_[bit >> 6];
+	word = (word & ~(mask << (bit & 63))) | (static_cast<uint64_t>(value) << (bit & 63));
+} // end of writeIndex()
+
+void ChunkSection::resize(uint8_t bitsPerIndex)
+{
+	// repack existing indices at the wider width
+	std::vector<uint32_t> indices(VOLUME);
+	for (int i = 0; i < VOLUME; ++i)
+	{
+		indices[i] = readIndex(i);
+	} // end for
+
+	bitsPerIndex_ = bitsPerIndex;
+	words_.assign(WordCount(bitsPerIndex_), 0);
+	updateView();
+
+	for (int i = 0; i < VOLUME; ++i)
+	{
+		writeIndex(i, indices[i]);
+	} // end for
+} // end of resize()
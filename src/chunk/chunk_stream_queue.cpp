@@ -0,0 +1,104 @@
+#include "chunk_stream_queue.h"
+
+#include "constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace World;
+
+//--- PUBLIC ---//
+void ChunkStreamQueue::setPrediction(const glm::vec2& position, const glm::vec2& predicted, const glm::vec2& forward)
+{
+	// re-key once the path moved a chunk or the view turned ~25 degrees
+	const float chunk2 = static_cast<float>(CHUNK_SIZE * CHUNK_SIZE);
+	const glm::vec2 movedFrom = position - position_;
+	const glm::vec2 movedTo = predicted - predicted_;
+	const glm::vec2 turned = forward - forward_;
+	if (keyed_ &&
+		glm::dot(movedFrom, movedFrom) < chunk2 &&
+		glm::dot(movedTo, movedTo) < chunk2 &&
+		glm::dot(turned, turned) < 0.2f)
+	{
+		return;
+	}
+
+	position_ = position;
+	predicted_ = predicted;
+	forward_ = forward;
+	keyed_ = true;
+
+	for (Entry& entry : heap_)
+	{
+		entry.priority = priority(entry.coord);
+	} // end for
+	std::make_heap(heap_.begin(), heap_.end(), Later);
+	++rekeys_;
+} // end of setPrediction()
+
+void ChunkStreamQueue::push(const ChunkCoord& coord)
+{
+	heap_.push_back({ priority(coord), coord });
+	std::push_heap(heap_.begin(), heap_.end(), Later);
+} // end of push()
+
+bool ChunkStreamQueue::pop(ChunkCoord& outCoord)
+{
+	if (heap_.empty())
+	{
+		return false;
+	}
+
+	std::pop_heap(heap_.begin(), heap_.end(), Later);
+	outCoord = heap_.back().coord;
+	heap_.pop_back();
+	return true;
+} // end of pop()
+
+void ChunkStreamQueue::dropOutside(int centerX, int centerZ, int radius, std::vector<ChunkCoord>& outDropped)
+{
+	const auto outside = [&](const Entry& entry)
+		{
+			return std::abs(entry.coord.x - centerX) > radius || std::abs(entry.coord.z - centerZ) > radius;
+		};
+
+	for (const Entry& entry : heap_)
+	{
+		if (outside(entry))
+		{
+			outDropped.push_back(entry.coord);
+		}
+	} // end for
+
+	heap_.erase(std::remove_if(heap_.begin(), heap_.end(), outside), heap_.end());
+	std::make_heap(heap_.begin(), heap_.end(), Later);
+} // end of dropOutside()
+
+float ChunkStreamQueue::priority(const ChunkCoord& coord) const
+{
+	const glm::vec2 center(
+		coord.x * CHUNK_SIZE + CHUNK_SIZE * 0.5f,
+		coord.z * CHUNK_SIZE + CHUNK_SIZE * 0.5f
+	);
+
+	// closest point on the predicted path
+	const glm::vec2 path = predicted_ - position_;
+	const float pathLength2 = glm::dot(path, path);
+	const float t = (pathLength2 > 0.0001f)
+		? std::clamp(glm::dot(center - position_, path) / pathLength2, 0.0f, 1.0f)
+		: 0.0f;
+	const float offPath = glm::length(center - (position_ + path * t));
+	const float alongPath = t * std::sqrt(pathLength2);
+
+	// chunks behind the view wait longer
+	float facing = 0.0f;
+	const glm::vec2 toCenter = center - position_;
+	const float toCenter2 = glm::dot(toCenter, toCenter);
+	if (toCenter2 > 0.0001f)
+	{
+		facing = glm::dot(toCenter, forward_) / std::sqrt(toCenter2);
+	}
+
+	return (offPath + 0.5f * alongPath) * (1.25f - 0.25f * facing);
+} // end of priority()
@@ -0,0 +1,13 @@
+#include "chunk_mesh_gpu_null.h"
+
+#include "chunk_mesh_data.h"
+
+//--- PUBLIC ---//
+void ChunkMeshGPUNull::upload(
+	GPUCommandContext,
+	const ChunkMeshData& data
+)
+{
+	++uploadCount_;
+	uploadedBytes_ += data.uploadSizeBytes();
+} // end of upload()
@@ -77,7 +77,7 @@ ChunkMeshGPUGL::~ChunkMeshGPUGL()
 } // end of destructor
 
 void ChunkMeshGPUGL::upload(
-	vk::CommandBuffer,
+	GPUCommandContext,
 	const ChunkMeshData& data
 )
 {
@@ -98,6 +98,7 @@ void ChunkMeshGPUGL::upload(
 	);
 
 	opaqueIndexCount_ = static_cast<int32_t>(data.opaqueIndices.size());
+	opaqueSections_ = data.opaqueSections;
 
 
 	// WATER reupload into vbo
@@ -119,23 +120,43 @@ void ChunkMeshGPUGL::upload(
 	waterIndexCount_ = static_cast<int32_t>(data.waterIndices.size());
 } // end of upload()
 
-void ChunkMeshGPUGL::drawOpaque(vk::CommandBuffer cmd)
+void ChunkMeshGPUGL::drawOpaque(GPUCommandContext, uint32_t sectionMask)
 {
 	if (opaqueIndexCount_ <= 0) return;
 
+	uint32_t first[MESH_SECTION_COUNT];
+	uint32_t count[MESH_SECTION_COUNT];
+	const int ranges = MeshSectionRanges(opaqueSections_.data(), sectionMask, first, count);
+	if (ranges == 0) return;
+
 	const GLboolean wasDepthEnabled = glIsEnabled(GL_DEPTH_TEST);
 
 	glEnable(GL_DEPTH_TEST);
 
 	glBindVertexArray(opaqueVao_);
-	glDrawElements(GL_TRIANGLES, opaqueIndexCount_, GL_UNSIGNED_INT, nullptr);
+	if (ranges == 1)
+	{
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count[0]), GL_UNSIGNED_INT,
+			reinterpret_cast<const void*>(static_cast<uintptr_t>(first[0]) * sizeof(uint32_t)));
+	}
+	else
+	{
+		GLsizei counts[MESH_SECTION_COUNT];
+		const void* offsets[MESH_SECTION_COUNT];
+		for (int i = 0; i < ranges; ++i)
+		{
+			counts[i] = static_cast<GLsizei>(count[i]);
+			offsets[i] = reinterpret_cast<const void*>(static_cast<uintptr_t>(first[i]) * sizeof(uint32_t));
+		} // end for
+		glMultiDrawElements(GL_TRIANGLES, counts, GL_UNSIGNED_INT, offsets, ranges);
+	}
 	glBindVertexArray(0);
 
 	if (!wasDepthEnabled)
 		glDisable(GL_DEPTH_TEST);
 } // end of drawOpaque()
 
-void ChunkMeshGPUGL::drawWater(vk::CommandBuffer cmd)
+void ChunkMeshGPUGL::drawWater(GPUCommandContext)
 {
 	if (waterIndexCount_ <= 0) return;
 
@@ -0,0 +1,284 @@
+#include "perlin_batch.h"
+
+#include <noise/interp.h>
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PERLIN_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PERLIN_BATCH_SSE2
+#endif
+
+// libnoise's gradient table (vectortable.h defines it, so not included here)
+namespace noise
+{
+	extern double g_randomVectors[256 * 4];
+}
+
+//--- HELPER ---//
+// lane types with the few operations the kernel needs. every operation is
+// a single IEEE double op, so lanes round exactly like the scalar code
+struct ScalarLanes
+{
+	using Type = double;
+	static constexpr int WIDTH = 1;
+	static Type Set1(double v) { return v; }
+	static Type Load(const double* p) { return *p; }
+	static void Store(double* p, Type v) { *p = v; }
+	static Type Add(Type a, Type b) { return a + b; }
+	static Type Sub(Type a, Type b) { return a - b; }
+	static Type Mul(Type a, Type b) { return a * b; }
+};
+
+#if defined(PERLIN_BATCH_AVX2)
+struct SimdLanes
+{
+	using Type = __m256d;
+	static constexpr int WIDTH = 4;
+	static Type Set1(double v) { return _mm256_set1_pd(v); }
+	static Type Load(const double* p) { return _mm256_loadu_pd(p); }
+	static void Store(double* p, Type v) { _mm256_storeu_pd(p, v); }
+	static Type Add(Type a, Type b) { return _mm256_add_pd(a, b); }
+	static Type Sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+	static Type Mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+};
+#elif defined(PERLIN_BATCH_SSE2)
+struct SimdLanes
+{
+	using Type = __m128d;
+	static constexpr int WIDTH = 2;
+	static Type Set1(double v) { return _mm_set1_pd(v); }
+	static Type Load(const double* p) { return _mm_loadu_pd(p); }
+	static void Store(double* p, Type v) { _mm_storeu_pd(p, v); }
+	static Type Add(Type a, Type b) { return _mm_add_pd(a, b); }
+	static Type Sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+	static Type Mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+};
+#else
+using SimdLanes = ScalarLanes;
+#endif
+
+// one lattice cell of one octave, corner c at (c & 1, (c >> 1) & 1, c >> 2)
+struct NoiseCell
+{
+	int axis;
+	// the varying coordinate's lattice coordinates
+	double lo;
+	double hi;
+	// fixed coordinates: distance to the low/high lattice plane, s-curve
+	double p0[3];
+	double p1[3];
+	double s[3];
+	double gradients[8][3];
+};
+
+// libnoise GradientNoise3D() table lookup, in unsigned math (same bits)
+static const double* Gradient(int ix, int iy, int iz, int seed)
+{
+	uint32_t index = 1619u * static_cast<uint32_t>(ix)
+		+ 31337u * static_cast<uint32_t>(iy)
+		+ 6971u * static_cast<uint32_t>(iz)
+		+ 1013u * static_cast<uint32_t>(seed);
+	index ^= index >> 8;
+	index &= 0xff;
+	return &noise::g_randomVectors[index << 2];
+} // end of Gradient()
+
+static double Curve(double a, noise::NoiseQuality quality)
+{
+	switch (quality)
+	{
+	case noise::QUALITY_FAST:
+		return a;
+	case noise::QUALITY_BEST:
+		return noise::SCurve5(a);
+	default:
+		return noise::SCurve3(a);
+	}
+} // end of Curve()
+
+static inline int LatticeFloor(double n)
+{
+	// libnoise's rounding, 0 and negative integers go one cell down
+	return n > 0.0 ? static_cast<int>(n) : static_cast<int>(n) - 1;
+} // end of LatticeFloor()
+
+// value += GradientCoherentNoise3D() * persistence over count samples
+// (a multiple of L::WIDTH) of one cell, in the order libnoise computes it
+template <typename L>
+static void AccumulateCell(const NoiseCell& cell, const double* n, const double* s, double persistence, int count, double* value)
+{
+	using V = typename L::Type;
+
+	V p0[3];
+	V p1[3];
+	V curve[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		p0[k] = L::Set1(cell.p0[k]);
+		p1[k] = L::Set1(cell.p1[k]);
+		curve[k] = L::Set1(cell.s[k]);
+	} // end for
+
+	V g[8][3];
+	for (int c = 0; c < 8; ++c)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			g[c][k] = L::Set1(cell.gradients[c][k]);
+		} // end for
+	} // end for
+
+	const V one = L::Set1(1.0);
+	const V scale = L::Set1(2.12);
+	const V weight = L::Set1(persistence);
+	const V lo = L::Set1(cell.lo);
+	const V hi = L::Set1(cell.hi);
+
+	const auto corner = [&](int c)
+		{
+			const V px = (c & 1) ? p1[0] : p0[0];
+			const V py = (c & 2) ? p1[1] : p0[1];
+			const V pz = (c & 4) ? p1[2] : p0[2];
+			return L::Mul(L::Add(L::Add(L::Mul(g[c][0], px), L::Mul(g[c][1], py)), L::Mul(g[c][2], pz)), scale);
+		};
+	const auto lerp = [&](V n0, V n1, V a)
+		{
+			return L::Add(L::Mul(L::Sub(one, a), n0), L::Mul(a, n1));
+		};
+
+	for (int i = 0; i < count; i += L::WIDTH)
+	{
+		const V coord = L::Load(n + i);
+		p0[cell.axis] = L::Sub(coord, lo);
+		p1[cell.axis] = L::Sub(coord, hi);
+		curve[cell.axis] = L::Load(s + i);
+
+		V ix0 = lerp(corner(0), corner(1), curve[0]);
+		V ix1 = lerp(corner(2), corner(3), curve[0]);
+		const V iy0 = lerp(ix0, ix1, curve[1]);
+		ix0 = lerp(corner(4), corner(5), curve[0]);
+		ix1 = lerp(corner(6), corner(7), curve[0]);
+		const V iy1 = lerp(ix0, ix1, curve[1]);
+		const V signal = lerp(iy0, iy1, curve[2]);
+
+		L::Store(value + i, L::Add(L::Load(value + i), L::Mul(signal, weight)));
+	} // end for
+} // end of AccumulateCell()
+
+
+//--- PUBLIC ---//
+PerlinBatch::PerlinBatch(const noise::module::Perlin& source)
+	: frequency_(source.GetFrequency()),
+	lacunarity_(source.GetLacunarity()),
+	persistence_(source.GetPersistence()),
+	octaveCount_(source.GetOctaveCount()),
+	seed_(source.GetSeed()),
+	quality_(source.GetNoiseQuality())
+{
+} // end of constructor
+
+void PerlinBatch::getLine(Axis axis, double x, double y, double z, const double* values, int count, double* out) const
+{
+	const double fixed[3] = { x, y, z };
+	for (int start = 0; start < count; start += BLOCK)
+	{
+		const int n = (count - start < BLOCK) ? count - start : BLOCK;
+		getBlock(static_cast<int>(axis), fixed, values + start, n, out + start);
+	} // end for
+} // end of getLine()
+
+
+//--- PRIVATE ---//
+void PerlinBatch::getBlock(int axis, const double* fixed, const double* values, int count, double* out) const
+{
+	// the same scaling steps as Perlin::GetValue(), per coordinate
+	double coords[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		coords[k] = fixed[k] * frequency_;
+	} // end for
+
+	double line[BLOCK];
+	double value[BLOCK];
+	for (int i = 0; i < count; ++i)
+	{
+		line[i] = values[i] * frequency_;
+		value[i] = 0.0;
+	} // end for
+
+	double n[BLOCK];
+	double s[BLOCK];
+	int cells[BLOCK];
+	double persistence = 1.0;
+
+	for (int octave = 0; octave < octaveCount_; ++octave)
+	{
+		const int seed = static_cast<int>(static_cast<uint32_t>(seed_ + octave));
+
+		NoiseCell cell;
+		cell.axis = axis;
+		int lattice[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			const double c = noise::MakeInt32Range(coords[k]);
+			lattice[k] = LatticeFloor(c);
+			cell.p0[k] = c - static_cast<double>(lattice[k]);
+			cell.p1[k] = c - static_cast<double>(lattice[k] + 1);
+			cell.s[k] = Curve(c - static_cast<double>(lattice[k]), quality_);
+		} // end for
+
+		for (int i = 0; i < count; ++i)
+		{
+			n[i] = noise::MakeInt32Range(line[i]);
+			cells[i] = LatticeFloor(n[i]);
+			s[i] = Curve(n[i] - static_cast<double>(cells[i]), quality_);
+		} // end for
+
+		// runs of samples in one cell share its gradients
+		for (int begin = 0; begin < count;)
+		{
+			int end = begin + 1;
+			while (end < count && cells[end] == cells[begin])
+			{
+				++end;
+			} // end while
+
+			lattice[axis] = cells[begin];
+			cell.lo = static_cast<double>(lattice[axis]);
+			cell.hi = static_cast<double>(lattice[axis] + 1);
+			for (int c = 0; c < 8; ++c)
+			{
+				const double* g = Gradient(lattice[0] + (c & 1), lattice[1] + ((c >> 1) & 1), lattice[2] + (c >> 2), seed);
+				cell.gradients[c][0] = g[0];
+				cell.gradients[c][1] = g[1];
+				cell.gradients[c][2] = g[2];
+			} // end for
+
+			const int simdCount = (end - begin) / SimdLanes::WIDTH * SimdLanes::WIDTH;
+			AccumulateCell<SimdLanes>(cell, n + begin, s + begin, persistence, simdCount, value + begin);
+			AccumulateCell<ScalarLanes>(cell, n + begin + simdCount, s + begin + simdCount, persistence,
+				end - begin - simdCount, value + begin + simdCount);
+
+			begin = end;
+		} // end for
+
+		for (int k = 0; k < 3; ++k)
+		{
+			coords[k] *= lacunarity_;
+		} // end for
+		for (int i = 0; i < count; ++i)
+		{
+			line[i] *= lacunarity_;
+		} // end for
+		persistence *= persistence_;
+	} // end for
+
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = value[i];
+	} // end for
+} // end of getBlock()
@@ -0,0 +1,556 @@
+#include "terrain_generator.h"
+
+#include "chunk_grid.h"
+#include "chunk_mesh.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+//--- HELPER ---//
+static inline int DenseIndex(int x, int y, int z)
+{
+	return x + CHUNK_SIZE * (z + CHUNK_SIZE * y);
+} // end of DenseIndex()
+
+static const noise::module::Perlin& ConfigureNoise(noise::module::Perlin& perlin, int seed, double frequency,
+	double persistence, double lacunarity, int octaves)
+{
+	perlin.SetSeed(seed);
+	perlin.SetFrequency(frequency);
+	perlin.SetPersistence(persistence);
+	perlin.SetLacunarity(lacunarity);
+	perlin.SetOctaveCount(octaves);
+	return perlin;
+} // end of ConfigureNoise()
+
+
+//--- PUBLIC ---//
+// the batches copy the modules' settings, the modules are declared (and so
+// configured) first
+TerrainGenerator::TerrainGenerator(const TerrainSettings& settings)
+	: settings_(settings),
+	heightBatch_(ConfigureNoise(heightNoise_, settings.seed, settings.heightFrequency,
+		settings.heightPersistence, settings.heightLacunarity, settings.heightOctaves)),
+	caveBatch_(ConfigureNoise(caveNoise_, settings.seed, settings.caveFrequency,
+		settings.cavePersistence, settings.caveLacunarity, settings.caveOctaves))
+{
+} // end of constructor
+
+const TerrainGenerator& TerrainGenerator::standard()
+{
+	static const TerrainGenerator generator;
+	return generator;
+} // end of standard()
+
+void TerrainGenerator::generate(const ChunkCoord& coord, ChunkData& out, NoisePath path) const
+{
+	out.m_chunkX = coord.x;
+	out.m_chunkZ = coord.z;
+
+	// scratch state lives only for this call
+	std::array<float, CHUNK_SIZE * CHUNK_SIZE> heightMap;
+	sampleHeightMap(coord, path, heightMap.data());
+
+	auto blocks = std::make_unique<BlockID[]>(CHUNK_VOLUME);
+
+	// remember columns ground height
+	std::array<int, CHUNK_SIZE * CHUNK_SIZE> columnHeights;
+	int lowest = CHUNK_SIZE_Y - 1;
+	int highest = 0;
+	for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i)
+	{
+		columnHeights[i] = groundHeight(heightMap[i]);
+		lowest = std::min(lowest, columnHeights[i]);
+		highest = std::max(highest, columnHeights[i]);
+	} // end for
+
+	fillTerrain(columnHeights.data(), lowest, highest, blocks.get());
+
+	// carve caves after terrain, before ore and trees
+	if (settings_.caveLatticeXZ > 1 || settings_.caveLatticeY > 1)
+	{
+		carveCavesLattice(coord, path, columnHeights.data(), blocks.get());
+	}
+	else
+	{
+		carveCaves(coord, path, columnHeights.data(), blocks.get());
+	}
+
+	// only place ore in remaining stone, and only in layers some ore reaches
+	const int oreTop = std::min(highest - 4,
+		std::max({ settings_.iron.maxY, settings_.diamond.maxY, settings_.gold.maxY }));
+	for (int y = 1; y < oreTop; ++y)
+	{
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			for (int x = 0; x < CHUNK_SIZE; ++x)
+			{
+				if (y < columnHeights[x + CHUNK_SIZE * z] - 4 && blocks[DenseIndex(x, y, z)] == BlockID::Stone)
+				{
+					placeOre(blocks.get(), coord.x * CHUNK_SIZE + x, coord.z * CHUNK_SIZE + z, x, y, z);
+				}
+			} // end for
+		} // end for
+	} // end for
+
+	// place trees after terrain
+	for (int x = 0; x < CHUNK_SIZE; ++x)
+	{
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			int height = columnHeights[x + CHUNK_SIZE * z];
+			placeTree(blocks.get(), coord.x * CHUNK_SIZE + x, coord.z * CHUNK_SIZE + z, x, height, z);
+		} // end for
+	} // end for
+
+	out.loadData(blocks.get());
+} // end of generate()
+
+std::string TerrainGenerator::cacheName() const
+{
+	uint32_t h = 2166136261u;
+	const auto mix = [&](const auto& value)
+		{
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+			for (size_t i = 0; i < sizeof(value); ++i)
+			{
+				h ^= bytes[i];
+				h *= 16777619u;
+			} // end for
+		};
+
+	// every setting but the seed, field by field (no padding bytes)
+	mix(settings_.heightScale);
+	mix(settings_.heightFrequency);
+	mix(settings_.heightPersistence);
+	mix(settings_.heightLacunarity);
+	mix(settings_.heightOctaves);
+	mix(settings_.minGround);
+	mix(settings_.maxTerrain);
+	mix(settings_.seaLevel);
+	mix(settings_.caveScale);
+	mix(settings_.caveFrequency);
+	mix(settings_.cavePersistence);
+	mix(settings_.caveLacunarity);
+	mix(settings_.caveOctaves);
+	mix(settings_.caveThreshold);
+	mix(settings_.caveLatticeXZ);
+	mix(settings_.caveLatticeY);
+	for (const TerrainSettings::Ore& ore : { settings_.iron, settings_.diamond, settings_.gold })
+	{
+		mix(ore.block);
+		mix(ore.maxY);
+		mix(ore.chance);
+	} // end for
+	mix(settings_.treeChance);
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "%d_v%d_%08x", settings_.seed, VERSION, h);
+	return name;
+} // end of cacheName()
+
+int TerrainGenerator::surfaceHeight(int cx, int cz, int x, int z) const
+{
+	double samplesX[CHUNK_SIZE];
+	double samplesZ[CHUNK_SIZE];
+	planeSamples(cx, samplesX);
+	planeSamples(cz, samplesZ);
+
+	return groundHeight(static_cast<float>(heightNoise_.GetValue(samplesX[x], 0.0, samplesZ[z])));
+} // end of surfaceHeight()
+
+
+//--- PRIVATE ---//
+int TerrainGenerator::groundHeight(float n) const
+{
+	float n01 = (n + 1.0f) * 0.5f;
+
+	int height = settings_.minGround + static_cast<int>(n01 * settings_.maxTerrain);
+
+	if (height < 0)
+	{
+		height = 0;
+	}
+
+	if (height >= CHUNK_SIZE_Y)
+	{
+		height = CHUNK_SIZE_Y - 1;
+	}
+
+	return height;
+} // end of groundHeight()
+
+void TerrainGenerator::planeSamples(int c, double* out) const
+{
+	const double scale = settings_.heightScale;
+
+	const double lower = (c * CHUNK_SIZE) * scale;
+	const double upper = (c * CHUNK_SIZE + CHUNK_SIZE) * scale;
+	const double delta = (upper - lower) / static_cast<double>(CHUNK_SIZE);
+
+	double cur = lower;
+	for (int i = 0; i < CHUNK_SIZE; ++i)
+	{
+		out[i] = cur;
+		cur += delta;
+	} // end for
+} // end of planeSamples()
+
+void TerrainGenerator::sampleHeightMap(const ChunkCoord& coord, NoisePath path, float* heights) const
+{
+	double samplesX[CHUNK_SIZE];
+	double samplesZ[CHUNK_SIZE];
+	planeSamples(coord.x, samplesX);
+	planeSamples(coord.z, samplesZ);
+
+	double row[CHUNK_SIZE];
+	for (int z = 0; z < CHUNK_SIZE; ++z)
+	{
+		if (path == NoisePath::Batch)
+		{
+			heightBatch_.getLine(PerlinBatch::Axis::X, 0.0, 0.0, samplesZ[z], samplesX, CHUNK_SIZE, row);
+		}
+		else
+		{
+			for (int x = 0; x < CHUNK_SIZE; ++x)
+			{
+				row[x] = heightNoise_.GetValue(samplesX[x], 0.0, samplesZ[z]);
+			} // end for
+		}
+
+		// the noise map stores floats
+		for (int x = 0; x < CHUNK_SIZE; ++x)
+		{
+			heights[x + CHUNK_SIZE * z] = static_cast<float>(row[x]);
+		} // end for
+	} // end for
+} // end of sampleHeightMap()
+
+void TerrainGenerator::fillTerrain(const int* columnHeights, int lowest, int highest, BlockID* blocks) const
+{
+	constexpr int LAYER = CHUNK_SIZE * CHUNK_SIZE;
+
+	// layers below every column's dirt are all stone
+	const int stoneTop = std::max(0, lowest - 2);
+	std::fill(blocks, blocks + stoneTop * LAYER, BlockID::Stone);
+
+	// layers a surface passes through, written in layout order
+	BlockID* cur = blocks + stoneTop * LAYER;
+	for (int y = stoneTop; y <= highest; ++y)
+	{
+		for (int i = 0; i < LAYER; ++i)
+		{
+			const int height = columnHeights[i];
+			if (y > height)
+			{
+				*cur++ = (y <= settings_.seaLevel) ? BlockID::Water : BlockID::Air;
+			}
+			else if (y == height)
+			{
+				*cur++ = (height < settings_.seaLevel + 2) ? BlockID::Sand : BlockID::SnowGrass;
+			}
+			else
+			{
+				*cur++ = (y > height - 3) ? BlockID::Dirt : BlockID::Stone;
+			}
+		} // end for
+	} // end for
+
+	// layers above every surface are water up to sea level, then air
+	const int waterTop = std::clamp(settings_.seaLevel + 1, highest + 1, CHUNK_SIZE_Y);
+	std::fill(blocks + (highest + 1) * LAYER, blocks + waterTop * LAYER, BlockID::Water);
+	std::fill(blocks + waterTop * LAYER, blocks + CHUNK_VOLUME, BlockID::Air);
+} // end of fillTerrain()
+
+void TerrainGenerator::sampleCaveColumn(int worldX, int worldZ, int firstY, int stepY, int count, NoisePath path, double* out) const
+{
+	double scale = settings_.caveScale;
+
+	if (path == NoisePath::Reference)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			out[i] = caveNoise_.GetValue(
+				worldX * scale,
+				(firstY + i * stepY) * scale,
+				worldZ * scale
+			);
+		} // end for
+		return;
+	}
+
+	double ys[CHUNK_SIZE_Y + 1];
+	for (int i = 0; i < count; ++i)
+	{
+		ys[i] = (firstY + i * stepY) * scale;
+	} // end for
+
+	caveBatch_.getLine(PerlinBatch::Axis::Y, worldX * scale, 0.0, worldZ * scale, ys, count, out);
+} // end of sampleCaveColumn()
+
+void TerrainGenerator::carveCaves(const ChunkCoord& coord, NoisePath path, const int* columnHeights, BlockID* blocks) const
+{
+	std::array<double, CHUNK_SIZE_Y> caveColumn;
+	for (int x = 0; x < CHUNK_SIZE; ++x)
+	{
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			int height = columnHeights[x + CHUNK_SIZE * z];
+			if (height - 5 <= 0)
+			{
+				continue;
+			}
+			sampleCaveColumn(coord.x * CHUNK_SIZE + x, coord.z * CHUNK_SIZE + z, 1, 1, height - 5, path, caveColumn.data());
+
+			for (int y = 1; y < height - 4; ++y)
+			{
+				BlockID& cur = blocks[DenseIndex(x, y, z)];
+				if (caveColumn[y - 1] > settings_.caveThreshold &&
+					(cur == BlockID::Stone || cur == BlockID::Dirt))
+				{
+					cur = BlockID::Air;
+				}
+			} // end for
+		} // end for
+	} // end for
+} // end of carveCaves()
+
+void TerrainGenerator::carveCavesLattice(const ChunkCoord& coord, NoisePath path, const int* columnHeights, BlockID* blocks) const
+{
+	const int stepXZ = std::max(1, settings_.caveLatticeXZ);
+	const int stepY = std::max(1, settings_.caveLatticeY);
+
+	int top = 0;
+	for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i)
+	{
+		top = std::max(top, columnHeights[i] - 5);
+	} // end for
+	if (top < 1)
+	{
+		return;
+	}
+
+	// world aligned lattice points covering the chunk, neighbours sample
+	// the same points along their shared border
+	const int worldX0 = coord.x * CHUNK_SIZE;
+	const int worldZ0 = coord.z * CHUNK_SIZE;
+	const int latticeX0 = FloorDiv(worldX0, stepXZ);
+	const int latticeZ0 = FloorDiv(worldZ0, stepXZ);
+	const int countX = FloorDiv(worldX0 + CHUNK_SIZE - 1, stepXZ) - latticeX0 + 2;
+	const int countZ = FloorDiv(worldZ0 + CHUNK_SIZE - 1, stepXZ) - latticeZ0 + 2;
+	const int countY = top / stepY + 2;
+
+	// (ix * countZ + iz) * countY + iy
+	std::vector<double> lattice(static_cast<size_t>(countX) * countZ * countY);
+	for (int ix = 0; ix < countX; ++ix)
+	{
+		for (int iz = 0; iz < countZ; ++iz)
+		{
+			sampleCaveColumn((latticeX0 + ix) * stepXZ, (latticeZ0 + iz) * stepXZ, 0, stepY, countY, path,
+				&lattice[(static_cast<size_t>(ix) * countZ + iz) * countY]);
+		} // end for
+	} // end for
+	const auto at = [&](int ix, int iy, int iz)
+		{
+			return lattice[(static_cast<size_t>(ix) * countZ + iz) * countY + iy];
+		};
+	const auto lerp = [](double a, double b, double t)
+		{
+			return a + (b - a) * t;
+		};
+
+	const double threshold = settings_.caveThreshold;
+	for (int ix = 0; ix + 1 < countX; ++ix)
+	{
+		for (int iz = 0; iz + 1 < countZ; ++iz)
+		{
+			for (int iy = 0; iy + 1 < countY; ++iy)
+			{
+				// interpolated values never exceed the largest corner
+				double corners[8];
+				double highest = -1.0e30;
+				for (int c = 0; c < 8; ++c)
+				{
+					corners[c] = at(ix + (c & 1), iy + ((c >> 1) & 1), iz + (c >> 2));
+					highest = std::max(highest, corners[c]);
+				} // end for
+				if (highest <= threshold)
+				{
+					continue;
+				}
+
+				const int x0 = std::max(0, (latticeX0 + ix) * stepXZ - worldX0);
+				const int x1 = std::min(CHUNK_SIZE, (latticeX0 + ix + 1) * stepXZ - worldX0);
+				const int z0 = std::max(0, (latticeZ0 + iz) * stepXZ - worldZ0);
+				const int z1 = std::min(CHUNK_SIZE, (latticeZ0 + iz + 1) * stepXZ - worldZ0);
+				for (int x = x0; x < x1; ++x)
+				{
+					const double tx = static_cast<double>(worldX0 + x - (latticeX0 + ix) * stepXZ) / stepXZ;
+					for (int z = z0; z < z1; ++z)
+					{
+						const double tz = static_cast<double>(worldZ0 + z - (latticeZ0 + iz) * stepXZ) / stepXZ;
+						const double y0 = lerp(lerp(corners[0], corners[1], tx), lerp(corners[4], corners[5], tx), tz);
+						const double y1 = lerp(lerp(corners[2], corners[3], tx), lerp(corners[6], corners[7], tx), tz);
+
+						const int yEnd = std::min((iy + 1) * stepY, columnHeights[x + CHUNK_SIZE * z] - 4);
+						for (int y = std::max(1, iy * stepY); y < yEnd; ++y)
+						{
+							const double value = lerp(y0, y1, static_cast<double>(y - iy * stepY) / stepY);
+							BlockID& cur = blocks[DenseIndex(x, y, z)];
+							if (value > threshold && (cur == BlockID::Stone || cur == BlockID::Dirt))
+							{
+								cur = BlockID::Air;
+							}
+						} // end for
+					} // end for
+				} // end for
+			} // end for
+		} // end for
+	} // end for
+} // end of carveCavesLattice()
+
+void TerrainGenerator::placeOre(BlockID* blocks, int worldX, int worldZ, int x, int y, int z) const
+{
+	uint32_t h = 2166136261u;
+
+	auto mix = [&](int v)
+		{
+			h ^= static_cast<uint32_t>(v);
+			h *= 16777619u;
+		};
+
+	mix(worldX);
+	mix(y);
+	mix(worldZ);
+
+	std::minstd_rand rng(h);
+
+	// each ore draws only when the depth allows it, later ores win
+	for (const TerrainSettings::Ore& ore : { settings_.iron, settings_.diamond, settings_.gold })
+	{
+		if (y < ore.maxY && (rng() % ore.chance) == 0)
+		{
+			blocks[DenseIndex(x, y, z)] = ore.block;
+		}
+	} // end for
+} // end of placeOre()
+
+void TerrainGenerator::placeTree(BlockID* blocks, int worldX, int worldZ, int x, int groundY, int z) const
+{
+	// should place above sea level
+	if (groundY <= settings_.seaLevel + 1)
+	{
+		return;
+	}
+
+	// do not place tree if leaves crossover to next chunk
+	const int leafRadius = 4;
+	if (x < leafRadius || x >= CHUNK_SIZE - leafRadius ||
+		z < leafRadius || z >= CHUNK_SIZE - leafRadius)
+	{
+		return;
+	}
+
+	// ensure enough space for tree
+	if (groundY + 7 >= CHUNK_SIZE_Y)
+	{
+		return;
+	}
+
+	// tree should be placed on grass block only
+	if ((blocks[DenseIndex(x, groundY, z)] != BlockID::Grass) &&
+		(blocks[DenseIndex(x, groundY, z)] != BlockID::SnowGrass))
+	{
+		return;
+	}
+
+	// get deterministic random
+	uint32_t h = 2166136261u;
+	auto mix = [&](int v) {
+		h ^= static_cast<uint32_t>(v);
+		h *= 16777619u;
+		};
+	mix(worldX);
+	mix(worldZ);
+
+	std::minstd_rand rng(h);
+
+	if (static_cast<int>(rng() % 100) >= settings_.treeChance)
+	{
+		return;
+	}
+
+	int trunkHeight = 4 + (rng() % 10);
+	int baseY = groundY + 1;
+	int topY = baseY + trunkHeight - 5;
+
+	// place trunk
+	for (int ty = baseY; ty <= topY; ++ty)
+	{
+		if (ty >= 0 && ty < CHUNK_SIZE_Y)
+		{
+			blocks[DenseIndex(x, ty, z)] = BlockID::Tree_Trunk;
+		}
+	} // end for
+
+
+	// place leaves
+	int canopyBottom = topY - 2;
+	int canopyTop = topY + 1;
+
+	for (int y = canopyBottom; y <= canopyTop; ++y)
+	{
+		if (y < 0 || y >= CHUNK_SIZE_Y)
+		{
+			continue;
+		}
+
+		int dy = y - topY;
+
+		// vertical taper: smaller radius at very top/bottom
+		int radius = (dy == -2 || dy == 1) ? 1 : 2;
+
+		for (int dx = -radius; dx <= radius; ++dx)
+		{
+			int lx = x + dx;
+			if (lx < 0 || lx >= CHUNK_SIZE)
+				continue;
+
+			for (int dz = -radius; dz <= radius; ++dz)
+			{
+				int lz = z + dz;
+				if (lz < 0 || lz >= CHUNK_SIZE)
+					continue;
+
+				// don't overwrite the trunk column on lower layers
+				if (dx == 0 && dz == 0 && y <= topY)
+				{
+					continue;
+				}
+
+				// skip corners on the full layers to round it off
+				if (radius == 2 && std::abs(dx) == 2 && std::abs(dz) == 2)
+				{
+					continue;
+				}
+
+				// add tiny randomness for holes in outer leaves
+				if (radius == 2 && (rng() % 5) == 0)
+				{
+					continue;
+				}
+
+				BlockID& cur = blocks[DenseIndex(lx, y, lz)];
+				if (cur == BlockID::Air || cur == BlockID::Water)
+				{
+					cur = BlockID::Tree_Leaf;
+				}
+			} // end for
+		} // end for
+	} // end for
+} // end of placeTree()
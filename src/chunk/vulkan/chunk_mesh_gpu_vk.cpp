@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.hpp>
 
 #include "vulkan_main.h"
+#include "utils_vk.h"
 #include "chunk_mesh_data.h"
 
 #include <vector>
@@ -37,10 +38,11 @@ ChunkMeshGPUVk::~ChunkMeshGPUVk()
 } // end of destructor
 
 void ChunkMeshGPUVk::upload(
-	vk::CommandBuffer cmd,
+	GPUCommandContext context,
 	const ChunkMeshData& data
 )
 {
+	vk::CommandBuffer cmd = VkUtils::ToCommandBuffer(context);
 	const bool rtEnabled = vk_->supportsRayTracing();
 
 	BufferVk newOpaqueRTVB(*vk_);
@@ -339,6 +341,7 @@ void ChunkMeshGPUVk::upload(
 	opaqueRTVertexCount_ = newOpaqueRTVertexCount;
 	opaqueRTIndexCount_ = newOpaqueRTIndexCount;
 	opaqueIndexCount_ = newOpaqueIndexCount;
+	opaqueSections_ = data.opaqueSections;
 
 	waterRTVertexCount_ = newWaterRTVertexCount;
 	waterRTIndexCount_ = newWaterRTIndexCount;
@@ -425,21 +428,32 @@ void ChunkMeshGPUVk::upload(
 	stagingBuffers.clear();
 } // end of upload()
 
-void ChunkMeshGPUVk::drawOpaque(vk::CommandBuffer cmd)
+void ChunkMeshGPUVk::drawOpaque(GPUCommandContext context, uint32_t sectionMask)
 {
+	vk::CommandBuffer cmd = VkUtils::ToCommandBuffer(context);
 	if (!cmd || opaqueIndexCount_ == 0 || !opaqueVB_.valid() || !opaqueIB_.valid())
 		return;
 
+	uint32_t first[MESH_SECTION_COUNT];
+	uint32_t count[MESH_SECTION_COUNT];
+	const int ranges = MeshSectionRanges(opaqueSections_.data(), sectionMask, first, count);
+	if (ranges == 0)
+		return;
+
 	vk::Buffer vb = opaqueVB_.getBuffer();
 	vk::DeviceSize offset = 0;
 
 	cmd.bindVertexBuffers(0, 1, &vb, &offset);
 	cmd.bindIndexBuffer(opaqueIB_.getBuffer(), 0, vk::IndexType::eUint32);
-	cmd.drawIndexed(opaqueIndexCount_, 1, 0, 0, 0);
+	for (int i = 0; i < ranges; ++i)
+	{
+		cmd.drawIndexed(count[i], 1, first[i], 0, 0);
+	} // end for
 } // end of drawOpaque()
 
-void ChunkMeshGPUVk::drawWater(vk::CommandBuffer cmd)
+void ChunkMeshGPUVk::drawWater(GPUCommandContext context)
 {
+	vk::CommandBuffer cmd = VkUtils::ToCommandBuffer(context);
 	if (!cmd || waterIndexCount_ == 0 || !waterVB_.valid() || !waterIB_.valid())
 		return;
 
@@ -9,6 +9,7 @@
 #include "cubemap_gl.h"
 #include "crosshair.h"
 #include "chunk_manager.h"
+#include "chunk_mesh_gpu_gl.h"
 #include "light_gl.h"
 
 #include <glm/glm.hpp>
@@ -26,7 +27,8 @@ Scene::~Scene() = default;
 void Scene::init()
 {
 	world_ = std::make_unique<ChunkManager>();
-	world_->init(nullptr);
+	world_->init({ []() { return std::make_shared<ChunkMeshGPUGL>(); }, false });
+	world_->setLodRadius(DEFAULT_LOD_RADIUS);
 
 	camera_ = std::make_unique<Camera>(width_, height_, glm::vec3(0.0f, CHUNK_SIZE_Y, 3.0f));
 
@@ -71,7 +73,8 @@ void Scene::update(float dt, const InputState& in)
 
 	if (in.quitRequested)
 	{
-		world_->saveWorld();
+		// wait for the save thread before shutdown
+		world_->flushWorld();
 		return;
 	}
 
@@ -109,6 +112,9 @@ void Scene::update(float dt, const InputState& in)
 				camera_->getCameraDirection());
 		}
 	}
+
+	// streaming predicts from this
+	camera_->updateVelocity(dt);
 } // end of update()
 
 void Scene::onResize(int w, int h)
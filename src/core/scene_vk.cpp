@@ -11,6 +11,7 @@
 #include "cubemap_vk.h"
 #include "crosshair_vk.h"
 #include "chunk_manager.h"
+#include "chunk_mesh_gpu_vk.h"
 #include "light_vk.h"
 
 #include <glm/glm.hpp>
@@ -28,7 +29,8 @@ SceneVk::~SceneVk() = default;
 void SceneVk::init()
 {
 	world_ = std::make_unique<ChunkManager>();
-	world_->init(&vk_);
+	world_->init({ [this]() { return std::make_shared<ChunkMeshGPUVk>(vk_); }, true });
+	world_->setLodRadius(DEFAULT_LOD_RADIUS);
 
 	camera_ = std::make_unique<Camera>(width_, height_, glm::vec3(0.0f, CHUNK_SIZE_Y, 3.0f));
 
@@ -73,7 +75,8 @@ void SceneVk::update(float dt, const InputState& in)
 
 	if (in.quitRequested)
 	{
-		world_->saveWorld();
+		// wait for the save thread before shutdown
+		world_->flushWorld();
 		return;
 	}
 
@@ -111,6 +114,9 @@ void SceneVk::update(float dt, const InputState& in)
 				camera_->getCameraDirection());
 		}
 	}
+
+	// streaming predicts from this
+	camera_->updateVelocity(dt);
 } // end of update()
 
 void SceneVk::onResize(int w, int h)
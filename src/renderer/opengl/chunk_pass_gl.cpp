@@ -72,8 +72,7 @@ void ChunkPassGL::renderOpaque(
     glBindTextureUnit(TO_API_FORM(ChunkBinding::AtlasTex), atlas_->ID());
     glBindTextureUnit(TO_API_FORM(ChunkBinding::SSAOTex), ssaoTex);
 
-    ChunkDrawList list;
-    in.world->buildOpaqueDrawList(view, proj, list);
+    const ChunkDrawList& list = in.world->opaqueDrawListFor(view, proj);
 
     opaqueShader_->use();
     chunkOpaqueUBO_.u_view = view;
@@ -82,10 +81,23 @@ void ChunkPassGL::renderOpaque(
 
     for (const auto& item : list.items)
     {
+        IChunkMeshGPU* gpu = list.gpu(item);
+        if (!gpu)
+            continue;
+
         chunkOpaqueUBO_.u_chunkOrigin = item.chunkOrigin;
         uboOpaque_.update(&chunkOpaqueUBO_, sizeof(chunkOpaqueUBO_));
-        item.gpu->drawOpaque({});
+        gpu->drawOpaque({}, item.opaqueSectionMask);
     }
+
+    // far terrain
+    renderOpaqueOffscreen(
+        uboOpaque_,
+        &chunkOpaqueUBO_,
+        sizeof(chunkOpaqueUBO_),
+        chunkOpaqueUBO_.u_chunkOrigin,
+        in.world->lodDrawListFor(view, proj)
+    );
 } // end of renderOpaque()
 
 void ChunkPassGL::renderOpaque(
@@ -106,8 +118,7 @@ void ChunkPassGL::renderOpaque(
     glBindTextureUnit(TO_API_FORM(ChunkBinding::SSAOTex), ssaoTex);
     glBindTextureUnit(TO_API_FORM(ChunkBinding::ShadowTex), shadowTex);
 
-    ChunkDrawList list;
-    in.world->buildOpaqueDrawList(view, proj, list);
+    const ChunkDrawList& list = in.world->opaqueDrawListFor(view, proj);
 
     opaqueShader_->use();
     chunkOpaqueUBO_.u_lightSpaceMatrix = lightSpaceMatrix;
@@ -117,10 +128,23 @@ void ChunkPassGL::renderOpaque(
 
     for (const auto& item : list.items)
     {
+        IChunkMeshGPU* gpu = list.gpu(item);
+        if (!gpu)
+            continue;
+
         chunkOpaqueUBO_.u_chunkOrigin = item.chunkOrigin;
         uboOpaque_.update(&chunkOpaqueUBO_, sizeof(chunkOpaqueUBO_));
-        item.gpu->drawOpaque({});
+        gpu->drawOpaque({}, item.opaqueSectionMask);
     }
+
+    // far terrain
+    renderOpaqueOffscreen(
+        uboOpaque_,
+        &chunkOpaqueUBO_,
+        sizeof(chunkOpaqueUBO_),
+        chunkOpaqueUBO_.u_chunkOrigin,
+        in.world->lodDrawListFor(view, proj)
+    );
 } // end of renderOpaque()
 
 void ChunkPassGL::renderOpaqueOffscreen(
@@ -133,13 +157,38 @@ void ChunkPassGL::renderOpaqueOffscreen(
     const glm::mat4& proj
 )
 {
-    ChunkDrawList list;
-    in.world->buildOpaqueDrawList(view, proj, list);
+    renderOpaqueOffscreen(
+        uboGL,
+        ubo,
+        uboSize,
+        chunkOrigin,
+        in.world->opaqueDrawListFor(view, proj)
+    );
+    renderOpaqueOffscreen(
+        uboGL,
+        ubo,
+        uboSize,
+        chunkOrigin,
+        in.world->lodDrawListFor(view, proj)
+    );
+} // end of renderOpaqueOffscreen()
 
+void ChunkPassGL::renderOpaqueOffscreen(
+    UBOGL& uboGL,
+    void* ubo,
+    uint32_t uboSize,
+    glm::vec3& chunkOrigin,
+    const ChunkDrawList& list
+)
+{
     for (const auto& item : list.items)
     {
+        IChunkMeshGPU* gpu = list.gpu(item);
+        if (!gpu)
+            continue;
+
         chunkOrigin = item.chunkOrigin;
         uboGL.update(ubo, uboSize);
-        item.gpu->drawOpaque({});
+        gpu->drawOpaque({}, item.opaqueSectionMask);
     }
-} // end of renderOpaque()
+} // end of renderOpaqueOffscreen()
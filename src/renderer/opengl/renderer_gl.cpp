@@ -98,6 +98,7 @@ void RendererGL::renderFrame(
 
     glEnable(GL_FRAMEBUFFER_SRGB);
 
+    in.world->setCameraMotion(in.camera->getCameraVelocity(), in.camera->getCameraFront());
     in.world->updateDynamic(in.camera->getCameraPosition());
 
     // update light/sun
@@ -117,6 +118,15 @@ void RendererGL::renderFrame(
         : 1.0f;
     const glm::mat4 proj = in.camera->getProjectionMatrix(aspect);
 
+    // cull every view of the frame in one sweep (camera, water reflection, shadow casters),
+    // the camera is also occlusion culled and the light ortho is fitted first
+    shadowMapPass_->fitLightSpace(in);
+    in.world->cullFrameViews({
+        { view, proj, ChunkCullView::Opaque | ChunkCullView::Water | ChunkCullView::Lod, true, true },
+        { in.camera->mirrored(World::WATER_HEIGHT).view, proj, ChunkCullView::Opaque | ChunkCullView::Lod },
+        { shadowMapPass_->getLightView(), shadowMapPass_->getLightProj(), ChunkCullView::Opaque }
+    });
+
 
     // ----------------- PASSES ----------------- //
     // gbuffer pass
@@ -36,6 +36,17 @@ void ShadowMapPassGL::init()
 	createTargets();
 } // end of init()
 
+bool ShadowMapPassGL::fitLightSpace(const RenderInputs& in)
+{
+	glm::vec3 minWS, maxWS;
+	lightSpaceValid_ = in.world->buildVisibleChunkBounds(minWS, maxWS);
+	if (lightSpaceValid_)
+	{
+		buildLightSpaceBounds(in, minWS, maxWS);
+	}
+	return lightSpaceValid_;
+} // end of fitLightSpace()
+
 void ShadowMapPassGL::renderOffscreen(
 	ChunkPassGL& chunk,
 	const RenderInputs& in
@@ -53,14 +64,12 @@ void ShadowMapPassGL::renderOffscreen(
 
 	glClear(GL_DEPTH_BUFFER_BIT);
 
-	// configure light space transform
-	glm::vec3 minWS, maxWS;
-	if (!in.world->buildVisibleChunkBounds(minWS, maxWS))
+	// light space transform was fitted before the frame's culling
+	if (!lightSpaceValid_)
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		return;
 	}
-	buildLightSpaceBounds(in, minWS, maxWS);
 
 	shader_->use();
 	uboData_.u_lightSpaceMatrix = lightSpaceMatrix_;
@@ -71,9 +80,7 @@ void ShadowMapPassGL::renderOffscreen(
 		&uboData_, 
 		sizeof(uboData_), 
 		uboData_.u_chunkOrigin,
-		in, 
-		lightView_, 
-		lightProj_
+		in.world->shadowDrawListFor(lightView_, lightProj_)
 	);
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -126,8 +126,7 @@ void WaterPass::renderWater(
     glBindTextureUnit(TO_API_FORM(WaterBinding::DudvTex), getDuDVTex());
     glBindTextureUnit(TO_API_FORM(WaterBinding::NormalTex), getNormalTex());
 
-    ChunkDrawList list;
-    in.world->buildWaterDrawList(view, proj, list);
+    const ChunkDrawList& list = in.world->waterDrawListFor(view, proj);
 
     shader_->use();
     waterUBO_.u_useShadowMap = rs.useShadowMap ? 1 : 0;
@@ -143,12 +142,16 @@ void WaterPass::renderWater(
 
     for (const auto& item : list.items)
     {
+        IChunkMeshGPU* gpu = list.gpu(item);
+        if (!gpu)
+            continue;
+
         glm::mat4 model = glm::translate(
             glm::mat4(1.0f),
             item.chunkOrigin);
         waterUBO_.u_model = model;
         ubo_.update(&waterUBO_, sizeof(waterUBO_));
-        item.gpu->drawWater({});
+        gpu->drawWater({});
     }
 
     glDepthMask(GL_TRUE);
@@ -302,17 +305,11 @@ void WaterPass::waterReflectionPass(
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // build reflected view matrix
-    float waterHeight = static_cast<float>(World::SEA_LEVEL) + 0.9f;
-    Camera camera = *in.camera;
-    glm::vec3 reflectedPos = camera.getCameraPosition();
-    reflectedPos.y = 2.0f * waterHeight - reflectedPos.y;
-    camera.setCameraPosition(reflectedPos);
-    camera.invertPitch();
-    glm::mat4 reflView = camera.getViewMatrix();
+    // reflected view, same mirror the frame was culled with
+    const MirroredView reflected = in.camera->mirrored(World::WATER_HEIGHT);
 
     // set clip plane (clip everything below water)
-    glm::vec4 clipPlane{ 0, 1, 0, -(waterHeight)};
+    glm::vec4 clipPlane{ 0, 1, 0, -World::WATER_HEIGHT };
     auto& opaqueShader = chunk.getOpaqueShader();
     auto& chunkOpaqueUBO = chunk.getOpaqueUBO();
     auto chunkOpaqueUBOCopy = chunkOpaqueUBO;
@@ -327,7 +324,7 @@ void WaterPass::waterReflectionPass(
         : 1.0f;
     const glm::mat4 proj = in.camera->getProjectionMatrix(aspect);
 
-    chunkOpaqueUBO.u_viewPos = camera.getCameraPosition();
+    chunkOpaqueUBO.u_viewPos = reflected.eye;
     chunkOpaqueUBO.u_lightDir = in.light->getDirection();
     chunkOpaqueUBO.u_lightColor = in.light->getLightColor();
 
@@ -336,7 +333,7 @@ void WaterPass::waterReflectionPass(
         0,
         shadowMap->getDepthTexture(),
         in,
-        reflView,
+        reflected.view,
         proj,
         shadowMap->getLightSpaceMatrix(),
         width_,
@@ -344,14 +341,14 @@ void WaterPass::waterReflectionPass(
     );
     in.skybox->render(
         nullptr, 
-        reflView, 
+        reflected.view, 
         proj,
         in.light->getDirection(),
         in.time
     );
     in.light->render(
         nullptr,
-        reflView,
+        reflected.view,
         proj
     );
 
@@ -372,8 +369,7 @@ void WaterPass::waterRefractionPass(
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // set clip plane (clip everything above water)
-    float waterHeight = static_cast<float>(World::SEA_LEVEL) + 0.9f;
-    glm::vec4 clipPlane{ 0, -1, 0, (waterHeight) };
+    glm::vec4 clipPlane{ 0, -1, 0, World::WATER_HEIGHT };
     auto& opaqueShader = chunk.getOpaqueShader();
     auto& chunkOpaqueUBO = chunk.getOpaqueUBO();
     auto chunkOpaqueUBOCopy = chunkOpaqueUBO;
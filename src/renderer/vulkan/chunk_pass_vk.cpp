@@ -5,6 +5,7 @@
 #include "graphics_pipeline_vk.h"
 
 #include "frame_context_vk.h"
+#include "utils_vk.h"
 #include "vulkan_main.h"
 #include "image_vk.h"
 
@@ -127,7 +128,9 @@ void ChunkPassVk::renderOpaque(
 	const uint32_t waterPassHeight
 )
 {
-	in.world->buildOpaqueDrawList(view, proj);
+	const ChunkDrawList& list = (renderTarget == RenderTargetVk::Shadow)
+		? in.world->shadowDrawListFor(view, proj)
+		: in.world->opaqueDrawListFor(view, proj);
 
 	vk::CommandBuffer cmd = frame.cmd;
 
@@ -169,22 +172,8 @@ void ChunkPassVk::renderOpaque(
 			0, nullptr
 		);
 
-		const ChunkDrawList& list = in.world->getOpaqueDrawList();
-		for (const auto& item : list.items)
-		{
-			ChunkPushConstants pc{};
-			pc.u_chunkOrigin = glm::vec4(item.chunkOrigin, 0.0f);
-
-			cmd.pushConstants(
-				opaquePipeline_.getLayout(),
-				vk::ShaderStageFlagBits::eVertex,
-				0,
-				sizeof(ChunkPushConstants),
-				&pc
-			);
-
-			item.gpu->drawOpaque(cmd);
-		} // end for
+		drawList(cmd, opaquePipeline_.getLayout(), list);
+		drawList(cmd, opaquePipeline_.getLayout(), in.world->lodDrawListFor(view, proj));
 
 		cmd.endDebugUtilsLabelEXT();
 	}
@@ -197,15 +186,8 @@ void ChunkPassVk::renderOpaque(
 
 		vk::DescriptorSet set = reflectionDescriptorSets_[frame.frameIndex].getSet();
 
-		// build reflected view matrix
-		const float waterHeight = static_cast<float>(World::SEA_LEVEL) + 0.9f;
-		Camera camera = *in.camera;
-		glm::vec3 reflectedPos = camera.getCameraPosition();
-		reflectedPos.y = 2.0f * waterHeight - reflectedPos.y;
-		camera.setCameraPosition(reflectedPos);
-
 		// set clip plane (clip everything below water)
-		glm::vec4 clipPlane{ 0, 1, 0, -waterHeight };
+		glm::vec4 clipPlane{ 0, 1, 0, -World::WATER_HEIGHT };
 
 		chunkUBOData_ = {};
 
@@ -220,7 +202,7 @@ void ChunkPassVk::renderOpaque(
 		chunkUBOData_.u_screenSize = glm::vec2(waterPassWidth, waterPassHeight);
 		chunkUBOData_.u_ambientStrength = in.world->getAmbientStrength();
 
-		chunkUBOData_.u_viewPos = camera.getCameraPosition();
+		chunkUBOData_.u_viewPos = in.camera->mirrored(World::WATER_HEIGHT).eye;
 
 		chunkUBOData_.u_lightDir = in.light->getDirection();
 		chunkUBOData_.u_lightColor = in.light->getLightColor();
@@ -235,22 +217,8 @@ void ChunkPassVk::renderOpaque(
 			0, nullptr
 		);
 
-		const ChunkDrawList& list = in.world->getOpaqueDrawList();
-		for (const auto& item : list.items)
-		{
-			ChunkPushConstants pc{};
-			pc.u_chunkOrigin = glm::vec4(item.chunkOrigin, 0.0f);
-
-			cmd.pushConstants(
-				opaquePipeline_.getLayout(),
-				vk::ShaderStageFlagBits::eVertex,
-				0,
-				sizeof(ChunkPushConstants),
-				&pc
-			);
-
-			item.gpu->drawOpaque(cmd);
-		} // end for
+		drawList(cmd, opaquePipeline_.getLayout(), list);
+		drawList(cmd, opaquePipeline_.getLayout(), in.world->lodDrawListFor(view, proj));
 
 		cmd.endDebugUtilsLabelEXT();
 	}
@@ -264,8 +232,7 @@ void ChunkPassVk::renderOpaque(
 		vk::DescriptorSet set = refractionDescriptorSets_[frame.frameIndex].getSet();
 
 		// set clip plane (clip everything above water)
-		float waterHeight = static_cast<float>(World::SEA_LEVEL) + 0.9f;
-		glm::vec4 clipPlane{ 0, -1, 0, waterHeight };
+		glm::vec4 clipPlane{ 0, -1, 0, World::WATER_HEIGHT };
 
 		chunkUBOData_ = {};
 
@@ -295,22 +262,8 @@ void ChunkPassVk::renderOpaque(
 			0, nullptr
 		);
 
-		const ChunkDrawList& list = in.world->getOpaqueDrawList();
-		for (const auto& item : list.items)
-		{
-			ChunkPushConstants pc{};
-			pc.u_chunkOrigin = glm::vec4(item.chunkOrigin, 0.0f);
-
-			cmd.pushConstants(
-				opaquePipeline_.getLayout(),
-				vk::ShaderStageFlagBits::eVertex,
-				0,
-				sizeof(ChunkPushConstants),
-				&pc
-			);
-
-			item.gpu->drawOpaque(cmd);
-		} // end for
+		drawList(cmd, opaquePipeline_.getLayout(), list);
+		drawList(cmd, opaquePipeline_.getLayout(), in.world->lodDrawListFor(view, proj));
 
 		cmd.endDebugUtilsLabelEXT();
 	}
@@ -338,22 +291,8 @@ void ChunkPassVk::renderOpaque(
 			0, nullptr
 		);
 
-		const ChunkDrawList& list = in.world->getOpaqueDrawList();
-		for (const auto& item : list.items)
-		{
-			ChunkPushConstants pc{};
-			pc.u_chunkOrigin = glm::vec4(item.chunkOrigin, 0.0f);
-
-			cmd.pushConstants(
-				opaqueGBufferPipeline_.getLayout(),
-				vk::ShaderStageFlagBits::eVertex,
-				0,
-				sizeof(ChunkPushConstants),
-				&pc
-			);
-
-			item.gpu->drawOpaque(cmd);
-		} // end for
+		drawList(cmd, opaqueGBufferPipeline_.getLayout(), list);
+		drawList(cmd, opaqueGBufferPipeline_.getLayout(), in.world->lodDrawListFor(view, proj));
 
 		cmd.endDebugUtilsLabelEXT();
 	}
@@ -380,22 +319,7 @@ void ChunkPassVk::renderOpaque(
 			0, nullptr
 		);
 
-		const ChunkDrawList& list = in.world->getOpaqueDrawList();
-		for (const auto& item : list.items)
-		{
-			ChunkPushConstants pc{};
-			pc.u_chunkOrigin = glm::vec4(item.chunkOrigin, 0.0f);
-
-			cmd.pushConstants(
-				opaqueShadowPipeline_.getLayout(),
-				vk::ShaderStageFlagBits::eVertex,
-				0,
-				sizeof(ChunkPushConstants),
-				&pc
-			);
-
-			item.gpu->drawOpaque(cmd);
-		} // end for
+		drawList(cmd, opaqueShadowPipeline_.getLayout(), list);
 
 		cmd.endDebugUtilsLabelEXT();
 	}
@@ -403,6 +327,29 @@ void ChunkPassVk::renderOpaque(
 
 
 //--- PRIVATE ---//
+void ChunkPassVk::drawList(vk::CommandBuffer cmd, vk::PipelineLayout layout, const ChunkDrawList& list) const
+{
+	for (const auto& item : list.items)
+	{
+		IChunkMeshGPU* gpu = list.gpu(item);
+		if (!gpu)
+			continue;
+
+		ChunkPushConstants pc{};
+		pc.u_chunkOrigin = glm::vec4(item.chunkOrigin, 0.0f);
+
+		cmd.pushConstants(
+			layout,
+			vk::ShaderStageFlagBits::eVertex,
+			0,
+			sizeof(ChunkPushConstants),
+			&pc
+		);
+
+		gpu->drawOpaque(VkUtils::ToCommandContext(cmd), item.opaqueSectionMask);
+	} // end for
+} // end of drawList()
+
 void ChunkPassVk::refreshTexBinding()
 {
 	for (uint32_t i = 0; i < vk_.getMaxFramesInFlight(); ++i)
@@ -143,10 +143,11 @@ void RayTracingWorldVk::buildOpaqueRTInstancesFromDrawList(
 
 	for (const auto& item : opaqueDrawList.items)
 	{
-		if (!item.gpu)
+		IChunkMeshGPU* gpu = opaqueDrawList.gpu(item);
+		if (!gpu)
 			continue;
 
-		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(item.gpu.get());
+		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(gpu);
 		if (!chunkGpuVk)
 			continue;
 
@@ -195,10 +196,11 @@ void RayTracingWorldVk::buildWaterRTInstancesFromDrawList(
 
 	for (const auto& item : waterDrawList.items)
 	{
-		if (!item.gpu)
+		IChunkMeshGPU* gpu = waterDrawList.gpu(item);
+		if (!gpu)
 			continue;
 
-		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(item.gpu.get());
+		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(gpu);
 		if (!chunkGpuVk)
 			continue;
 
@@ -247,10 +249,11 @@ void RayTracingWorldVk::buildPackedOpaqueRTSceneFromDrawList(
 
 	for (const auto& item : opaqueDrawList.items)
 	{
-		if (!item.gpu)
+		IChunkMeshGPU* gpu = opaqueDrawList.gpu(item);
+		if (!gpu)
 			continue;
 
-		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(item.gpu.get());
+		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(gpu);
 		if (!chunkGpuVk)
 			continue;
 
@@ -283,10 +286,11 @@ void RayTracingWorldVk::buildPackedWaterRTSceneFromDrawList(
 
 	for (const auto& item : waterDrawList.items)
 	{
-		if (!item.gpu)
+		IChunkMeshGPU* gpu = waterDrawList.gpu(item);
+		if (!gpu)
 			continue;
 
-		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(item.gpu.get());
+		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(gpu);
 		if (!chunkGpuVk)
 			continue;
 
@@ -465,10 +469,11 @@ void RayTracingWorldVk::buildRTSceneKeys(
 
 	for (const auto& item : rtDrawList.items)
 	{
-		if (!item.gpu)
+		IChunkMeshGPU* gpu = rtDrawList.gpu(item);
+		if (!gpu)
 			continue;
 
-		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(item.gpu.get());
+		auto* chunkGpuVk = dynamic_cast<ChunkMeshGPUVk*>(gpu);
 		if (!chunkGpuVk)
 			continue;
 
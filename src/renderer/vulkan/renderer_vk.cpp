@@ -38,6 +38,8 @@
 
 #include <glm/glm.hpp>
 
+#include <vector>
+
 //--- PUBLIC ---//
 RendererVk::RendererVk(VulkanMain& vk)
 	: vk_(vk),
@@ -243,7 +245,27 @@ void RendererVk::renderFrame(
 	);
 
 	// update world state
-	in.world->updateDynamic(in.camera->getCameraPosition(), &frame);
+	in.world->setCameraMotion(in.camera->getCameraVelocity(), in.camera->getCameraFront());
+	in.world->updateDynamic(in.camera->getCameraPosition(), VkUtils::ToCommandContext(cmd));
+
+	// cull the camera (frustum + occlusion), the water reflection and the
+	// shadow casters in one sweep, the light ortho is fitted first
+	uint32_t cameraLists = ChunkCullView::Opaque | ChunkCullView::Water | ChunkCullView::Lod;
+	if (renderSettings_->useRT)
+	{
+		cameraLists |= ChunkCullView::Combined;
+	}
+	std::vector<ChunkCullView> cullViews = { { view, proj, cameraLists, true, true } };
+	if (!renderSettings_->useRT && waterPass_)
+	{
+		cullViews.push_back({ in.camera->mirrored(World::WATER_HEIGHT).view, waterPass_->reflectionProj(*in.camera), ChunkCullView::Opaque | ChunkCullView::Lod });
+	}
+	if (shadowMapPass_ && shadowMapPass_->fitLightSpace(in))
+	{
+		cullViews.push_back({ shadowMapPass_->getLightView(), shadowMapPass_->getLightProj(), ChunkCullView::Opaque });
+	}
+	in.world->cullFrameViews(cullViews);
+
 	if (renderSettings_->useRT)
 	{
 		in.world->buildRTDrawList(view, proj);
@@ -29,6 +29,17 @@ void ShadowMapPassVk::init()
 	createAttachments();
 } // end of init()
 
+bool ShadowMapPassVk::fitLightSpace(const RenderInputs& in)
+{
+	glm::vec3 minWS, maxWS;
+	lightSpaceValid_ = in.world->buildVisibleChunkBounds(minWS, maxWS);
+	if (lightSpaceValid_)
+	{
+		buildLightSpaceBounds(in, minWS, maxWS);
+	}
+	return lightSpaceValid_;
+} // end of fitLightSpace()
+
 void ShadowMapPassVk::render(
 	ChunkPassVk& chunk,
 	const RenderInputs& in,
@@ -71,9 +82,8 @@ void ShadowMapPassVk::render(
 		scissor.extent = extent;
 		cmd.setScissor(0, 1, &scissor);
 
-		// configure light space transform
-		glm::vec3 minWS, maxWS;
-		if (!in.world->buildVisibleChunkBounds(minWS, maxWS))
+		// light space transform was fitted before the frame's culling
+		if (!lightSpaceValid_)
 		{
 			cmd.endRendering();
 
@@ -81,7 +91,6 @@ void ShadowMapPassVk::render(
 
 			return;
 		}
-		buildLightSpaceBounds(in, minWS, maxWS);
 
 		chunk.renderOpaque(
 			RenderTargetVk::Shadow,
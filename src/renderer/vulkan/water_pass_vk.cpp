@@ -2,6 +2,7 @@
 
 #include "render_settings.h"
 #include "frame_context_vk.h"
+#include "utils_vk.h"
 #include "constants.h"
 #include "render_inputs.h"
 #include "bindings.h"
@@ -88,6 +89,14 @@ void WaterPassVk::resize()
 	createDescriptorSet();
 } // end of resize()
 
+glm::mat4 WaterPassVk::reflectionProj(const Camera& camera) const
+{
+	const float aspect = (height_ > 0)
+		? (static_cast<float>(width_) / static_cast<float>(height_))
+		: 1.0f;
+	return camera.getProjectionMatrixVk(aspect);
+} // end of reflectionProj()
+
 void WaterPassVk::renderOffscreen(
 	const RenderSettings& rs,
 	const FrameContext& frame,
@@ -118,8 +127,7 @@ void WaterPassVk::renderWater(
 	int width, int height
 )
 {
-	ChunkDrawList list;
-	in.world->buildWaterDrawList(view, proj, list);
+	const ChunkDrawList& list = in.world->waterDrawListFor(view, proj);
 
 	vk::CommandBuffer cmd = frame.cmd;
 
@@ -157,6 +165,10 @@ void WaterPassVk::renderWater(
 
 	for (const auto& item : list.items)
 	{
+		IChunkMeshGPU* gpu = list.gpu(item);
+		if (!gpu)
+			continue;
+
 		glm::mat4 model = glm::translate(
 			glm::mat4(1.0f),
 			item.chunkOrigin);
@@ -172,7 +184,7 @@ void WaterPassVk::renderWater(
 			&pc
 		);
 
-		item.gpu->drawWater(cmd);
+		gpu->drawWater(VkUtils::ToCommandContext(cmd));
 	} // end for
 
 	cmd.endDebugUtilsLabelEXT();
@@ -603,20 +615,9 @@ void WaterPassVk::waterReflectionPass(
 		};
 		cmd.setScissor(0, 1, &scissor);
 
-		// build reflected view matrix
-		const float waterHeight = static_cast<float>(World::SEA_LEVEL) + 0.9f;
-		Camera camera = *in.camera;
-		glm::vec3 reflectedPos = camera.getCameraPosition();
-		reflectedPos.y = 2.0f * waterHeight - reflectedPos.y;
-		camera.setCameraPosition(reflectedPos);
-		camera.invertPitch();
-
-		const glm::mat4 reflView = camera.getViewMatrix();
-
-		const float aspect = (height_ > 0)
-			? (static_cast<float>(width_) / static_cast<float>(height_))
-			: 1.0f;
-		glm::mat4 proj = camera.getProjectionMatrixVk(aspect);
+		// reflected view, culled with the frame's other views
+		const glm::mat4 reflView = in.camera->mirrored(World::WATER_HEIGHT).view;
+		const glm::mat4 proj = reflectionProj(*in.camera);
 
 		// render world
 		chunk.renderOpaque(
@@ -0,0 +1,277 @@
+#include "chunk_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace World;
+
+//--- HELPER ---//
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr int HASH_BITS = 12;
+
+static inline uint32_t Read32(const uint8_t* p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+} // end of Read32()
+
+static inline uint32_t HashSequence(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - HASH_BITS);
+} // end of HashSequence()
+
+static void WriteLength(std::vector<uint8_t>& out, size_t len)
+{
+	while (len >= 255)
+	{
+		out.push_back(255);
+		len -= 255;
+	} // end while
+	out.push_back(static_cast<uint8_t>(len));
+} // end of WriteLength()
+
+static bool ReadLength(const uint8_t*& p, const uint8_t* end, size_t& len)
+{
+	uint8_t b = 255;
+	while (b == 255)
+	{
+		if (p >= end) return false;
+		b = *p++;
+		len += b;
+	} // end while
+	return true;
+} // end of ReadLength()
+
+static void EmitSequence(
+	std::vector<uint8_t>& out,
+	const uint8_t* literals, size_t literalLen,
+	size_t offset, size_t matchLen)
+{
+	// token: high nibble literal length, low nibble match length - MIN_MATCH
+	size_t matchCode = (matchLen > 0) ? matchLen - MIN_MATCH : 0;
+
+	uint8_t token = static_cast<uint8_t>(
+		((literalLen >= 15 ? 15 : literalLen) << 4) |
+		(matchCode >= 15 ? 15 : matchCode)
+	);
+	out.push_back(token);
+
+	if (literalLen >= 15)
+	{
+		WriteLength(out, literalLen - 15);
+	}
+
+	out.insert(out.end(), literals, literals + literalLen);
+
+	// last sequence has literals only
+	if (matchLen == 0)
+	{
+		return;
+	}
+
+	out.push_back(static_cast<uint8_t>(offset & 0xFF));
+	out.push_back(static_cast<uint8_t>(offset >> 8));
+
+	if (matchCode >= 15)
+	{
+		WriteLength(out, matchCode - 15);
+	}
+} // end of EmitSequence()
+
+static inline void WriteVarint(std::vector<uint8_t>& out, uint32_t v)
+{
+	while (v >= 0x80)
+	{
+		out.push_back(static_cast<uint8_t>(v | 0x80));
+		v >>= 7;
+	} // end while
+	out.push_back(static_cast<uint8_t>(v));
+} // end of WriteVarint()
+
+static inline bool ReadVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v)
+{
+	v = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		if (p >= end) return false;
+		uint8_t b = *p++;
+		v |= static_cast<uint32_t>(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) return true;
+	} // end for
+	return false;
+} // end of ReadVarint()
+
+
+//--- PUBLIC ---//
+void ChunkCodec::encode(const BlockID* blocks, size_t count, std::vector<uint8_t>& out)
+{
+	// stage 1: RLE as (block, varint run length) pairs
+	std::vector<uint8_t> rle;
+	rle.reserve(1024);
+
+	size_t i = 0;
+	while (i < count)
+	{
+		BlockID id = blocks[i];
+		size_t run = 1;
+		while (i + run < count && blocks[i + run] == id)
+		{
+			++run;
+		} // end while
+
+		rle.push_back(static_cast<uint8_t>(id));
+		WriteVarint(rle, static_cast<uint32_t>(run));
+		i += run;
+	} // end while
+
+	// stage 2: LZ, prefixed with the RLE size
+	out.clear();
+	uint32_t rleSize = static_cast<uint32_t>(rle.size());
+	out.resize(sizeof(rleSize));
+	std::memcpy(out.data(), &rleSize, sizeof(rleSize));
+
+	std::vector<uint8_t> lz;
+	compressLZ(rle.data(), rle.size(), lz);
+	out.insert(out.end(), lz.begin(), lz.end());
+} // end of encode()
+
+bool ChunkCodec::decode(const uint8_t* data, size_t size, BlockID* blocks, size_t count)
+{
+	uint32_t rleSize = 0;
+	if (size < sizeof(rleSize))
+	{
+		return false;
+	}
+	std::memcpy(&rleSize, data, sizeof(rleSize));
+
+	std::vector<uint8_t> rle;
+	if (!decompressLZ(data + sizeof(rleSize), size - sizeof(rleSize), rle, rleSize))
+	{
+		return false;
+	}
+
+	const uint8_t* p = rle.data();
+	const uint8_t* end = p + rle.size();
+
+	size_t written = 0;
+	while (p < end)
+	{
+		BlockID id = static_cast<BlockID>(*p++);
+
+		uint32_t run = 0;
+		if (!ReadVarint(p, end, run) || run > count - written)
+		{
+			return false;
+		}
+
+		std::memset(blocks + written, static_cast<int>(id), run);
+		written += run;
+	} // end while
+
+	return written == count;
+} // end of decode()
+
+void ChunkCodec::compressLZ(const uint8_t* in, size_t size, std::vector<uint8_t>& out)
+{
+	out.clear();
+	out.reserve(size / 2 + 16);
+
+	int32_t table[1 << HASH_BITS];
+	std::fill(std::begin(table), std::end(table), -1);
+
+	size_t anchor = 0;
+	size_t i = 0;
+
+	while (i + MIN_MATCH <= size)
+	{
+		uint32_t seq = Read32(in + i);
+		uint32_t h = HashSequence(seq);
+		int32_t ref = table[h];
+		table[h] = static_cast<int32_t>(i);
+
+		if (ref < 0 ||
+			i - static_cast<size_t>(ref) > MAX_OFFSET ||
+			Read32(in + ref) != seq)
+		{
+			++i;
+			continue;
+		}
+
+		size_t len = MIN_MATCH;
+		while (i + len < size && in[ref + len] == in[i + len])
+		{
+			++len;
+		} // end while
+
+		EmitSequence(out, in + anchor, i - anchor, i - static_cast<size_t>(ref), len);
+
+		i += len;
+		anchor = i;
+	} // end while
+
+	EmitSequence(out, in + anchor, size - anchor, 0, 0);
+} // end of compressLZ()
+
+bool ChunkCodec::decompressLZ(const uint8_t* in, size_t size, std::vector<uint8_t>& out, size_t rawSize)
+{
+	out.clear();
+	out.reserve(rawSize);
+
+	const uint8_t* p = in;
+	const uint8_t* end = in + size;
+
+	while (p < end)
+	{
+		uint8_t token = *p++;
+
+		size_t literalLen = token >> 4;
+		if (literalLen == 15 && !ReadLength(p, end, literalLen))
+		{
+			return false;
+		}
+
+		if (literalLen > static_cast<size_t>(end - p) || out.size() + literalLen > rawSize)
+		{
+			return false;
+		}
+		out.insert(out.end(), p, p + literalLen);
+		p += literalLen;
+
+		// last sequence
+		if (p >= end)
+		{
+			break;
+		}
+
+		if (end - p < 2)
+		{
+			return false;
+		}
+		size_t offset = static_cast<size_t>(p[0]) | (static_cast<size_t>(p[1]) << 8);
+		p += 2;
+
+		size_t matchLen = token & 0x0F;
+		if (matchLen == 15 && !ReadLength(p, end, matchLen))
+		{
+			return false;
+		}
+		matchLen += MIN_MATCH;
+
+		if (offset == 0 || offset > out.size() || out.size() + matchLen > rawSize)
+		{
+			return false;
+		}
+
+		// byte copy, match may overlap its own output
+		size_t from = out.size() - offset;
+		for (size_t k = 0; k < matchLen; ++k)
+		{
+			out.push_back(out[from + k]);
+		} // end for
+	} // end while
+
+	return out.size() == rawSize;
+} // end of decompressLZ()
@@ -0,0 +1,181 @@
+#include "region_file.h"
+
+#include "chunk_grid.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace Region_Constants;
+
+//--- PUBLIC ---//
+RegionCoord RegionFile::regionOf(int cx, int cz)
+{
+	return { FloorDiv(cx, REGION_SIZE), FloorDiv(cz, REGION_SIZE) };
+} // end of regionOf()
+
+int RegionFile::localIndex(int cx, int cz)
+{
+	RegionCoord rc = regionOf(cx, cz);
+	int lx = cx - rc.x * REGION_SIZE;
+	int lz = cz - rc.z * REGION_SIZE;
+	return lx + REGION_SIZE * lz;
+} // end of localIndex()
+
+std::filesystem::path RegionFile::pathFor(const std::filesystem::path& worldDir, const RegionCoord& rc)
+{
+	return worldDir / ("region_" +
+		std::to_string(rc.x) + "_" +
+		std::to_string(rc.z) + ".reg");
+} // end of pathFor()
+
+RegionFile::ReadResult RegionFile::read(const std::filesystem::path& path)
+{
+	for (auto& chunk : chunks_)
+	{
+		chunk.clear();
+	} // end for
+
+	std::error_code ec;
+	if (!std::filesystem::exists(path, ec) && !ec)
+	{
+		return ReadResult::Missing;
+	}
+
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in)
+	{
+		std::cerr << "Failed to open region file at path: " << path << "\n";
+		return ReadResult::Unreadable;
+	}
+
+	// single read for the whole region
+	std::streamsize size = in.tellg();
+	in.seekg(0, std::ios::beg);
+
+	std::vector<uint8_t> bytes(static_cast<size_t>(size));
+	if (size > 0 && !in.read(reinterpret_cast<char*>(bytes.data()), size))
+	{
+		std::cerr << "Failed to read region file at path: " << path << "\n";
+		return ReadResult::Unreadable;
+	}
+
+	const size_t indexBytes = sizeof(RegionChunkSlot) * REGION_CHUNKS;
+	if (bytes.size() < sizeof(RegionFileHeader) + indexBytes)
+	{
+		std::cerr << "Truncated region file at path: " << path << "\n";
+		return ReadResult::Unreadable;
+	}
+
+	RegionFileHeader header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (header.magic != REGION_MAGIC ||
+		header.version != REGION_VERSION ||
+		header.regionSize != REGION_SIZE)
+	{
+		std::cerr << "Invalid region file header at path: " << path << "\n";
+		return ReadResult::Unreadable;
+	}
+
+	std::array<RegionChunkSlot, REGION_CHUNKS> slots;
+	std::memcpy(slots.data(), bytes.data() + sizeof(header), indexBytes);
+
+	for (int i = 0; i < REGION_CHUNKS; ++i)
+	{
+		const RegionChunkSlot& slot = slots[i];
+		if (slot.length == 0)
+		{
+			continue;
+		}
+
+		// a slot past the end means the file lost data, rewriting it would
+		// drop the chunk for good
+		if (static_cast<size_t>(slot.offset) + slot.length > bytes.size())
+		{
+			std::cerr << "Corrupt chunk slot " << i << " in region file: " << path << "\n";
+			for (auto& chunk : chunks_)
+			{
+				chunk.clear();
+			} // end for
+			return ReadResult::Unreadable;
+		}
+
+		chunks_[i].assign(
+			bytes.begin() + slot.offset,
+			bytes.begin() + slot.offset + slot.length
+		);
+	} // end for
+
+	return ReadResult::Ok;
+} // end of read()
+
+bool RegionFile::write(const std::filesystem::path& path, const RegionCoord& rc) const
+{
+	RegionFileHeader header;
+	header.regionX = rc.x;
+	header.regionZ = rc.z;
+
+	// lay payloads out back to back after the index
+	std::array<RegionChunkSlot, REGION_CHUNKS> slots{};
+	uint32_t offset = static_cast<uint32_t>(sizeof(header) + sizeof(slots));
+
+	for (int i = 0; i < REGION_CHUNKS; ++i)
+	{
+		slots[i].offset = chunks_[i].empty() ? 0 : offset;
+		slots[i].length = static_cast<uint32_t>(chunks_[i].size());
+		offset += slots[i].length;
+	} // end for
+
+	// write next to the target and rename over it, a crash mid-write
+	// leaves the previous region intact
+	std::filesystem::path tmpPath = path;
+	tmpPath += ".tmp";
+
+	std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		std::cerr << "Failed to open region file (w) at path: " << tmpPath << "\n";
+		return false;
+	}
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(slots.data()), sizeof(slots));
+
+	for (const auto& chunk : chunks_)
+	{
+		if (!chunk.empty())
+		{
+			out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+		}
+	} // end for
+
+	out.close();
+	if (!out)
+	{
+		std::cerr << "Failed to write region file at path: " << tmpPath << "\n";
+		std::filesystem::remove(tmpPath);
+		return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmpPath, path, ec);
+	if (ec)
+	{
+		std::cerr << "Failed to replace region file at path: " << path << " (" << ec.message() << ")\n";
+		std::filesystem::remove(tmpPath, ec);
+		return false;
+	}
+
+	return true;
+} // end of write()
+
+size_t RegionFile::payloadBytes() const
+{
+	size_t total = 0;
+	for (const auto& chunk : chunks_)
+	{
+		total += chunk.size();
+	} // end for
+	return total;
+} // end of payloadBytes()
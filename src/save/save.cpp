@@ -1,12 +1,19 @@
 #include "save.h"
 
+#include "chunk_codec.h"
 #include "chunk_data.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <cstdint>
+#include <string>
+#include <unordered_map>
 
+using namespace Region_Constants;
+
+// legacy per-chunk file format (chunk_X_Z.bin), only read for migration
 struct ChunkFileHeader
 {
 	int32_t version = 1;
@@ -17,75 +24,655 @@ struct ChunkFileHeader
 	int32_t sizeZ = CHUNK_SIZE;
 };
 
+//--- HELPER ---//
+static std::filesystem::path WorldDir(const std::string_view& worldPath)
+{
+	return std::filesystem::path(SAVE_PATH) / worldPath;
+} // end of WorldDir()
+
+static bool WriteRegion(const std::filesystem::path& path, const RegionCoord& rc, const RegionFile& region)
+{
+	if (!region.write(path, rc))
+	{
+		return false;
+	}
+
+	#ifdef _DEBUG
+	std::cout << "Saved region to: " << path << "\n";
+	#endif
+
+	return true;
+} // end of WriteRegion()
+
+static int64_t RegionKey(const RegionCoord& rc)
+{
+	return (static_cast<int64_t>(rc.x) << 32) ^ static_cast<uint32_t>(rc.z);
+} // end of RegionKey()
+
+static bool DecodeChunk(const std::vector<uint8_t>& payload, ChunkData& dst)
+{
+	std::vector<BlockID> blocks(CHUNK_VOLUME);
+	if (!ChunkCodec::decode(payload.data(), payload.size(), blocks.data(), blocks.size()))
+	{
+		std::cerr << "Corrupt chunk data for chunk: " << dst.m_chunkX << ", " << dst.m_chunkZ << "\n";
+		return false;
+	}
+
+	dst.loadData(blocks.data());
+	dst.m_dirty = false;
+	return true;
+} // end of DecodeChunk()
+
+
 //--- PUBLIC ---//
-Save::~Save() = default;
+Save::~Save()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+		stop_ = true;
+	}
+	queueCv_.notify_all();
+
+	// save thread drains the queue before exiting
+	if (saveThread_.joinable())
+	{
+		saveThread_.join();
+	}
+
+	// last try for regions whose write failed
+	std::lock_guard<std::mutex> writeLock(writeMutex_);
+	if (!writeDirtyRegions())
+	{
+		std::cerr << "Unsaved chunks lost, region files could not be written\n";
+	}
+} // end of destructor
+
+void Save::queueChunkSave(const ChunkData& chunk, const std::string_view& worldPath)
+{
+	// copy taken on the caller's thread, the chunk can keep changing
+	auto snapshot = std::make_shared<BlockArray>();
+	chunk.copyBlocks(snapshot->data());
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		// repeated edits to the same chunk collapse into the latest copy
+		queued_[{ std::string(worldPath), chunk.m_chunkX, chunk.m_chunkZ }] = std::move(snapshot);
+
+		if (!saveThread_.joinable())
+		{
+			saveThread_ = std::thread(&Save::saveThreadLoop, this);
+		}
+	}
+	queueCv_.notify_one();
+} // end of queueChunkSave()
+
+bool Save::flush()
+{
+	{
+		std::unique_lock<std::mutex> lock(queueMutex_);
+		idleCv_.wait(lock, [this]()
+			{
+				return queued_.empty() && writing_.empty();
+			});
+	}
+
+	// regions a failed write left behind get another try
+	std::lock_guard<std::mutex> writeLock(writeMutex_);
+	return writeDirtyRegions();
+} // end of flush()
 
-void Save::saveChunkToFile(const ChunkData& chunk, const std::string_view& worldPath)
+size_t Save::queuedChunkCount() const
 {
-	// full world dir path
-	std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / worldPath;
+	std::lock_guard<std::mutex> lock(queueMutex_);
+	return queued_.size() + writing_.size();
+} // end of queuedChunkCount()
 
-	if (!std::filesystem::exists(worldDir))
+bool Save::saveChunkToFile(const ChunkData& chunk, const std::string_view& worldPath)
+{
+	return saveChunksToFile({ &chunk }, worldPath);
+} // end of saveChunkToFile()
+
+bool Save::loadChunkFromFile(ChunkData& dst, int cx, int cz, const std::string_view& worldPath)
+{
+	// not yet written by the save thread
 	{
-		std::filesystem::create_directories(worldDir);
+		auto queued = std::make_unique<BlockArray>();
+		if (findQueuedSnapshot(worldPath, cx, cz, *queued))
+		{
+			dst.loadData(queued->data());
+			dst.m_dirty = false;
+			return true;
+		}
+	}
 
-		#ifdef _DEBUG
-		std::cout << "Created directory: " << worldDir << "\n";
-		#endif
+	std::filesystem::path worldDir = WorldDir(worldPath);
+	RegionCoord rc = RegionFile::regionOf(cx, cz);
+	int index = RegionFile::localIndex(cx, cz);
+
+	// copy the compressed payload out, decode without holding the lock
+	std::vector<uint8_t> payload;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::shared_ptr<RegionFile> region = acquireRegionLocked(worldDir, rc);
+		if (!region || !region->has(index))
+		{
+			return false;
+		}
+		payload = region->payload(index);
 	}
 
-	std::filesystem::path chunkPath = 
-		worldDir / ("chunk_" +
-			std::to_string(chunk.m_chunkX) + "_" +
-			std::to_string(chunk.m_chunkZ) + ".bin");
+	return DecodeChunk(payload, dst);
+} // end of loadChunkFromFile()
+
+void Save::prefetchRegion(int cx, int cz, const std::string_view& worldPath)
+{
+	const std::filesystem::path path = RegionFile::pathFor(WorldDir(worldPath), RegionFile::regionOf(cx, cz));
+	uint64_t writes;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (findCachedLocked(path))
+		{
+			return;
+		}
+		writes = regionWrites_;
+	}
 
-	std::ofstream out(chunkPath, std::ios::binary);
-	if (!out)
+	// missing regions are cached empty, unreadable ones are left to
+	// acquireRegionLocked()
+	auto region = std::make_shared<RegionFile>();
+	if (region->read(path) == RegionFile::ReadResult::Unreadable)
 	{
-		std::cerr << "Failed to open chunk file (w) at path: " << chunkPath << "\n";
 		return;
 	}
 
-	ChunkFileHeader header;
-	header.cx = chunk.m_chunkX;
-	header.cz = chunk.m_chunkZ;
+	// a region written meanwhile may be newer than this read, the next
+	// chunk load reads it again
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (writes == regionWrites_ && !findCachedLocked(path))
+	{
+		insertCachedLocked(path, RegionFile::regionOf(cx, cz), region);
+	}
+} // end of prefetchRegion()
+
+bool Save::saveChunksToFile(const std::vector<const ChunkData*>& chunks, const std::string_view& worldPath)
+{
+	if (chunks.empty())
+	{
+		return true;
+	}
 
-	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
-	out.write(reinterpret_cast<const char*>(chunk.getBlocks().data()), chunk.getBlocks().size() * sizeof(BlockID));
+	// chunks are stored palettized, the codec works on dense blocks
+	std::vector<BlockID> dense(chunks.size() * CHUNK_VOLUME);
+	std::vector<std::tuple<int, int, const BlockID*>> entries;
+	entries.reserve(chunks.size());
+
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		BlockID* blocks = dense.data() + i * CHUNK_VOLUME;
+		chunks[i]->copyBlocks(blocks);
+		entries.emplace_back(chunks[i]->m_chunkX, chunks[i]->m_chunkZ, blocks);
+	} // end for
+
+	{
+		// an older queued copy must not overwrite this one later, and one
+		// the save thread is already writing has to land first
+		std::unique_lock<std::mutex> lock(queueMutex_);
+		for (const ChunkData* chunk : chunks)
+		{
+			queued_.erase({ std::string(worldPath), chunk->m_chunkX, chunk->m_chunkZ });
+		} // end for
+
+		idleCv_.wait(lock, [&]()
+			{
+				for (const ChunkData* chunk : chunks)
+				{
+					if (writing_.count({ std::string(worldPath), chunk->m_chunkX, chunk->m_chunkZ }) != 0)
+					{
+						return false;
+					}
+				} // end for
+				return true;
+			});
+	}
+
+	return writeChunks(entries, worldPath);
+} // end of saveChunksToFile()
+
+std::vector<bool> Save::loadChunksFromFile(const std::vector<ChunkData*>& dsts, const std::string_view& worldPath)
+{
+	std::filesystem::path worldDir = WorldDir(worldPath);
+
+	std::vector<std::vector<uint8_t>> payloads(dsts.size());
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// consecutive chunks usually share a region, reuse the lookup
+		std::shared_ptr<RegionFile> region;
+		RegionCoord current{};
+
+		for (size_t i = 0; i < dsts.size(); ++i)
+		{
+			RegionCoord rc = RegionFile::regionOf(dsts[i]->m_chunkX, dsts[i]->m_chunkZ);
+			if (!region || !(rc == current))
+			{
+				region = acquireRegionLocked(worldDir, rc);
+				current = rc;
+			}
+
+			int index = RegionFile::localIndex(dsts[i]->m_chunkX, dsts[i]->m_chunkZ);
+			if (region && region->has(index))
+			{
+				payloads[i] = region->payload(index);
+			}
+		} // end for
+	}
+
+	std::vector<bool> loaded(dsts.size(), false);
+	auto queued = std::make_unique<BlockArray>();
+
+	for (size_t i = 0; i < dsts.size(); ++i)
+	{
+		if (findQueuedSnapshot(worldPath, dsts[i]->m_chunkX, dsts[i]->m_chunkZ, *queued))
+		{
+			dsts[i]->loadData(queued->data());
+			dsts[i]->m_dirty = false;
+			loaded[i] = true;
+		}
+		else if (!payloads[i].empty())
+		{
+			loaded[i] = DecodeChunk(payloads[i], *dsts[i]);
+		}
+	} // end for
+
+	return loaded;
+} // end of loadChunksFromFile()
+
+int Save::migrateLegacyWorld(const std::string_view& worldPath)
+{
+	std::filesystem::path worldDir = WorldDir(worldPath);
+
+	std::error_code ec;
+	if (!std::filesystem::is_directory(worldDir, ec))
+	{
+		return 0;
+	}
+
+	std::vector<std::filesystem::path> legacyFiles;
+	for (const auto& entry : std::filesystem::directory_iterator(worldDir, ec))
+	{
+		const std::string name = entry.path().filename().string();
+		if (entry.is_regular_file() &&
+			name.rfind("chunk_", 0) == 0 &&
+			entry.path().extension() == ".bin")
+		{
+			legacyFiles.push_back(entry.path());
+		}
+	} // end for
+
+	if (legacyFiles.empty())
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> writeLock(writeMutex_);
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::unordered_map<int64_t, std::pair<RegionCoord, std::shared_ptr<RegionFile>>> touched;
+	std::vector<std::filesystem::path> migrated;
+	std::vector<BlockID> blocks(CHUNK_VOLUME);
+
+	for (const auto& path : legacyFiles)
+	{
+		std::ifstream in(path, std::ios::binary);
+
+		ChunkFileHeader header{};
+		in.read(reinterpret_cast<char*>(&header), sizeof(header));
+		in.read(reinterpret_cast<char*>(blocks.data()), blocks.size() * sizeof(BlockID));
+
+		if (!in ||
+			header.version != 1 ||
+			header.sizeX != CHUNK_SIZE ||
+			header.sizeY != CHUNK_SIZE_Y ||
+			header.sizeZ != CHUNK_SIZE)
+		{
+			std::cerr << "Skipping invalid legacy chunk file: " << path << "\n";
+			continue;
+		}
+
+		RegionCoord rc = RegionFile::regionOf(header.cx, header.cz);
+		std::shared_ptr<RegionFile> region = acquireRegionLocked(worldDir, rc);
+		if (!region)
+		{
+			// legacy file is kept, the next launch tries again
+			continue;
+		}
+
+		std::vector<uint8_t> payload;
+		ChunkCodec::encode(blocks.data(), blocks.size(), payload);
+		region->setPayload(RegionFile::localIndex(header.cx, header.cz), std::move(payload));
+
+		touched[RegionKey(rc)] = { rc, region };
+		migrated.push_back(path);
+	} // end for
+
+	bool ok = true;
+	for (const auto& [key, entry] : touched)
+	{
+		++regionWrites_;
+		ok = WriteRegion(RegionFile::pathFor(worldDir, entry.first), entry.first, *entry.second) && ok;
+	} // end for
+
+	// only drop the old files once every region made it to disk
+	if (ok)
+	{
+		for (const auto& path : migrated)
+		{
+			std::filesystem::remove(path, ec);
+		} // end for
+	}
 
 	#ifdef _DEBUG
-	std::cout << "Saved chunk to: " << chunkPath << "\n";
+	std::cout << "Migrated " << migrated.size() << " legacy chunk files in " << worldDir << "\n";
 	#endif
-} // end of saveChunkToFile()
 
-bool Save::loadChunkFromFile(ChunkData& dst, int cx, int cz, const std::string_view& worldPath)
+	return static_cast<int>(migrated.size());
+} // end of migrateLegacyWorld()
+
+int Save::removeWorldsExcept(const std::string_view& parentPath, const std::string_view& keepName)
 {
-	// full world dir path
-	std::filesystem::path worldDir = std::filesystem::path(SAVE_PATH) / worldPath;
+	const std::filesystem::path parentDir = WorldDir(parentPath);
 
-	std::filesystem::path chunkPath =
-		worldDir / ("chunk_" +
-			std::to_string(cx) + "_" +
-			std::to_string(cz) + ".bin");
+	std::error_code ec;
+	if (!std::filesystem::is_directory(parentDir, ec))
+	{
+		return 0;
+	}
 
-	if (!std::filesystem::exists(chunkPath))
+	std::vector<std::filesystem::path> stale;
+	for (const auto& entry : std::filesystem::directory_iterator(parentDir, ec))
 	{
-		return false;
+		if (entry.is_directory() && entry.path().filename() != std::filesystem::path(keepName))
+		{
+			stale.push_back(entry.path());
+		}
+	} // end for
+
+	int removed = 0;
+	for (const std::filesystem::path& dir : stale)
+	{
+		std::filesystem::remove_all(dir, ec);
+		if (ec)
+		{
+			std::cerr << "Failed to remove world folder: " << dir.string() << "\n";
+			continue;
+		}
+		++removed;
+	} // end for
+
+	// regions of the removed folders go, unsaved ones elsewhere stay
+	std::lock_guard<std::mutex> writeLock(writeMutex_);
+	std::lock_guard<std::mutex> lock(mutex_);
+	cache_.erase(std::remove_if(cache_.begin(), cache_.end(), [&](const CachedRegion& cached)
+		{
+			return !cached.dirty ||
+				std::find(stale.begin(), stale.end(), cached.path.parent_path()) != stale.end();
+		}), cache_.end());
+
+	return removed;
+} // end of removeWorldsExcept()
+
+void Save::clearCache()
+{
+	// regions that are not on disk yet stay
+	std::lock_guard<std::mutex> writeLock(writeMutex_);
+	std::lock_guard<std::mutex> lock(mutex_);
+	cache_.erase(std::remove_if(cache_.begin(), cache_.end(), [](const CachedRegion& cached)
+		{
+			return !cached.dirty;
+		}), cache_.end());
+} // end of clearCache()
+
+
+//--- PRIVATE ---//
+void Save::saveThreadLoop()
+{
+	std::unique_lock<std::mutex> lock(queueMutex_);
+
+	while (true)
+	{
+		queueCv_.wait(lock, [this]()
+			{
+				return stop_ || !queued_.empty();
+			});
+
+		if (queued_.empty())
+		{
+			// stop requested and nothing left to write
+			break;
+		}
+
+		// take the whole queue, keep it visible to loads until written
+		writing_.swap(queued_);
+		lock.unlock();
+
+		std::map<std::string, std::vector<std::tuple<int, int, const BlockID*>>> byWorld;
+		for (const auto& [key, blocks] : writing_)
+		{
+			byWorld[std::get<0>(key)].emplace_back(std::get<1>(key), std::get<2>(key), blocks->data());
+		} // end for
+
+		for (const auto& [world, entries] : byWorld)
+		{
+			if (!writeChunks(entries, world))
+			{
+				std::cerr << "Chunks of " << world << " kept in memory, the next save writes them again\n";
+			}
+		} // end for
+
+		lock.lock();
+		writing_.clear();
+		idleCv_.notify_all();
+	} // end while
+} // end of saveThreadLoop()
+
+bool Save::findQueuedSnapshot(const std::string_view& worldPath, int cx, int cz, BlockArray& out) const
+{
+	std::lock_guard<std::mutex> lock(queueMutex_);
+
+	SnapshotKey key{ std::string(worldPath), cx, cz };
+
+	// newest copy first
+	auto it = queued_.find(key);
+	if (it == queued_.end())
+	{
+		it = writing_.find(key);
+		if (it == writing_.end())
+		{
+			return false;
+		}
 	}
 
-	std::ifstream in(chunkPath, std::ios::binary);
-	if (!in)
+	out = *it->second;
+	return true;
+} // end of findQueuedSnapshot()
+
+bool Save::writeChunks(
+	const std::vector<std::tuple<int, int, const BlockID*>>& chunks,
+	const std::string_view& worldPath)
+{
+	std::filesystem::path worldDir = WorldDir(worldPath);
+
+	// compress outside the lock, grouped by region
+	std::unordered_map<int64_t, std::vector<std::pair<int, std::vector<uint8_t>>>> byRegion;
+	std::unordered_map<int64_t, RegionCoord> regionCoords;
+
+	for (const auto& [cx, cz, blocks] : chunks)
 	{
-		std::cerr << "Failed to open chunk file (r) at path: " << chunkPath << "\n";
-		return false;
+		RegionCoord rc = RegionFile::regionOf(cx, cz);
+		int64_t key = RegionKey(rc);
+
+		std::vector<uint8_t> payload;
+		ChunkCodec::encode(blocks, CHUNK_VOLUME, payload);
+
+		byRegion[key].emplace_back(RegionFile::localIndex(cx, cz), std::move(payload));
+		regionCoords[key] = rc;
+	} // end for
+
+	// merge into the cached regions under mutex_ and mark them dirty, the
+	// files are written after it is released so loads only wait for the merge
+	std::lock_guard<std::mutex> writeLock(writeMutex_);
+	bool ok = true;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (!std::filesystem::exists(worldDir))
+		{
+			std::filesystem::create_directories(worldDir);
+
+			#ifdef _DEBUG
+			std::cout << "Created directory: " << worldDir << "\n";
+			#endif
+		}
+
+		for (auto& [key, entries] : byRegion)
+		{
+			const RegionCoord& rc = regionCoords[key];
+			std::shared_ptr<RegionFile> region = acquireRegionLocked(worldDir, rc);
+			if (!region)
+			{
+				std::cerr << "Refusing to overwrite unreadable region " << rc.x << ", " << rc.z << " in: " << worldDir << "\n";
+				ok = false;
+				continue;
+			}
+
+			for (auto& [index, payload] : entries)
+			{
+				region->setPayload(index, std::move(payload));
+			} // end for
+
+			setDirtyLocked(RegionFile::pathFor(worldDir, rc), true);
+		} // end for
 	}
 
-	ChunkFileHeader header{};
-	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	// also retries regions an earlier save failed to write
+	return writeDirtyRegions() && ok;
+} // end of writeChunks()
 
-	// load chunk from save
-	dst.loadData(in);
+bool Save::writeDirtyRegions()
+{
+	struct RegionWrite
+	{
+		std::filesystem::path path;
+		RegionCoord rc;
+		RegionFile snapshot;
+	};
+	std::vector<RegionWrite> writes;
 
-	dst.m_dirty = false;
-	return true;
-} // end of loadChunkFromFile()
\ No newline at end of file
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const CachedRegion& cached : cache_)
+		{
+			if (cached.dirty)
+			{
+				writes.push_back({ cached.path, cached.rc, *cached.file });
+			}
+		} // end for
+	}
+
+	// a region stays dirty, and so cached, until its file is written
+	bool ok = true;
+	for (const RegionWrite& write : writes)
+	{
+		bool written = WriteRegion(write.path, write.rc, write.snapshot);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		++regionWrites_;
+		setDirtyLocked(write.path, !written);
+		ok = written && ok;
+	} // end for
+
+	return ok;
+} // end of writeDirtyRegions()
+
+std::shared_ptr<RegionFile> Save::findCachedLocked(const std::filesystem::path& path)
+{
+	for (CachedRegion& cached : cache_)
+	{
+		if (cached.path == path)
+		{
+			cached.lastUse = ++useCounter_;
+			return cached.file;
+		}
+	} // end for
+	return nullptr;
+} // end of findCachedLocked()
+
+void Save::setDirtyLocked(const std::filesystem::path& path, bool dirty)
+{
+	for (CachedRegion& cached : cache_)
+	{
+		if (cached.path == path)
+		{
+			cached.dirty = dirty;
+			return;
+		}
+	} // end for
+} // end of setDirtyLocked()
+
+std::shared_ptr<RegionFile> Save::insertCachedLocked(
+	const std::filesystem::path& path,
+	const RegionCoord& rc,
+	std::shared_ptr<RegionFile> file)
+{
+	// evict the least recently used region that is already on disk, the
+	// cache grows past the limit while every region is dirty
+	if (cache_.size() >= MAX_CACHED_REGIONS)
+	{
+		auto oldest = cache_.end();
+		for (auto it = cache_.begin(); it != cache_.end(); ++it)
+		{
+			if (!it->dirty && (oldest == cache_.end() || it->lastUse < oldest->lastUse))
+			{
+				oldest = it;
+			}
+		} // end for
+		if (oldest != cache_.end())
+		{
+			cache_.erase(oldest);
+		}
+	}
+
+	cache_.push_back({ path, file, ++useCounter_, rc });
+	return file;
+} // end of insertCachedLocked()
+
+std::shared_ptr<RegionFile> Save::acquireRegionLocked(const std::filesystem::path& worldDir, const RegionCoord& rc)
+{
+	std::filesystem::path path = RegionFile::pathFor(worldDir, rc);
+
+	if (std::shared_ptr<RegionFile> cached = findCachedLocked(path))
+	{
+		return cached;
+	}
+
+	// missing regions are cached empty. an unreadable file is moved aside
+	// first, writing the region over it would drop every chunk it held
+	auto region = std::make_shared<RegionFile>();
+	if (region->read(path) == RegionFile::ReadResult::Unreadable)
+	{
+		std::filesystem::path corruptPath = path;
+		corruptPath += ".corrupt";
+
+		std::error_code ec;
+		std::filesystem::rename(path, corruptPath, ec);
+		if (ec)
+		{
+			std::cerr << "Failed to move unreadable region file aside: " << path << "\n";
+			return nullptr;
+		}
+		std::cerr << "Moved unreadable region file to: " << corruptPath << "\n";
+	}
+
+	return insertCachedLocked(path, rc, region);
+} // end of acquireRegionLocked()
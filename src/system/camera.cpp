@@ -13,6 +13,7 @@ Camera::Camera(int width, int height, glm::vec3 position, glm::vec3 up, float ya
 	lastX_ = width_ / 2.0f;
 	lastY_ = height_ / 2.0f;
 	position_ = position;
+	lastPosition_ = position;
 	worldUp_ = up;
 	yaw_ = yaw;
 	pitch_ = pitch;
@@ -26,6 +27,7 @@ Camera::Camera(int width, int height, float posX, float posY, float posZ, float
 	lastX_ = width_ / 2.0f;
 	lastY_ = height_ / 2.0f;
 	position_ = glm::vec3(posX, posY, posZ);
+	lastPosition_ = position_;
 	worldUp_ = glm::vec3(upX, upY, upZ);
 	yaw_ = yaw;
 	pitch_ = pitch;
@@ -139,6 +141,17 @@ void Camera::invertPitch()
 	isEnabled_ = wasEnabled;
 } // end of invertPitch()
 
+MirroredView Camera::mirrored(float planeY) const
+{
+	glm::vec3 eye = position_;
+	eye.y = 2.0f * planeY - eye.y;
+
+	Camera camera = *this;
+	camera.setCameraPosition(eye);
+	camera.invertPitch();
+	return { camera.getViewMatrix(), eye };
+} // end of mirrored()
+
 void Camera::onResize(int w, int h)
 {
 	width_ = w;
@@ -219,8 +232,23 @@ const glm::vec3& Camera::getCameraPosition() const
 void Camera::setCameraPosition(const glm::vec3& pos)
 {
 	position_ = pos;
+
+	// a teleport is not movement
+	lastPosition_ = pos;
+	velocity_ = glm::vec3(0.0f);
 } // end of setCameraPosition()
 
+void Camera::updateVelocity(float deltaTime)
+{
+	velocity_ = (deltaTime > 0.0f) ? (position_ - lastPosition_) / deltaTime : glm::vec3(0.0f);
+	lastPosition_ = position_;
+} // end of updateVelocity()
+
+const glm::vec3& Camera::getCameraVelocity() const
+{
+	return velocity_;
+} // end of getCameraVelocity()
+
 glm::vec3 Camera::getCameraDirection() const
 {
 	return front_;
@@ -555,6 +555,21 @@ void UI::drawMenuBar(IScene& scene)
 				{
 					world.enableDistanceCulling(distanceCulling);
 				}
+				bool occlusionCulling = world.statusOcclusionCulling();
+				if (ImGui::Checkbox("Occlusion Culling##render", &occlusionCulling))
+				{
+					world.enableOcclusionCulling(occlusionCulling);
+				}
+				bool caveCulling = world.statusCaveCulling();
+				if (ImGui::Checkbox("Cave Culling##render", &caveCulling))
+				{
+					world.enableCaveCulling(caveCulling);
+				}
+				bool incrementalCulling = world.statusIncrementalCulling();
+				if (ImGui::Checkbox("Incremental Culling##render", &incrementalCulling))
+				{
+					world.enableIncrementalCulling(incrementalCulling);
+				}
 				ImGui::EndMenu();
 			}
 			ImGui::EndMenu();
@@ -643,6 +658,11 @@ void UI::drawStatsFPS(IScene& scene, float dt)
 	ChunkManager& world = scene.getWorld();
 	ImGui::Text("Chunks Rendered: %d", world.getFrameChunksRendered());
 	ImGui::Text("Blocks Rendered: %d", world.getFrameBlocksRendered());
+	ImGui::Text("Triangles Rendered: %u", world.getFrameTrianglesRendered());
+	ImGui::Text("Chunks Occluded: %u", world.getFrameChunksOccluded());
+	ImGui::Text("Draw List Build: %.3f ms", world.getFrameDrawListMs());
+	ImGui::Text("Chunks Re-evaluated: %u", world.getFrameChunksReevaluated());
+	ImGui::Text("LOD Chunks Rendered: %u (%u triangles)", world.getFrameLodChunksRendered(), world.getFrameLodTrianglesRendered());
 	ImGui::End();
 } // end of drawStatsFPS()
 
@@ -768,11 +788,19 @@ void UI::drawInspector(IScene& scene)
 			renderRadius = World::MIN_RADIUS;
 			world.setViewRadius(renderRadius);
 		}
+		int lodRadius = world.getLodRadius();
+		changed |= ImGui::DragInt("LOD Radius##world", &lodRadius, 1);
+		if (ImGui::Button("Reset##lod_radius"))
+		{
+			lodRadius = World::DEFAULT_LOD_RADIUS;
+			world.setLodRadius(lodRadius);
+		}
 
 		if (changed)
 		{
 			world.setAmbientStrength(ambientStrength);
 			world.setViewRadius(renderRadius);
+			world.setLodRadius(lodRadius);
 		}
 
 		ImGui::Separator();